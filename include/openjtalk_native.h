@@ -9,7 +9,11 @@
  * Thread safety:
  *   - Each handle (void*) returned by openjtalk_native_create() is independent.
  *   - Different handles can be used concurrently from different threads.
+ *     Handles created with the same dictionary path share an internally
+ *     synchronized word cache.
  *   - A single handle must NOT be used from multiple threads simultaneously.
+ *   - An engine (openjtalk_native_engine_create()) owns its own handles and
+ *     may be called from multiple threads simultaneously.
  *   - openjtalk_native_get_version() and openjtalk_native_get_error_string()
  *     are safe to call from any thread.
  *
@@ -18,8 +22,26 @@
  *     via openjtalk_native_free_result().
  *   - openjtalk_native_phonemize_with_prosody() returns a result that the caller
  *     must free via openjtalk_native_free_prosody_result().
- *   - openjtalk_native_analyze() / openjtalk_native_analyze_utf8() return a
- *     string that the caller must free via openjtalk_native_free_string().
+ *   - openjtalk_native_phonemize_into() and
+ *     openjtalk_native_phonemize_with_prosody_into() write into a result the
+ *     caller owns; its buffers belong to the library and are released with
+ *     openjtalk_native_clear_result() / openjtalk_native_clear_prosody_result(),
+ *     or with the free function if the result came from the library.
+ *   - openjtalk_native_phonemize_with_reading() returns a result that the
+ *     caller must free via openjtalk_native_free_reading_result().
+ *   - openjtalk_native_extract_labels() returns a result that the caller must
+ *     free via openjtalk_native_free_label_result().
+ *   - openjtalk_native_analyze_text() returns an analysis that the caller
+ *     must free via openjtalk_native_free_analysis(); results rendered from
+ *     it are independent and freed with the usual functions.
+ *   - openjtalk_native_engine_phonemize_document() returns a result that the
+ *     caller must free via openjtalk_native_free_document_result().
+ *   - openjtalk_native_client_phonemize() and
+ *     openjtalk_native_client_phonemize_with_prosody() return results freed
+ *     with openjtalk_native_free_result() / openjtalk_native_free_prosody_result().
+ *   - openjtalk_native_get_reading(), openjtalk_native_analyze() and
+ *     openjtalk_native_analyze_utf8() return a string that the caller must
+ *     free via openjtalk_native_free_string().
  *   - openjtalk_native_get_option() returns a pointer to an internal buffer
  *     owned by the handle; it is overwritten on the next get_option call
  *     on the same handle. Do not free this pointer.
@@ -30,6 +52,8 @@
  *   - Input text must not exceed 4096 bytes (UTF-8). Longer inputs are
  *     rejected with OPENJTALK_NATIVE_ERROR_INVALID_INPUT.
  *   - Empty strings are rejected with OPENJTALK_NATIVE_ERROR_INVALID_INPUT.
+ *   - openjtalk_native_engine_phonemize_document() has no length limit; it
+ *     splits the document into sentences below the per-call limit.
  */
 
 #ifndef OPENJTALK_NATIVE_H
@@ -40,6 +64,7 @@ extern "C" {
 #endif
 
 #include <stddef.h>
+#include <stdint.h>
 
 /* Export/Import macros */
 #ifdef _WIN32
@@ -70,7 +95,8 @@ typedef enum {
     OPENJTALK_NATIVE_ERROR_PROCESSING = -7,
     OPENJTALK_NATIVE_ERROR_INVALID_OPTION = -8,
     OPENJTALK_NATIVE_ERROR_INVALID_DICTIONARY = -9,
-    OPENJTALK_NATIVE_ERROR_INVALID_UTF8 = -10
+    OPENJTALK_NATIVE_ERROR_INVALID_UTF8 = -10,
+    OPENJTALK_NATIVE_ERROR_CONNECTION = -11
 } OpenJTalkNativeError;
 
 /**
@@ -78,10 +104,13 @@ typedef enum {
  */
 typedef struct {
     char* phonemes;          /**< Space-separated phoneme string (e.g., "k o N n i ch i w a") */
-    int* phoneme_ids;        /**< Array of phoneme IDs corresponding to each phoneme */
+    int* phoneme_ids;        /**< Inventory ID of each phoneme (see openjtalk_native_get_phoneme_symbol()), -1 if unknown.
+                                  Earlier versions set every entry to 1. */
     int phoneme_count;       /**< Number of phonemes in the result */
-    float* durations;        /**< Duration of each phoneme in seconds */
-    float total_duration;    /**< Total duration of all phonemes in seconds */
+    float* durations;        /**< Estimated duration of each phoneme in seconds, divided by speech_rate */
+    float total_duration;    /**< Sum of durations in seconds */
+    int phoneme_capacity;    /**< Phonemes phoneme_ids and durations can hold (maintained by the library) */
+    int string_capacity;     /**< Bytes allocated for phonemes (maintained by the library) */
 } OpenJTalkNativePhonemeResult;
 
 /**
@@ -91,6 +120,24 @@ typedef struct {
  * - A1: Relative position from accent nucleus (can be negative)
  * - A2: Position in accent phrase (1-based)
  * - A3: Total morae in accent phrase
+ *
+ * Prosody symbols (computed from the same labels, VITS-style):
+ * - "^" / "$": start / end of the utterance ("?" ends a question)
+ * - "_": pause inside the utterance
+ * - "#": accent phrase boundary
+ * - "[": pitch rise
+ * - "]": pitch fall (after the accent nucleus)
+ * Devoiced vowels keep their uppercase symbol, as in the phoneme string.
+ *
+ * With the "alignment" option on, openjtalk_native_phonemize_with_prosody()
+ * also fills source_start/source_end and accent_phrase_start/accent_phrase_end:
+ * byte offsets into the text passed in, end exclusive. A phoneme maps to the
+ * characters of the word it was read from (a reading of several characters
+ * gives every phoneme the whole word); pauses and the edge silences map to
+ * the gap between the words around them. Numbers and units rewritten by
+ * "normalize_numbers" and words spelled by "latin_mode" map to the
+ * characters they replaced. Results of
+ * openjtalk_native_render_prosody() and engine documents leave them NULL.
  */
 typedef struct {
     char* phonemes;          /**< Space-separated phoneme string */
@@ -98,8 +145,241 @@ typedef struct {
     int* prosody_a2;         /**< A2: position in accent phrase, 1-based (per phoneme) */
     int* prosody_a3;         /**< A3: total morae in accent phrase (per phoneme) */
     int phoneme_count;       /**< Number of phonemes in the result */
+    char* prosody_symbols;   /**< Phonemes with prosody marks (e.g., "^ k o [ N n i ch i w a $") */
+    int prosody_symbol_count;/**< Number of space-separated tokens in prosody_symbols */
+    int* prosody_marks;      /**< Mark following each phoneme: '#', '[', ']' or 0 (per phoneme) */
+    int* accent_phrase_index;/**< 0-based accent phrase in the utterance, -1 for pau (per phoneme) */
+    int* mora_index;         /**< 0-based mora in the utterance, -1 for pau (per phoneme) */
+    int accent_phrase_count; /**< Number of accent phrases */
+    int* source_start;       /**< Input byte offset where the phoneme's text starts (per phoneme), or NULL */
+    int* source_end;         /**< Input byte offset after the phoneme's text (per phoneme), or NULL */
+    int* accent_phrase_start;/**< Input byte offset where each accent phrase starts, or NULL */
+    int* accent_phrase_end;  /**< Input byte offset after each accent phrase, or NULL */
+    int phoneme_capacity;    /**< Phonemes the per-phoneme arrays can hold (maintained by the library) */
+    int string_capacity;     /**< Bytes allocated for phonemes (maintained by the library) */
+    int symbol_capacity;     /**< Bytes allocated for prosody_symbols (maintained by the library) */
+    int accent_phrase_capacity; /**< Accent phrases the offset arrays can hold (maintained by the library) */
 } OpenJTalkNativeProsodyResult;
 
+/** Value stored in label columns for "xx" (undefined) fields */
+#define OPENJTALK_NATIVE_LABEL_UNDEFINED (-32768)
+
+/**
+ * @brief Columns of a full-context label, in label order
+ *
+ * Label layout (HTS / OpenJTalk full-context format):
+ *   p1^p2-p3+p4=p5/A:a1+a2+a3/B:b1-b2_b3/C:c1_c2+c3/D:d1+d2_d3
+ *   /E:e1_e2!e3_e4-e5/F:f1_f2#f3_f4@f5_f6|f7_f8/G:g1_g2%g3_g4_g5
+ *   /H:h1_h2/I:i1-i2@i3+i4&i5-i6|i7+i8/J:j1_j2/K:k1+k2-k3
+ *
+ * P1..P5 hold phoneme IDs (see openjtalk_native_get_phoneme_symbol()),
+ * all other columns hold the numeric field value.
+ */
+typedef enum {
+    OPENJTALK_NATIVE_LABEL_P1 = 0, OPENJTALK_NATIVE_LABEL_P2, OPENJTALK_NATIVE_LABEL_P3,
+    OPENJTALK_NATIVE_LABEL_P4, OPENJTALK_NATIVE_LABEL_P5,
+    OPENJTALK_NATIVE_LABEL_A1, OPENJTALK_NATIVE_LABEL_A2, OPENJTALK_NATIVE_LABEL_A3,
+    OPENJTALK_NATIVE_LABEL_B1, OPENJTALK_NATIVE_LABEL_B2, OPENJTALK_NATIVE_LABEL_B3,
+    OPENJTALK_NATIVE_LABEL_C1, OPENJTALK_NATIVE_LABEL_C2, OPENJTALK_NATIVE_LABEL_C3,
+    OPENJTALK_NATIVE_LABEL_D1, OPENJTALK_NATIVE_LABEL_D2, OPENJTALK_NATIVE_LABEL_D3,
+    OPENJTALK_NATIVE_LABEL_E1, OPENJTALK_NATIVE_LABEL_E2, OPENJTALK_NATIVE_LABEL_E3,
+    OPENJTALK_NATIVE_LABEL_E4, OPENJTALK_NATIVE_LABEL_E5,
+    OPENJTALK_NATIVE_LABEL_F1, OPENJTALK_NATIVE_LABEL_F2, OPENJTALK_NATIVE_LABEL_F3,
+    OPENJTALK_NATIVE_LABEL_F4, OPENJTALK_NATIVE_LABEL_F5, OPENJTALK_NATIVE_LABEL_F6,
+    OPENJTALK_NATIVE_LABEL_F7, OPENJTALK_NATIVE_LABEL_F8,
+    OPENJTALK_NATIVE_LABEL_G1, OPENJTALK_NATIVE_LABEL_G2, OPENJTALK_NATIVE_LABEL_G3,
+    OPENJTALK_NATIVE_LABEL_G4, OPENJTALK_NATIVE_LABEL_G5,
+    OPENJTALK_NATIVE_LABEL_H1, OPENJTALK_NATIVE_LABEL_H2,
+    OPENJTALK_NATIVE_LABEL_I1, OPENJTALK_NATIVE_LABEL_I2, OPENJTALK_NATIVE_LABEL_I3,
+    OPENJTALK_NATIVE_LABEL_I4, OPENJTALK_NATIVE_LABEL_I5, OPENJTALK_NATIVE_LABEL_I6,
+    OPENJTALK_NATIVE_LABEL_I7, OPENJTALK_NATIVE_LABEL_I8,
+    OPENJTALK_NATIVE_LABEL_J1, OPENJTALK_NATIVE_LABEL_J2,
+    OPENJTALK_NATIVE_LABEL_K1, OPENJTALK_NATIVE_LABEL_K2, OPENJTALK_NATIVE_LABEL_K3,
+    OPENJTALK_NATIVE_LABEL_FIELD_COUNT
+} OpenJTalkNativeLabelField;
+
+/**
+ * @brief Phonemes together with the per-word readings they were built from
+ *
+ * Words are the NJD nodes left after the NJD stages, so numbers read out
+ * by njd_set_digit count as the words they became. Readings are katakana
+ * pronunciations without devoicing marks; symbols keep their surface form
+ * ("、", "?"). Romaji is modified Hepburn in ASCII: "ー" repeats the vowel
+ * ("トーキョー" -> "tookyoo"), "ッ" doubles the next consonant and "ン" is
+ * "n" ("n'" before a vowel or y); Japanese punctuation becomes its ASCII
+ * counterpart. The result and all its strings live in one allocation.
+ */
+typedef struct {
+    char* phonemes;          /**< Space-separated phoneme string, as openjtalk_native_phonemize() */
+    int phoneme_count;       /**< Number of phonemes */
+    char* reading;           /**< Katakana reading of the text (the word readings concatenated) */
+    char* romaji;            /**< Romaji of the text (the word romaji separated by spaces) */
+    int word_count;          /**< Number of words */
+    char** word_surfaces;    /**< Surface of each word as MeCab saw it (ASCII is full-width) */
+    char** word_readings;    /**< Katakana reading of each word */
+    char** word_romaji;      /**< Romaji of each word */
+} OpenJTalkNativeReadingResult;
+
+/**
+ * @brief Full-context label fields as a struct-of-arrays
+ *
+ * One row per phoneme, in the same order as openjtalk_native_phonemize().
+ * The column for field f starts at values + f * row_count. P3 holds the
+ * label's own phoneme, so the utterance-edge rows carry "sil" where the
+ * phoneme string shows "pau". The result and its values live in a single
+ * allocation.
+ */
+typedef struct {
+    int16_t* values;         /**< field_count * row_count values, column-major */
+    int row_count;           /**< Number of phonemes (rows) */
+    int field_count;         /**< Number of columns (OPENJTALK_NATIVE_LABEL_FIELD_COUNT) */
+} OpenJTalkNativeLabelResult;
+
+/**
+ * @brief Memory usage snapshot returned by openjtalk_native_get_memory_stats()
+ *
+ * All values are in bytes. Context figures count the heap the library can
+ * see (MeCab features, NJD nodes, labels); MeCab's internal lattice is not
+ * included, so they are lower bounds. The lattice grows with its largest
+ * input and is tracked by input size instead (MeCab input is the text after
+ * half-width to full-width conversion).
+ */
+typedef struct {
+    uint64_t dictionary_shared_bytes;  /**< Dictionary files mapped read-only (sys.dic, matrix.bin, char.bin, unk.dic) */
+    uint64_t dictionary_private_bytes; /**< Heap owned by the dictionary (shared word cache) */
+    uint64_t context_bytes;            /**< Heap held by the handle, including the last call's working set and, with "alignment" on, its offset buffers */
+    uint64_t peak_call_bytes;          /**< Largest working set plus result of a single call on the handle */
+    uint64_t result_bytes_outstanding; /**< Process-wide bytes of results and strings not yet freed */
+    uint64_t lattice_retained_input_bytes; /**< Largest MeCab input since the handle's lattice was last released;
+                                                the lattice keeps storage sized for it */
+    uint64_t lattice_peak_input_bytes; /**< Largest MeCab input over the handle's lifetime */
+    uint64_t lattice_trim_count;       /**< Times the lattice was released after an outlier (a count, not bytes) */
+} OpenJTalkNativeMemoryStats;
+
+/**
+ * @brief NJD processing stages, selected with the "njd_stages" option
+ *
+ * Stages always run in this order. Skipping one changes the output as follows:
+ * - PRONUNCIATION:  kana, symbols and unknown words get no reading and are
+ *                   dropped from the output.
+ * - DIGIT:          numbers are read digit by digit ("123" -> i ch i n i s a N)
+ *                   and counters keep their dictionary reading (no rendaku).
+ * - ACCENT_PHRASE:  every word forms its own accent phrase, so A1-A3, prosody
+ *                   marks and accent_phrase_index follow word boundaries.
+ * - ACCENT_TYPE:    accent nuclei are not recomputed for combined phrases;
+ *                   each word keeps its dictionary accent type.
+ * - UNVOICED_VOWEL: no vowel devoicing; no uppercase A I U E O phonemes.
+ * - LONG_VOWEL:     vowel sequences the reading spells out are not merged into
+ *                   long vowels (ー).
+ */
+typedef enum {
+    OPENJTALK_NATIVE_STAGE_PRONUNCIATION  = 1 << 0,
+    OPENJTALK_NATIVE_STAGE_DIGIT          = 1 << 1,
+    OPENJTALK_NATIVE_STAGE_ACCENT_PHRASE  = 1 << 2,
+    OPENJTALK_NATIVE_STAGE_ACCENT_TYPE    = 1 << 3,
+    OPENJTALK_NATIVE_STAGE_UNVOICED_VOWEL = 1 << 4,
+    OPENJTALK_NATIVE_STAGE_LONG_VOWEL     = 1 << 5
+} OpenJTalkNativeStage;
+
+/** All stages ("njd_stages" = "full", the default) */
+#define OPENJTALK_NATIVE_STAGES_FULL 0x3F
+/** Plain phonemes without accent or devoicing ("njd_stages" = "phonemes") */
+#define OPENJTALK_NATIVE_STAGES_PHONEMES \
+    (OPENJTALK_NATIVE_STAGE_PRONUNCIATION | OPENJTALK_NATIVE_STAGE_DIGIT | OPENJTALK_NATIVE_STAGE_LONG_VOWEL)
+/** Dictionary readings with numbers expanded ("njd_stages" = "reading") */
+#define OPENJTALK_NATIVE_STAGES_READING \
+    (OPENJTALK_NATIVE_STAGE_PRONUNCIATION | OPENJTALK_NATIVE_STAGE_DIGIT)
+
+/**
+ * @brief Engine priority lanes for openjtalk_native_engine_phonemize_document_with_priority()
+ */
+typedef enum {
+    OPENJTALK_NATIVE_PRIORITY_INTERACTIVE = 0, /**< Latency-sensitive requests */
+    OPENJTALK_NATIVE_PRIORITY_BULK = 1         /**< Background work: cache filling, corpora */
+} OpenJTalkNativePriority;
+
+/**
+ * @brief Flags for openjtalk_native_engine_create_with_flags()
+ */
+typedef enum {
+    OPENJTALK_NATIVE_ENGINE_PIN_WORKERS = 1   /**< Pin each worker thread to its own CPU (Linux, Android, Windows) */
+} OpenJTalkNativeEngineFlags;
+
+/**
+ * @brief Warm-up levels for openjtalk_native_warmup(); each includes the previous one
+ */
+typedef enum {
+    OPENJTALK_NATIVE_WARMUP_NONE = 0,       /**< Only the caller-supplied texts */
+    OPENJTALK_NATIVE_WARMUP_DICTIONARY = 1, /**< Read the dictionary files into the OS page cache */
+    OPENJTALK_NATIVE_WARMUP_PIPELINE = 2    /**< Also run a built-in sentence set through every stage */
+} OpenJTalkNativeWarmupLevel;
+
+/** Version written by openjtalk_native_serialize_result() / openjtalk_native_serialize_prosody_result() */
+#define OPENJTALK_NATIVE_SERIALIZED_VERSION 1
+
+/**
+ * @brief Section IDs in a serialized result
+ *
+ * Serialized layout (all integers little-endian):
+ *   offset 0   u32 magic "OJTR"
+ *          4   u16 version (OPENJTALK_NATIVE_SERIALIZED_VERSION)
+ *          6   u16 section_count
+ *          8   u32 total_size in bytes
+ *          12  u32 phoneme_count
+ *          16  f32 total_duration (0 for prosody results)
+ *          20  u32 reserved
+ *          24  section_count entries of { u16 id, u8 element_type, u8 reserved,
+ *                                         u32 offset, u32 count }
+ * Section data follows, each starting at an 8-byte aligned offset from the
+ * start of the buffer, so it can be viewed in place as a typed array
+ * (numpy.frombuffer(buf, dtype, count, offset), new Int16Array(buf, offset,
+ * count), MemoryMarshal.Cast over a Span). Readers must skip unknown IDs.
+ */
+typedef enum {
+    OPENJTALK_NATIVE_SECTION_PHONEME_IDS = 1,         /**< u8, see openjtalk_native_get_phoneme_symbol(); 255 = unknown */
+    OPENJTALK_NATIVE_SECTION_DURATIONS = 2,           /**< f32 seconds */
+    OPENJTALK_NATIVE_SECTION_A1 = 3,                  /**< i16 */
+    OPENJTALK_NATIVE_SECTION_A2 = 4,                  /**< i16 */
+    OPENJTALK_NATIVE_SECTION_A3 = 5,                  /**< i16 */
+    OPENJTALK_NATIVE_SECTION_PROSODY_MARKS = 6,       /**< u8: '#', '[', ']' or 0 */
+    OPENJTALK_NATIVE_SECTION_ACCENT_PHRASE_INDEX = 7, /**< i32, -1 for pau */
+    OPENJTALK_NATIVE_SECTION_MORA_INDEX = 8,          /**< i32, -1 for pau */
+    OPENJTALK_NATIVE_SECTION_PROSODY_SYMBOLS = 9,     /**< u8 UTF-8 bytes of prosody_symbols, not NUL-terminated */
+    OPENJTALK_NATIVE_SECTION_SOURCE_START = 10,       /**< i32 input byte offset per phoneme (with "alignment") */
+    OPENJTALK_NATIVE_SECTION_SOURCE_END = 11,         /**< i32 input byte offset per phoneme, exclusive */
+    OPENJTALK_NATIVE_SECTION_ACCENT_PHRASE_START = 12,/**< i32 input byte offset per accent phrase (with "alignment") */
+    OPENJTALK_NATIVE_SECTION_ACCENT_PHRASE_END = 13   /**< i32 input byte offset per accent phrase, exclusive */
+} OpenJTalkNativeSectionId;
+
+/** Element types of serialized sections */
+typedef enum {
+    OPENJTALK_NATIVE_ELEMENT_U8 = 1,
+    OPENJTALK_NATIVE_ELEMENT_I16 = 2,
+    OPENJTALK_NATIVE_ELEMENT_I32 = 3,
+    OPENJTALK_NATIVE_ELEMENT_F32 = 4
+} OpenJTalkNativeElementType;
+
+/**
+ * @brief Phonemized document returned by openjtalk_native_engine_phonemize_document()
+ *
+ * The document is split into sentences that are phonemized in parallel and
+ * stitched back in input order. Each sentence keeps its own "^" ... "$"
+ * (or "?") in prosody_symbols, accent_phrase_index and mora_index continue
+ * across sentences, and sentence_* arrays map every sentence back to the
+ * input text and to its run of phonemes.
+ */
+typedef struct {
+    OpenJTalkNativeProsodyResult* prosody; /**< Stitched result for the whole document */
+    int sentence_count;                    /**< Number of sentences */
+    int* sentence_offsets;                 /**< Byte offset of each sentence in the input text */
+    int* sentence_lengths;                 /**< Byte length of each sentence (trimmed) */
+    int* sentence_phoneme_offsets;         /**< Index of each sentence's first phoneme in prosody */
+    int* sentence_phoneme_counts;          /**< Number of phonemes per sentence */
+    int* sentence_errors;                  /**< Per-sentence error code; failed sentences have no phonemes */
+    double queue_wait_seconds;             /**< Longest time any sentence waited for a worker */
+    double processing_seconds;             /**< Worker time summed over sentences */
+} OpenJTalkNativeDocumentResult;
+
 /**
  * @brief Get the version string of the library
  * @return Version string (e.g., "1.0.0")
@@ -122,6 +402,27 @@ OPENJTALK_NATIVE_API void* openjtalk_native_create(const char* dict_path);
  */
 OPENJTALK_NATIVE_API void openjtalk_native_destroy(void* handle);
 
+/**
+ * @brief Pay the cold-start cost before the first real request
+ * @param handle Handle returned by openjtalk_native_create()
+ * @param level OpenJTalkNativeWarmupLevel
+ * @param texts Texts to run after the built-in set, e.g. frequent requests,
+ *              to populate the word cache; may be NULL when text_count is 0
+ * @param text_count Number of texts
+ * @return OPENJTALK_NATIVE_SUCCESS, or an error code. A failing caller text
+ *         does not stop the rest of the list; the last failure is returned.
+ *
+ * The first calls after openjtalk_native_create() are several times slower
+ * than steady state: dictionary pages fault in from disk, the word cache is
+ * empty and the allocator has not grown its arenas. DICTIONARY reads
+ * sys.dic, matrix.bin, char.bin and unk.dic once per dictionary path so
+ * MeCab's mappings fault from memory; PIPELINE then phonemizes a fixed set
+ * of representative sentences. Intended for readiness probes; only the first
+ * call per dictionary pays for the file reads. Results are discarded and
+ * not counted in result_bytes_outstanding.
+ */
+OPENJTALK_NATIVE_API int openjtalk_native_warmup(void* handle, int level, const char* const* texts, int text_count);
+
 /**
  * @brief Convert Japanese text to phonemes
  * @param handle Handle returned by openjtalk_native_create()
@@ -150,6 +451,244 @@ OPENJTALK_NATIVE_API OpenJTalkNativeProsodyResult* openjtalk_native_phonemize_wi
  */
 OPENJTALK_NATIVE_API void openjtalk_native_free_prosody_result(OpenJTalkNativeProsodyResult* result);
 
+/**
+ * @brief Convert Japanese text to phonemes into a reusable result
+ * @param handle Handle returned by openjtalk_native_create()
+ * @param text UTF-8 encoded Japanese text
+ * @param result Result to overwrite: zero-initialized, filled by an earlier
+ *        call, or returned by openjtalk_native_phonemize()
+ * @return OPENJTALK_NATIVE_SUCCESS, or an error code
+ *
+ * Buffers grow only when the text needs more than their capacity, so a
+ * result reused across calls stops allocating once it has seen its largest
+ * input. On failure phoneme_count is 0 and the buffers are kept. Release the
+ * buffers of a caller-owned struct with openjtalk_native_clear_result().
+ *
+ * @code
+ * OpenJTalkNativePhonemeResult result = {0};
+ * while (next_text(&text)) {
+ *     if (openjtalk_native_phonemize_into(handle, text, &result) == OPENJTALK_NATIVE_SUCCESS) use(&result);
+ * }
+ * openjtalk_native_clear_result(&result);
+ * @endcode
+ */
+OPENJTALK_NATIVE_API int openjtalk_native_phonemize_into(void* handle, const char* text, OpenJTalkNativePhonemeResult* result);
+
+/**
+ * @brief Convert Japanese text to phonemes with prosody features into a reusable result
+ * @param handle Handle returned by openjtalk_native_create()
+ * @param text UTF-8 encoded Japanese text
+ * @param result Result to overwrite: zero-initialized, filled by an earlier
+ *        call, or returned by openjtalk_native_phonemize_with_prosody()
+ * @return OPENJTALK_NATIVE_SUCCESS, or an error code
+ *
+ * As openjtalk_native_phonemize_into(). The offset arrays follow the
+ * "alignment" option of each call and are NULL while it is off.
+ */
+OPENJTALK_NATIVE_API int openjtalk_native_phonemize_with_prosody_into(void* handle, const char* text,
+                                                                     OpenJTalkNativeProsodyResult* result);
+
+/**
+ * @brief Release the buffers of a phoneme result and reset it to zero
+ * @param result Result filled by openjtalk_native_phonemize_into()
+ *
+ * The struct itself is not freed. A result returned by
+ * openjtalk_native_phonemize() can still be passed to
+ * openjtalk_native_free_result() afterwards.
+ */
+OPENJTALK_NATIVE_API void openjtalk_native_clear_result(OpenJTalkNativePhonemeResult* result);
+
+/**
+ * @brief Release the buffers of a prosody result and reset it to zero
+ * @param result Result filled by openjtalk_native_phonemize_with_prosody_into()
+ */
+OPENJTALK_NATIVE_API void openjtalk_native_clear_prosody_result(OpenJTalkNativeProsodyResult* result);
+
+/**
+ * @brief Convert Japanese text to numeric full-context label columns
+ * @param handle Handle returned by openjtalk_native_create()
+ * @param text UTF-8 encoded Japanese text
+ * @return Label result, or NULL on failure. Must be freed with openjtalk_native_free_label_result()
+ */
+OPENJTALK_NATIVE_API OpenJTalkNativeLabelResult* openjtalk_native_extract_labels(void* handle, const char* text);
+
+/**
+ * @brief Free a label result
+ * @param result Result returned by openjtalk_native_extract_labels()
+ */
+OPENJTALK_NATIVE_API void openjtalk_native_free_label_result(OpenJTalkNativeLabelResult* result);
+
+/**
+ * @brief Get the name of a label column (e.g., "A1", "F5")
+ * @param field Column index (OpenJTalkNativeLabelField)
+ * @return Static string, or NULL if the index is out of range
+ */
+OPENJTALK_NATIVE_API const char* openjtalk_native_get_label_field_name(int field);
+
+/**
+ * @brief Get the phoneme symbol for a phoneme ID used in label columns P1..P5
+ * @param phoneme_id Phoneme ID
+ * @return Static string (e.g., "k", "pau"), or NULL if the ID is unknown
+ */
+OPENJTALK_NATIVE_API const char* openjtalk_native_get_phoneme_symbol(int phoneme_id);
+
+/**
+ * @brief Convert Japanese text to its katakana reading
+ * @param handle Handle returned by openjtalk_native_create()
+ * @param text UTF-8 encoded Japanese text
+ * @return Reading (e.g., "コンニチワ"), or NULL on failure. Must be freed with
+ *         openjtalk_native_free_string()
+ *
+ * Runs only the reading stages of "njd_stages" (PRONUNCIATION, DIGIT,
+ * LONG_VOWEL) and skips full-context label generation, which makes it
+ * cheaper than openjtalk_native_phonemize(). Symbols keep their surface
+ * form ("、", "?").
+ */
+OPENJTALK_NATIVE_API char* openjtalk_native_get_reading(void* handle, const char* text);
+
+/**
+ * @brief Convert Japanese text to phonemes plus per-word readings and romaji
+ * @param handle Handle returned by openjtalk_native_create()
+ * @param text UTF-8 encoded Japanese text
+ * @return Reading result, or NULL on failure. Must be freed with
+ *         openjtalk_native_free_reading_result()
+ *
+ * One analysis serves display, search indexing and synthesis: the readings
+ * come from the same NJD nodes the phonemes were generated from, after
+ * every stage in "njd_stages".
+ */
+OPENJTALK_NATIVE_API OpenJTalkNativeReadingResult* openjtalk_native_phonemize_with_reading(void* handle, const char* text);
+
+/**
+ * @brief Free a reading result
+ * @param result Result returned by openjtalk_native_phonemize_with_reading()
+ */
+OPENJTALK_NATIVE_API void openjtalk_native_free_reading_result(OpenJTalkNativeReadingResult* result);
+
+/**
+ * @brief Analyze text once for repeated rendering
+ * @param handle Handle returned by openjtalk_native_create()
+ * @param text UTF-8 encoded Japanese text
+ * @return Opaque analysis, or NULL on failure. Must be freed with
+ *         openjtalk_native_free_analysis()
+ *
+ * Runs number normalization and MeCab and keeps the resulting NJD nodes
+ * before any NJD stage. Each render uses the rendering handle's current
+ * options: labels are rebuilt only when "njd_stages" differs from the
+ * previous render, re-running the NJD stages from the first one whose
+ * selection changed (the nodes before it are kept after the first
+ * switch), and "speech_rate" only affects the durations computed from the
+ * kept labels. "normalize_numbers",
+ * "latin_mode" and "word_cache" apply at analysis time.
+ *
+ * An analysis does not reference the handle and can be rendered by any
+ * handle, but must not be rendered from several threads at once.
+ */
+OPENJTALK_NATIVE_API void* openjtalk_native_analyze_text(void* handle, const char* text);
+
+/**
+ * @brief Render an analysis to phonemes
+ * @param handle Handle whose options apply
+ * @param analysis Analysis returned by openjtalk_native_analyze_text()
+ * @return Phoneme result, or NULL on failure. Must be freed with openjtalk_native_free_result()
+ */
+OPENJTALK_NATIVE_API OpenJTalkNativePhonemeResult* openjtalk_native_render_phonemes(void* handle, void* analysis);
+
+/**
+ * @brief Render an analysis to phonemes with prosody features
+ * @param handle Handle whose options apply
+ * @param analysis Analysis returned by openjtalk_native_analyze_text()
+ * @return Prosody result, or NULL on failure. Must be freed with openjtalk_native_free_prosody_result()
+ */
+OPENJTALK_NATIVE_API OpenJTalkNativeProsodyResult* openjtalk_native_render_prosody(void* handle, void* analysis);
+
+/**
+ * @brief Render an analysis to numeric full-context label columns
+ * @param handle Handle whose options apply
+ * @param analysis Analysis returned by openjtalk_native_analyze_text()
+ * @return Label result, or NULL on failure. Must be freed with openjtalk_native_free_label_result()
+ */
+OPENJTALK_NATIVE_API OpenJTalkNativeLabelResult* openjtalk_native_render_labels(void* handle, void* analysis);
+
+/**
+ * @brief Free an analysis
+ * @param analysis Analysis returned by openjtalk_native_analyze_text()
+ */
+OPENJTALK_NATIVE_API void openjtalk_native_free_analysis(void* analysis);
+
+/**
+ * @brief Serialize a phoneme result into one flat buffer
+ * @param result Result returned by openjtalk_native_phonemize()
+ * @param buffer Destination, or NULL to query the size
+ * @param capacity Size of buffer in bytes
+ * @return Bytes required. Nothing is written unless capacity is at least
+ *         that large. Returns 0 if result is NULL.
+ *
+ * Sections: PHONEME_IDS, DURATIONS. See OpenJTalkNativeSectionId for the layout.
+ */
+OPENJTALK_NATIVE_API size_t openjtalk_native_serialize_result(const OpenJTalkNativePhonemeResult* result, void* buffer, size_t capacity);
+
+/**
+ * @brief Serialize a prosody result into one flat buffer
+ * @param result Result returned by openjtalk_native_phonemize_with_prosody()
+ * @param buffer Destination, or NULL to query the size
+ * @param capacity Size of buffer in bytes
+ * @return Bytes required; see openjtalk_native_serialize_result()
+ *
+ * Sections: PHONEME_IDS, A1, A2, A3, PROSODY_MARKS, ACCENT_PHRASE_INDEX,
+ * MORA_INDEX, PROSODY_SYMBOLS. A1-A3 are clamped to the int16 range.
+ * Results carrying input offsets ("alignment" on) also get SOURCE_START,
+ * SOURCE_END (phoneme_count entries) and ACCENT_PHRASE_START,
+ * ACCENT_PHRASE_END (accent_phrase_count entries).
+ */
+OPENJTALK_NATIVE_API size_t openjtalk_native_serialize_prosody_result(const OpenJTalkNativeProsodyResult* result, void* buffer, size_t capacity);
+
+/**
+ * @brief Locate a section in a serialized result
+ * @param buffer Serialized result
+ * @param size Size of buffer in bytes
+ * @param section_id Section to find (OpenJTalkNativeSectionId)
+ * @param element_type Receives the element type (OpenJTalkNativeElementType); may be NULL
+ * @param count Receives the element count; may be NULL
+ * @return Pointer to the first element inside buffer, or NULL if the buffer
+ *         is malformed, has another version, or lacks the section
+ */
+OPENJTALK_NATIVE_API const void* openjtalk_native_find_section(const void* buffer, size_t size, int section_id,
+                                                               int* element_type, int* count);
+
+/**
+ * @brief Report memory usage for a handle, or process-wide totals
+ * @param handle Handle returned by openjtalk_native_create(), or NULL for
+ *               totals over every loaded dictionary (context fields are 0)
+ * @param stats Receives the snapshot
+ * @return OPENJTALK_NATIVE_SUCCESS, or OPENJTALK_NATIVE_ERROR_INVALID_INPUT if stats is NULL
+ *
+ * @note Dictionary figures are shared by all handles created with the same
+ *       dictionary path; do not sum them across those handles.
+ */
+OPENJTALK_NATIVE_API int openjtalk_native_get_memory_stats(void* handle, OpenJTalkNativeMemoryStats* stats);
+
+/**
+ * @brief Render a handle's call metrics as Prometheus exposition text
+ * @param handle Handle returned by openjtalk_native_create()
+ * @param buffer Destination, or NULL to query the size
+ * @param capacity Size of buffer in bytes
+ * @return Bytes required including the terminating NUL. Nothing is written
+ *         unless capacity is at least that large. Returns 0 if handle is NULL.
+ *
+ * Covers openjtalk_native_phonemize(), _phonemize_with_prosody(),
+ * _extract_labels() and _get_reading() as timed inside the library:
+ *   - openjtalk_native_call_duration_seconds  histogram, 50us .. 1s
+ *   - openjtalk_native_input_bytes            histogram, 16 .. 4096
+ *   - openjtalk_native_phonemes               histogram, 16 .. 4096 (not get_reading)
+ *   - openjtalk_native_errors_total{code}     counter per OpenJTalkNativeError
+ *   - openjtalk_native_word_cache_*           hits, misses, entries, bytes
+ * Recording is lock-free and costs two clock reads per call. Word cache
+ * figures belong to the dictionary and are shared by every handle on it.
+ * May be called from any thread while the handle is in use.
+ */
+OPENJTALK_NATIVE_API size_t openjtalk_native_render_metrics(void* handle, char* buffer, size_t capacity);
+
 /**
  * @brief Get the last error code for an instance
  * @param handle Handle returned by openjtalk_native_create()
@@ -172,9 +711,48 @@ OPENJTALK_NATIVE_API const char* openjtalk_native_get_error_string(int error_cod
  * @return OPENJTALK_NATIVE_SUCCESS on success, error code on failure
  *
  * Available keys:
- *   - "speech_rate": Speech rate multiplier (range: 0.0 < rate <= 10.0, default: 1.0)
+ *   - "speech_rate": Speech rate multiplier (range: 0.0 < rate <= 10.0, default: 1.0).
+ *                    Estimated phoneme durations are divided by this value.
  *   - "pitch":       Pitch shift in semitones (range: -20.0 <= pitch <= 20.0, default: 0.0)
  *   - "volume":      Volume multiplier (range: 0.0 <= volume <= 2.0, default: 1.0)
+ *   - "word_cache":  "1" to reuse parsed morphemes from the per-dictionary word
+ *                    cache, "0" to parse every MeCab feature line (default: "0").
+ *                    The cache is shared by all handles created with the same
+ *                    dictionary path and does not change the output. It is off
+ *                    by default because a hit still copies the cached nodes
+ *                    under the dictionary-wide lock, and the news benchmark
+ *                    shows no gain over parsing.
+ *   - "normalize_numbers": "1" to rewrite dates (2024/01/05), times (12:30),
+ *                    comma-grouped numbers, currency symbols ($, ¥, €, £),
+ *                    units after numbers (km, %, GHz, ...) and hyphenated phone
+ *                    numbers into Japanese text before MeCab, "0" to pass the
+ *                    text through unchanged (default: "0", so text with digits
+ *                    reads as it did before the option existed). Text without
+ *                    digits is not copied.
+ *   - "latin_mode":  How Latin letters, URLs and emoji reach MeCab (default: "keep").
+ *                    "keep" passes them through as before. "spell" reads each
+ *                    Latin run from a small loanword table or letter by letter
+ *                    in katakana, splitting camelCase identifiers (API ->
+ *                    エーピーアイ, getUserName -> ゲットユーザーネーム), reads URLs
+ *                    as "URL" and drops emoji. "skip" drops all three. Half-
+ *                    and full-width letters are handled alike. Text with nothing
+ *                    left after skipping fails with OPENJTALK_NATIVE_ERROR_INVALID_INPUT,
+ *                    as an empty string does. So does text whose spelled-out
+ *                    form exceeds the 4096-byte input limit; numbers whose
+ *                    readings would not fit are left as written instead.
+ *   - "alignment":   "1" to report input byte offsets per phoneme and accent
+ *                    phrase in openjtalk_native_phonemize_with_prosody()
+ *                    results, "0" to leave them NULL (default: "0"). Costs a
+ *                    few text2mecab calls per input character.
+ *   - "lattice_trim_bytes": High-water mark for MeCab's lattice, in bytes of
+ *                    MeCab input (0-65536, default: 4096, 0 = never release).
+ *                    The lattice keeps its storage between calls; after an
+ *                    input above the mark it is released once 32 calls in a
+ *                    row stay below it.
+ *   - "njd_stages":  NJD stages to run, as "full", "phonemes", "reading" or a
+ *                    decimal OpenJTalkNativeStage mask (default: "full"). See
+ *                    OpenJTalkNativeStage for how each skipped stage changes
+ *                    the output. get_option returns the decimal mask.
  *
  * Returns OPENJTALK_NATIVE_ERROR_INVALID_INPUT for unknown keys or out-of-range values.
  */
@@ -192,6 +770,175 @@ OPENJTALK_NATIVE_API int openjtalk_native_set_option(void* handle, const char* k
  */
 OPENJTALK_NATIVE_API const char* openjtalk_native_get_option(void* handle, const char* key);
 
+/**
+ * @brief Create an engine that phonemizes documents on a pool of handles
+ * @param dict_path Path to the dictionary directory
+ * @param worker_count Number of worker threads, each with its own handle
+ *                     (<= 0 uses the number of online CPUs)
+ * @return Engine handle, or NULL on failure
+ *
+ * @note Worker handles share the dictionary's word cache. Same as
+ *       openjtalk_native_engine_create_with_flags() with no flags.
+ */
+OPENJTALK_NATIVE_API void* openjtalk_native_engine_create(const char* dict_path, int worker_count);
+
+/**
+ * @brief Create an engine with creation flags
+ * @param dict_path Path to the dictionary directory
+ * @param worker_count Number of worker threads (<= 0 uses the number of online CPUs)
+ * @param flags Bitwise OR of OpenJTalkNativeEngineFlags, or 0
+ * @return Engine handle, or NULL on failure
+ *
+ * Every worker creates its handle on its own thread, so the handle's MeCab,
+ * NJD and JPCommon state is first touched, and on NUMA systems placed, by
+ * the thread that uses it. With OPENJTALK_NATIVE_ENGINE_PIN_WORKERS, worker
+ * i is pinned to the i-th CPU the process may run on (wrapping around)
+ * before it creates its handle. Pinning is best effort: where it is not
+ * supported or fails the worker runs unpinned; see
+ * openjtalk_native_engine_get_worker_cpu().
+ *
+ * Sentence results are filled into buffers owned by the worker that ran
+ * them and reused once the document is stitched. Each worker keeps up to 64
+ * idle buffers, counted in result_bytes_outstanding until the engine is
+ * destroyed.
+ */
+OPENJTALK_NATIVE_API void* openjtalk_native_engine_create_with_flags(const char* dict_path, int worker_count, int flags);
+
+/**
+ * @brief Destroy an engine, waiting for queued work to finish
+ * @param engine Engine returned by openjtalk_native_engine_create()
+ */
+OPENJTALK_NATIVE_API void openjtalk_native_engine_destroy(void* engine);
+
+/**
+ * @brief Get the number of worker threads of an engine
+ * @param engine Engine returned by openjtalk_native_engine_create()
+ * @return Worker count, or 0 if engine is NULL
+ */
+OPENJTALK_NATIVE_API int openjtalk_native_engine_get_worker_count(void* engine);
+
+/**
+ * @brief Get the CPU an engine worker is pinned to
+ * @param engine Engine returned by openjtalk_native_engine_create_with_flags()
+ * @param worker Worker index, 0 to worker_count - 1
+ * @return CPU number, or -1 if the worker is not pinned or engine/worker is invalid
+ */
+OPENJTALK_NATIVE_API int openjtalk_native_engine_get_worker_cpu(void* engine, int worker);
+
+/**
+ * @brief Set an engine option
+ * @param engine Engine returned by openjtalk_native_engine_create()
+ * @param key Option key
+ * @param value Option value as string
+ * @return OPENJTALK_NATIVE_SUCCESS on success, or an error code
+ *
+ * Available options:
+ *   - "reserved_workers":        Workers that only serve the interactive lane
+ *                                (0 to worker_count - 1, default: 1, or 0 with
+ *                                a single worker)
+ *   - "interactive_queue_limit": Sentences the interactive lane holds before
+ *                                submitters block (1-65536, default: 1024)
+ *   - "bulk_queue_limit":        Same for the bulk lane (1-65536, default: 1024)
+ * Options may change while documents are in flight.
+ */
+OPENJTALK_NATIVE_API int openjtalk_native_engine_set_option(void* engine, const char* key, const char* value);
+
+/**
+ * @brief Render call metrics summed over an engine's workers
+ * @param engine Engine returned by openjtalk_native_engine_create()
+ * @param buffer Destination, or NULL to query the size
+ * @param capacity Size of buffer in bytes
+ * @return See openjtalk_native_render_metrics(); 0 if engine is NULL
+ *
+ * Each document sentence counts as one call. Adds per-lane histograms of
+ * queue wait and processing time, openjtalk_native_engine_queue_wait_seconds
+ * and openjtalk_native_engine_processing_seconds, labelled
+ * lane="interactive" or lane="bulk".
+ */
+OPENJTALK_NATIVE_API size_t openjtalk_native_engine_render_metrics(void* engine, char* buffer, size_t capacity);
+
+/**
+ * @brief Phonemize a document of any length in parallel
+ * @param engine Engine returned by openjtalk_native_engine_create()
+ * @param text UTF-8 encoded Japanese text
+ * @return Document result, or NULL if engine/text is NULL or empty or memory
+ *         runs out. Must be freed with openjtalk_native_free_document_result()
+ *
+ * Sentences end after 。．！？!? or a newline; trailing closing brackets stay
+ * with their sentence. Sentences longer than 4096 bytes are cut after the
+ * last 、 or ， that fits. A sentence that fails is reported in
+ * sentence_errors and does not fail the document.
+ *
+ * Runs in the interactive lane; see
+ * openjtalk_native_engine_phonemize_document_with_priority().
+ */
+OPENJTALK_NATIVE_API OpenJTalkNativeDocumentResult* openjtalk_native_engine_phonemize_document(void* engine, const char* text);
+
+/**
+ * @brief Phonemize a document in a given priority lane
+ * @param engine Engine returned by openjtalk_native_engine_create()
+ * @param text UTF-8 encoded Japanese text
+ * @param priority OpenJTalkNativePriority
+ * @return Document result as openjtalk_native_engine_phonemize_document(),
+ *         or NULL if priority is out of range
+ *
+ * Each lane is a bounded FIFO of sentences. Free workers always take
+ * interactive sentences first, and "reserved_workers" workers take nothing
+ * else, so a long bulk batch delays interactive calls by at most the
+ * sentences already running. When a lane is full the call blocks until
+ * workers make room.
+ */
+OPENJTALK_NATIVE_API OpenJTalkNativeDocumentResult* openjtalk_native_engine_phonemize_document_with_priority(void* engine,
+                                                                                                         const char* text,
+                                                                                                         int priority);
+
+/**
+ * @brief Free a document result
+ * @param result Result returned by openjtalk_native_engine_phonemize_document()
+ */
+OPENJTALK_NATIVE_API void openjtalk_native_free_document_result(OpenJTalkNativeDocumentResult* result);
+
+/**
+ * @brief Connect to a local openjtalk_native_server
+ * @param socket_path Unix domain socket path the server listens on
+ * @return Client handle, or NULL if the server is unreachable (always NULL on Windows)
+ *
+ * The client sends one request at a time and blocks for the response. A
+ * client must not be used from multiple threads simultaneously; open one
+ * connection per thread. Results are freed with the usual free functions.
+ */
+OPENJTALK_NATIVE_API void* openjtalk_native_client_connect(const char* socket_path);
+
+/**
+ * @brief Close a server connection
+ * @param client Client returned by openjtalk_native_client_connect()
+ */
+OPENJTALK_NATIVE_API void openjtalk_native_client_close(void* client);
+
+/**
+ * @brief Phonemize text on the server
+ * @param client Client returned by openjtalk_native_client_connect()
+ * @param text UTF-8 encoded Japanese text
+ * @return Phoneme result, or NULL on failure. Must be freed with openjtalk_native_free_result()
+ */
+OPENJTALK_NATIVE_API OpenJTalkNativePhonemeResult* openjtalk_native_client_phonemize(void* client, const char* text);
+
+/**
+ * @brief Phonemize text with prosody features on the server
+ * @param client Client returned by openjtalk_native_client_connect()
+ * @param text UTF-8 encoded Japanese text
+ * @return Prosody result, or NULL on failure. Must be freed with openjtalk_native_free_prosody_result()
+ */
+OPENJTALK_NATIVE_API OpenJTalkNativeProsodyResult* openjtalk_native_client_phonemize_with_prosody(void* client, const char* text);
+
+/**
+ * @brief Get the last error code for a client
+ * @param client Client returned by openjtalk_native_client_connect()
+ * @return Error code (OpenJTalkNativeError). OPENJTALK_NATIVE_ERROR_CONNECTION
+ *         means the connection is unusable; close it and reconnect.
+ */
+OPENJTALK_NATIVE_API int openjtalk_native_client_get_last_error(void* client);
+
 /* UTF-8 optimized functions (avoids string marshalling overhead on mobile) */
 OPENJTALK_NATIVE_API void* openjtalk_native_initialize_utf8(const unsigned char* dict_path_utf8, int path_length);
 OPENJTALK_NATIVE_API char* openjtalk_native_analyze_utf8(void* handle, const unsigned char* text_utf8, int text_length);
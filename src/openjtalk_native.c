@@ -21,11 +21,14 @@
 #include <njd_set_long_vowel.h>
 #include <njd2jpcommon.h>
 
+#include "openjtalk_native_internal.h"
+
 #define VERSION "1.0.0"
 
-/* Maximum input text length (in bytes) to prevent buffer overflows.
-   text2mecab can expand input, so we cap well below the 8192 buffer. */
-#define MAX_INPUT_TEXT_LENGTH 4096
+/* MeCab lattice high-water mark (bytes of MeCab input) and how many calls
+   below it must follow an outlier before the lattice is released */
+#define DEFAULT_LATTICE_TRIM_BYTES 4096
+#define LATTICE_TRIM_DELAY 32
 
 /* Debug logging */
 #ifdef ENABLE_DEBUG_LOG
@@ -39,19 +42,8 @@
 #define DEBUG_LOG(fmt, ...)
 #endif
 
-/* OpenJTalk context structure */
-typedef struct {
-    Mecab* mecab;
-    NJD* njd;
-    JPCommon* jpcommon;
-    char* dict_path;
-    int last_error;
-    bool initialized;
-    double speech_rate;
-    double pitch;
-    double volume;
-    char option_buffer[32]; /* Per-instance buffer for get_option return values */
-} OpenJTalkNativeContext;
+/* Bytes held by results handed to callers and not yet freed (all handles) */
+static volatile int64_t result_bytes_outstanding = 0;
 
 const char* openjtalk_native_get_version(void) {
     return VERSION;
@@ -73,6 +65,11 @@ void* openjtalk_native_create(const char* dict_path) {
     ctx->speech_rate = 1.0;
     ctx->pitch = 0.0;
     ctx->volume = 1.0;
+    ctx->use_word_cache = false;
+    ctx->normalize_numbers = false;
+    ctx->latin_mode = OJTN_LATIN_KEEP;
+    ctx->njd_stages = OPENJTALK_NATIVE_STAGES_FULL;
+    ctx->lattice_trim_bytes = DEFAULT_LATTICE_TRIM_BYTES;
 
     ctx->dict_path = strdup(dict_path);
     if (!ctx->dict_path) {
@@ -105,9 +102,20 @@ void* openjtalk_native_create(const char* dict_path) {
         return NULL;
     }
 
+    /* Share the word cache with other handles on the same dictionary */
+    ctx->dictionary = ojtn_dictionary_acquire(ctx->dict_path);
+    if (!ctx->dictionary) {
+        Mecab_clear(ctx->mecab);
+        free(ctx->mecab);
+        free(ctx->dict_path);
+        free(ctx);
+        return NULL;
+    }
+
     /* Initialize NJD */
     ctx->njd = (NJD*)calloc(1, sizeof(NJD));
     if (!ctx->njd) {
+        ojtn_dictionary_release(ctx->dictionary);
         Mecab_clear(ctx->mecab);
         free(ctx->mecab);
         free(ctx->dict_path);
@@ -121,6 +129,7 @@ void* openjtalk_native_create(const char* dict_path) {
     if (!ctx->jpcommon) {
         NJD_clear(ctx->njd);
         free(ctx->njd);
+        ojtn_dictionary_release(ctx->dictionary);
         Mecab_clear(ctx->mecab);
         free(ctx->mecab);
         free(ctx->dict_path);
@@ -153,219 +162,628 @@ void openjtalk_native_destroy(void* handle) {
         Mecab_clear(ctx->mecab);
         free(ctx->mecab);
     }
+    ojtn_dictionary_release(ctx->dictionary);
+    ojtn_alignment_destroy(ctx->alignment);
+    free(ctx->row_phoneme);
+    free(ctx->row_len);
+    free(ctx->row_fields);
+    free(ctx->row_label);
     if (ctx->dict_path) {
         free(ctx->dict_path);
     }
     free(ctx);
 }
 
-/* Convert JPCommon labels to phonemes */
-static OpenJTalkNativePhonemeResult* labels_to_phonemes(OpenJTalkNativeContext* ctx, JPCommon* jpcommon) {
-    OpenJTalkNativePhonemeResult* result = (OpenJTalkNativePhonemeResult*)calloc(1, sizeof(OpenJTalkNativePhonemeResult));
-    if (!result) return NULL;
+/* Buffers are measured by their capacity, or by their contents for results
+   built without one (client and engine results) */
+static uint64_t buffer_size(int capacity, int used) {
+    return (uint64_t)(capacity > used ? capacity : used);
+}
 
-    int label_size = JPCommon_get_label_size(jpcommon);
-    char** label_feature = JPCommon_get_label_feature(jpcommon);
+static int string_size(const char* s) {
+    return s ? (int)strlen(s) + 1 : 0;
+}
 
-    if (label_size <= 0 || !label_feature) {
-        free(result);
-        return NULL;
+/* Heap behind a result's pointers, without the struct itself */
+static uint64_t phoneme_buffer_bytes(const OpenJTalkNativePhonemeResult* result) {
+    return buffer_size(result->string_capacity, string_size(result->phonemes)) +
+        buffer_size(result->phoneme_capacity, result->phoneme_count) * (sizeof(int) + sizeof(float));
+}
+
+static uint64_t prosody_buffer_bytes(const OpenJTalkNativeProsodyResult* result) {
+    uint64_t rows = buffer_size(result->phoneme_capacity, result->phoneme_count);
+    uint64_t bytes = buffer_size(result->string_capacity, string_size(result->phonemes)) +
+        buffer_size(result->symbol_capacity, string_size(result->prosody_symbols)) + rows * 6 * sizeof(int);
+    if (result->source_start) bytes += rows * 2 * sizeof(int);
+    if (result->accent_phrase_start) {
+        bytes += buffer_size(result->accent_phrase_capacity, result->accent_phrase_count) * 2 * sizeof(int);
+    }
+    return bytes;
+}
+
+uint64_t ojtn_phoneme_result_bytes(const OpenJTalkNativePhonemeResult* result) {
+    return sizeof(OpenJTalkNativePhonemeResult) + phoneme_buffer_bytes(result);
+}
+
+uint64_t ojtn_prosody_result_bytes(const OpenJTalkNativeProsodyResult* result) {
+    return sizeof(OpenJTalkNativeProsodyResult) + prosody_buffer_bytes(result);
+}
+
+static uint64_t label_result_bytes(const OpenJTalkNativeLabelResult* result) {
+    return sizeof(OpenJTalkNativeLabelResult) +
+        (uint64_t)result->row_count * result->field_count * sizeof(int16_t);
+}
+
+/* Release a result without touching the outstanding-bytes counter; used for
+   results that never reached the caller */
+static void destroy_phoneme_result(OpenJTalkNativePhonemeResult* result) {
+    if (!result) return;
+    if (result->phonemes) free(result->phonemes);
+    if (result->phoneme_ids) free(result->phoneme_ids);
+    if (result->durations) free(result->durations);
+    free(result);
+}
+
+/* Free a result's buffers and reset it to an empty result */
+static void clear_phoneme_result(OpenJTalkNativePhonemeResult* result) {
+    free(result->phonemes);
+    free(result->phoneme_ids);
+    free(result->durations);
+    memset(result, 0, sizeof(*result));
+}
+
+static void clear_prosody_result(OpenJTalkNativeProsodyResult* result) {
+    free(result->phonemes);
+    free(result->prosody_a1);
+    free(result->prosody_a2);
+    free(result->prosody_a3);
+    free(result->prosody_symbols);
+    free(result->prosody_marks);
+    free(result->accent_phrase_index);
+    free(result->mora_index);
+    free(result->source_start);
+    free(result->source_end);
+    free(result->accent_phrase_start);
+    free(result->accent_phrase_end);
+    memset(result, 0, sizeof(*result));
+}
+
+void ojtn_destroy_prosody_result(OpenJTalkNativeProsodyResult* result) {
+    if (!result) return;
+    if (result->phonemes) free(result->phonemes);
+    if (result->prosody_a1) free(result->prosody_a1);
+    if (result->prosody_a2) free(result->prosody_a2);
+    if (result->prosody_a3) free(result->prosody_a3);
+    if (result->prosody_symbols) free(result->prosody_symbols);
+    if (result->prosody_marks) free(result->prosody_marks);
+    if (result->accent_phrase_index) free(result->accent_phrase_index);
+    if (result->mora_index) free(result->mora_index);
+    free(result->source_start);
+    free(result->source_end);
+    free(result->accent_phrase_start);
+    free(result->accent_phrase_end);
+    free(result);
+}
+
+void ojtn_track_result_bytes(int64_t delta) {
+    ojtn_atomic_add(&result_bytes_outstanding, delta);
+}
+
+/* Record a result handed to the caller */
+static void account_result(OpenJTalkNativeContext* ctx, uint64_t bytes) {
+    ojtn_atomic_add(&result_bytes_outstanding, (int64_t)bytes);
+    if (ctx->working_set_bytes + bytes > ctx->peak_call_bytes) {
+        ctx->peak_call_bytes = ctx->working_set_bytes + bytes;
+    }
+}
+
+/* Locate the current phoneme (p3) of a full-context label: xx^xx-phoneme+xx=xx/A:...
+   Returns NULL for labels that do not produce an output phoneme. Utterance-edge
+   "sil" is reported as "pau"; "sil" anywhere else is dropped. */
+static const char* get_label_phoneme(const char* label, int index, int label_size, int* out_len) {
+    const char* phoneme_start = strchr(label, '-');
+    const char* phoneme_end = strchr(label, '+');
+
+    if (!phoneme_start || !phoneme_end || phoneme_start >= phoneme_end) return NULL;
+
+    phoneme_start++; /* Skip '-' */
+    int phoneme_len = (int)(phoneme_end - phoneme_start);
+
+    /* Handle silence: require >= 3 chars to avoid matching 's' as 'sil' */
+    if (phoneme_len >= 3 && strncmp(phoneme_start, "sil", 3) == 0) {
+        if (index != 0 && index != label_size - 1) return NULL;
+        *out_len = 3;
+        return "pau";
+    }
+
+    *out_len = phoneme_len;
+    return phoneme_start;
+}
+
+/* Capacity to grow to for count elements: unchanged while it fits, at least
+   doubled otherwise, so a reused result stops growing once it has seen its
+   largest input. A new result (capacity 0) gets exactly count. */
+static int grow_capacity(int capacity, int count) {
+    if (count <= capacity) return capacity;
+    return capacity > 0 && capacity * 2 > count ? capacity * 2 : count;
+}
+
+/* Reallocate *buffer to count elements of size bytes; on failure *buffer
+   keeps its old block */
+static bool resize_buffer(void** buffer, int count, size_t size) {
+    void* p = realloc(*buffer, (size_t)(count > 0 ? count : 1) * size);
+    if (!p) return false;
+    *buffer = p;
+    return true;
+}
+
+/* Make a string buffer hold at least bytes; capacities only change once
+   every buffer they describe has been resized */
+static bool reserve_string(char** buffer, int* capacity, int bytes) {
+    int n = grow_capacity(*capacity, bytes);
+    if (n == *capacity && *buffer) return true;
+    if (!resize_buffer((void**)buffer, n, 1)) return false;
+    *capacity = n;
+    return true;
+}
+
+/* Convert full-context labels to phonemes, writing into result and growing
+   its buffers as needed */
+static bool fill_phonemes(OpenJTalkNativeContext* ctx, char** label_feature, int label_size,
+                          OpenJTalkNativePhonemeResult* result) {
+    if (label_size <= 0 || !label_feature) return false;
+
+    /* Durations are estimated from the label in the same pass that
+       extracts the phoneme; label_size bounds the phoneme count */
+    int capacity = grow_capacity(result->phoneme_capacity, label_size);
+    if (capacity != result->phoneme_capacity || !result->durations || !result->phoneme_ids) {
+        if (!resize_buffer((void**)&result->durations, capacity, sizeof(float)) ||
+            !resize_buffer((void**)&result->phoneme_ids, capacity, sizeof(int))) {
+            return false;
+        }
+        result->phoneme_capacity = capacity;
+    }
+
+    /* Size the phoneme string exactly, then write straight into it */
+    size_t phoneme_bytes = 0;
+    for (int i = 0; i < label_size; i++) {
+        int phoneme_len;
+        if (label_feature[i] && get_label_phoneme(label_feature[i], i, label_size, &phoneme_len)) {
+            phoneme_bytes += phoneme_len + 1;
+        }
     }
+    if (!reserve_string(&result->phonemes, &result->string_capacity, (int)phoneme_bytes + 1)) return false;
 
-    char phoneme_buffer[8192] = {0};
-    char* buf_ptr = phoneme_buffer;
+    char* buf_ptr = result->phonemes;
     int phoneme_count = 0;
+    float total_duration = 0.0f;
+    int16_t fields[OPENJTALK_NATIVE_LABEL_FIELD_COUNT];
 
     for (int i = 0; i < label_size; i++) {
         if (!label_feature[i]) continue;
 
         DEBUG_LOG("Label[%d]: %s", i, label_feature[i]);
 
-        /* Extract phoneme from full-context label: xx^xx-phoneme+xx=xx/A:... */
-        char* phoneme_start = strchr(label_feature[i], '-');
-        char* phoneme_end = strchr(label_feature[i], '+');
-
-        if (phoneme_start && phoneme_end && phoneme_start < phoneme_end) {
-            phoneme_start++; /* Skip '-' */
-            int phoneme_len = (int)(phoneme_end - phoneme_start);
-
-            /* Handle silence: require >= 3 chars to avoid matching 's' as 'sil' */
-            if (phoneme_len >= 3 && strncmp(phoneme_start, "sil", 3) == 0) {
-                if (i == 0 || i == label_size - 1) {
-                    if (buf_ptr != phoneme_buffer) *buf_ptr++ = ' ';
-                    memcpy(buf_ptr, "pau", 3);
-                    buf_ptr += 3;
-                    phoneme_count++;
-                }
-            } else {
-                if (buf_ptr != phoneme_buffer) *buf_ptr++ = ' ';
-                strncpy(buf_ptr, phoneme_start, phoneme_len);
-                buf_ptr += phoneme_len;
-                phoneme_count++;
-            }
-        }
+        int phoneme_len;
+        const char* phoneme = get_label_phoneme(label_feature[i], i, label_size, &phoneme_len);
+        if (!phoneme) continue;
+
+        if (buf_ptr != result->phonemes) *buf_ptr++ = ' ';
+        memcpy(buf_ptr, phoneme, phoneme_len);
+        buf_ptr += phoneme_len;
+
+        bool parsed = ojtn_parse_label(label_feature[i], fields);
+        float duration = ojtn_phoneme_duration(phoneme, phoneme_len, parsed ? fields : NULL,
+                                               i == 0 || i == label_size - 1, ctx->speech_rate);
+        result->phoneme_ids[phoneme_count] = ojtn_phoneme_id(phoneme, phoneme_len);
+        result->durations[phoneme_count++] = duration;
+        total_duration += duration;
     }
 
     *buf_ptr = '\0';
 
-    DEBUG_LOG("Extracted phonemes: %s (count: %d)", phoneme_buffer, phoneme_count);
+    DEBUG_LOG("Extracted phonemes: %s (count: %d, duration: %.3f)", result->phonemes, phoneme_count, total_duration);
 
     result->phoneme_count = phoneme_count;
-    result->phonemes = strdup(phoneme_buffer);
-    result->phoneme_ids = (int*)calloc(phoneme_count, sizeof(int));
-    result->durations = (float*)calloc(phoneme_count, sizeof(float));
+    result->total_duration = total_duration;
 
-    if (!result->phonemes || !result->phoneme_ids || !result->durations) {
-        openjtalk_native_free_result(result);
+    return true;
+}
+
+static OpenJTalkNativePhonemeResult* labels_to_phonemes(OpenJTalkNativeContext* ctx, char** label_feature, int label_size) {
+    OpenJTalkNativePhonemeResult* result = (OpenJTalkNativePhonemeResult*)calloc(1, sizeof(OpenJTalkNativePhonemeResult));
+    if (!result) return NULL;
+
+    if (!fill_phonemes(ctx, label_feature, label_size, result)) {
+        destroy_phoneme_result(result);
         return NULL;
     }
+    return result;
+}
 
-    for (int i = 0; i < phoneme_count; i++) {
-        result->phoneme_ids[i] = 1;
-        result->durations[i] = 0.05f;
-    }
-    result->total_duration = phoneme_count * 0.05f;
+/* True for phonemes that close a mora (vowels, devoiced vowels, N, cl) */
+static bool is_mora_final(const char* phoneme, int len) {
+    if (len == 1) return strchr("aiueoAIUEON", phoneme[0]) != NULL;
+    return len == 2 && phoneme[0] == 'c' && phoneme[1] == 'l';
+}
 
-    return result;
+/* Read a label column, treating "xx" as 0 like the original strtol parse */
+static int label_value(const int16_t* fields, int field) {
+    return fields[field] == OPENJTALK_NATIVE_LABEL_UNDEFINED ? 0 : fields[field];
 }
 
-/* Convert JPCommon labels to phonemes with prosody features (A1/A2/A3) */
-static OpenJTalkNativeProsodyResult* labels_to_phonemes_with_prosody(OpenJTalkNativeContext* ctx, JPCommon* jpcommon) {
-    OpenJTalkNativeProsodyResult* result = (OpenJTalkNativeProsodyResult*)calloc(1, sizeof(OpenJTalkNativeProsodyResult));
-    if (!result) return NULL;
+/* Input offsets of each phoneme and accent phrase from the label rows the
+   phonemes were taken from */
+static bool set_source_offsets(OpenJTalkNativeProsodyResult* result, const OpenJTalkNativeAlignment* alignment,
+                               const int* rows) {
+    int n = result->phoneme_count;
+    int phrases = result->accent_phrase_count;
+    int capacity = grow_capacity(result->accent_phrase_capacity, phrases);
+    if (capacity != result->accent_phrase_capacity || !result->accent_phrase_start || !result->accent_phrase_end) {
+        if (!resize_buffer((void**)&result->accent_phrase_start, capacity, sizeof(int)) ||
+            !resize_buffer((void**)&result->accent_phrase_end, capacity, sizeof(int))) {
+            return false;
+        }
+        result->accent_phrase_capacity = capacity;
+    }
 
-    int label_size = JPCommon_get_label_size(jpcommon);
-    char** label_feature = JPCommon_get_label_feature(jpcommon);
+    for (int p = 0; p < phrases; p++) {
+        result->accent_phrase_start[p] = alignment->text_length;
+        result->accent_phrase_end[p] = 0;
+    }
+    for (int i = 0; i < n; i++) {
+        int start = alignment->row_start[rows[i]], end = alignment->row_end[rows[i]];
+        result->source_start[i] = start;
+        result->source_end[i] = end;
+
+        int p = result->accent_phrase_index[i];
+        if (p < 0) continue;
+        if (start < result->accent_phrase_start[p]) result->accent_phrase_start[p] = start;
+        if (end > result->accent_phrase_end[p]) result->accent_phrase_end[p] = end;
+    }
+    return true;
+}
 
-    if (label_size <= 0 || !label_feature) {
-        free(result);
-        return NULL;
+/* Grow the per-phoneme arrays of a prosody result to hold count phonemes.
+   The offset arrays exist only when offsets is set and share the capacity. */
+static bool reserve_prosody_rows(OpenJTalkNativeProsodyResult* result, int count, bool offsets) {
+    if (!offsets) {
+        free(result->source_start);
+        free(result->source_end);
+        result->source_start = result->source_end = NULL;
     }
 
-    int* temp_a1 = (int*)calloc(label_size, sizeof(int));
-    int* temp_a2 = (int*)calloc(label_size, sizeof(int));
-    int* temp_a3 = (int*)calloc(label_size, sizeof(int));
+    int capacity = grow_capacity(result->phoneme_capacity, count);
+    bool grow = capacity != result->phoneme_capacity || !result->prosody_a1;
+    if (grow || (offsets && (!result->source_start || !result->source_end))) {
+        if (!resize_buffer((void**)&result->prosody_a1, capacity, sizeof(int)) ||
+            !resize_buffer((void**)&result->prosody_a2, capacity, sizeof(int)) ||
+            !resize_buffer((void**)&result->prosody_a3, capacity, sizeof(int)) ||
+            !resize_buffer((void**)&result->prosody_marks, capacity, sizeof(int)) ||
+            !resize_buffer((void**)&result->accent_phrase_index, capacity, sizeof(int)) ||
+            !resize_buffer((void**)&result->mora_index, capacity, sizeof(int))) {
+            return false;
+        }
+        if (offsets && (!resize_buffer((void**)&result->source_start, capacity, sizeof(int)) ||
+                        !resize_buffer((void**)&result->source_end, capacity, sizeof(int)))) {
+            return false;
+        }
+        result->phoneme_capacity = capacity;
+    }
+    return true;
+}
 
-    if (!temp_a1 || !temp_a2 || !temp_a3) {
-        free(temp_a1);
-        free(temp_a2);
-        free(temp_a3);
-        free(result);
-        return NULL;
+/* Grow the handle's per-row scratch to hold label_size rows */
+static bool reserve_row_scratch(OpenJTalkNativeContext* ctx, int label_size) {
+    if (label_size <= ctx->row_capacity) return true;
+    int n = grow_capacity(ctx->row_capacity, label_size);
+    if (!resize_buffer((void**)&ctx->row_phoneme, n, sizeof(const char*)) ||
+        !resize_buffer((void**)&ctx->row_len, n, sizeof(int)) ||
+        !resize_buffer((void**)&ctx->row_fields, n, OPENJTALK_NATIVE_LABEL_FIELD_COUNT * sizeof(int16_t)) ||
+        !resize_buffer((void**)&ctx->row_label, n, sizeof(int))) {
+        return false;
     }
+    ctx->row_capacity = n;
+    return true;
+}
+
+/* Convert JPCommon labels to phonemes with prosody features (A1/A2/A3),
+   prosody marks and accent-phrase / mora indices, writing into result and
+   growing its buffers as needed. alignment, when not NULL, holds input
+   offsets for the label rows. */
+static bool fill_prosody(OpenJTalkNativeContext* ctx, char** label_feature, int label_size,
+                         const OpenJTalkNativeAlignment* alignment, OpenJTalkNativeProsodyResult* result) {
+    if (label_size <= 0 || !label_feature) return false;
+
+    /* Parse each output label once; row i corresponds to phoneme i */
+    if (!reserve_row_scratch(ctx, label_size)) return false;
+    const char** row_phoneme = ctx->row_phoneme;
+    int* row_len = ctx->row_len;
+    int16_t* row_fields = ctx->row_fields;
+    int* row_label = ctx->row_label;
 
-    char phoneme_buffer[8192] = {0};
-    char* buf_ptr = phoneme_buffer;
     int phoneme_count = 0;
+    size_t phoneme_bytes = 0;
 
     for (int i = 0; i < label_size; i++) {
         if (!label_feature[i]) continue;
 
-        char* phoneme_start = strchr(label_feature[i], '-');
-        char* phoneme_end = strchr(label_feature[i], '+');
-
-        if (phoneme_start && phoneme_end && phoneme_start < phoneme_end) {
-            phoneme_start++;
-            int phoneme_len = (int)(phoneme_end - phoneme_start);
-
-            /* Parse /A:a1+a2+a3/ */
-            int a1 = 0, a2 = 0, a3 = 0;
-            char* accent_marker = strstr(label_feature[i], "/A:");
-            if (accent_marker) {
-                accent_marker += 3;
-                a1 = (int)strtol(accent_marker, &accent_marker, 10);
-                if (*accent_marker == '+') {
-                    accent_marker++;
-                    a2 = (int)strtol(accent_marker, &accent_marker, 10);
-                    if (*accent_marker == '+') {
-                        accent_marker++;
-                        a3 = (int)strtol(accent_marker, NULL, 10);
-                    }
-                }
-            }
+        int phoneme_len;
+        const char* phoneme = get_label_phoneme(label_feature[i], i, label_size, &phoneme_len);
+        if (!phoneme) continue;
+
+        row_phoneme[phoneme_count] = phoneme;
+        row_len[phoneme_count] = phoneme_len;
+        row_label[phoneme_count] = i;
+        ojtn_parse_label(label_feature[i], row_fields + phoneme_count * OPENJTALK_NATIVE_LABEL_FIELD_COUNT);
+        phoneme_bytes += phoneme_len + 1;
+        phoneme_count++;
+    }
 
-            if (phoneme_len >= 3 && strncmp(phoneme_start, "sil", 3) == 0) {
-                if (i == 0 || i == label_size - 1) {
-                    if (buf_ptr != phoneme_buffer) *buf_ptr++ = ' ';
-                    memcpy(buf_ptr, "pau", 3);
-                    buf_ptr += 3;
-                    temp_a1[phoneme_count] = a1;
-                    temp_a2[phoneme_count] = a2;
-                    temp_a3[phoneme_count] = a3;
-                    phoneme_count++;
-                }
-            } else {
-                if (buf_ptr != phoneme_buffer) *buf_ptr++ = ' ';
-                strncpy(buf_ptr, phoneme_start, phoneme_len);
-                buf_ptr += phoneme_len;
-                temp_a1[phoneme_count] = a1;
-                temp_a2[phoneme_count] = a2;
-                temp_a3[phoneme_count] = a3;
-                phoneme_count++;
+    /* Every phoneme contributes itself plus at most one mark */
+    if (!reserve_prosody_rows(result, phoneme_count, alignment != NULL) ||
+        !reserve_string(&result->phonemes, &result->string_capacity, (int)phoneme_bytes + 1) ||
+        !reserve_string(&result->prosody_symbols, &result->symbol_capacity, (int)phoneme_bytes + 2 * phoneme_count + 1)) {
+        return false;
+    }
+    result->phoneme_count = phoneme_count;
+
+    const int sil_id = ojtn_phoneme_id("sil", 3);
+    const int pau_id = ojtn_phoneme_id("pau", 3);
+    char* buf_ptr = result->phonemes;
+    char* sym_ptr = result->prosody_symbols;
+    int symbol_count = 0;
+    int accent_phrase = -1;
+    bool phrase_start = true;
+    int mora = 0;
+
+    for (int i = 0; i < phoneme_count; i++) {
+        const int16_t* fields = row_fields + i * OPENJTALK_NATIVE_LABEL_FIELD_COUNT;
+        const int16_t* next_fields = (i + 1 < phoneme_count) ? fields + OPENJTALK_NATIVE_LABEL_FIELD_COUNT : NULL;
+        const char* phoneme = row_phoneme[i];
+        int phoneme_len = row_len[i];
+
+        if (buf_ptr != result->phonemes) *buf_ptr++ = ' ';
+        memcpy(buf_ptr, phoneme, phoneme_len);
+        buf_ptr += phoneme_len;
+
+        int a1 = label_value(fields, OPENJTALK_NATIVE_LABEL_A1);
+        int a2 = label_value(fields, OPENJTALK_NATIVE_LABEL_A2);
+        int a3 = label_value(fields, OPENJTALK_NATIVE_LABEL_A3);
+        result->prosody_a1[i] = a1;
+        result->prosody_a2[i] = a2;
+        result->prosody_a3[i] = a3;
+
+        if (sym_ptr != result->prosody_symbols) *sym_ptr++ = ' ';
+
+        /* Silence and pauses: "^" / "$" / "?" at the utterance edges, "_" inside */
+        int p3 = fields[OPENJTALK_NATIVE_LABEL_P3];
+        if (p3 == sil_id || p3 == pau_id) {
+            char symbol = '_';
+            if (p3 == sil_id) {
+                symbol = (i == 0) ? '^' : (fields[OPENJTALK_NATIVE_LABEL_E3] == 1 ? '?' : '$');
             }
+            *sym_ptr++ = symbol;
+            symbol_count++;
+            result->accent_phrase_index[i] = -1;
+            result->mora_index[i] = -1;
+            result->prosody_marks[i] = 0;
+            phrase_start = true;
+            continue;
+        }
+
+        memcpy(sym_ptr, phoneme, phoneme_len);
+        sym_ptr += phoneme_len;
+        symbol_count++;
+
+        if (phrase_start) {
+            accent_phrase++;
+            phrase_start = false;
         }
+        result->accent_phrase_index[i] = accent_phrase;
+        result->mora_index[i] = mora;
+        bool mora_final = is_mora_final(phoneme, phoneme_len);
+        if (mora_final) mora++;
+
+        /* Marks follow the phoneme they are attached to */
+        int mark = 0;
+        int a2_next = next_fields ? next_fields[OPENJTALK_NATIVE_LABEL_A2] : OPENJTALK_NATIVE_LABEL_UNDEFINED;
+        if (fields[OPENJTALK_NATIVE_LABEL_A3] == 1 && a2_next == 1 && mora_final) {
+            mark = '#';                                   /* accent phrase boundary */
+            phrase_start = true;
+        } else if (fields[OPENJTALK_NATIVE_LABEL_A1] == 0 && a2_next == a2 + 1 &&
+                   a2 != fields[OPENJTALK_NATIVE_LABEL_F1]) {
+            mark = ']';                                   /* pitch fall */
+        } else if (fields[OPENJTALK_NATIVE_LABEL_A2] == 1 && a2_next == 2) {
+            mark = '[';                                   /* pitch rise */
+        }
+
+        if (mark) {
+            *sym_ptr++ = ' ';
+            *sym_ptr++ = (char)mark;
+            symbol_count++;
+        }
+        result->prosody_marks[i] = mark;
     }
 
     *buf_ptr = '\0';
+    *sym_ptr = '\0';
+    result->prosody_symbol_count = symbol_count;
+    result->accent_phrase_count = accent_phrase + 1;
+
+    if (!alignment) {
+        free(result->accent_phrase_start);
+        free(result->accent_phrase_end);
+        result->accent_phrase_start = result->accent_phrase_end = NULL;
+        result->accent_phrase_capacity = 0;
+        return true;
+    }
+    return set_source_offsets(result, alignment, row_label);
+}
 
-    result->phoneme_count = phoneme_count;
-    result->phonemes = strdup(phoneme_buffer);
-    result->prosody_a1 = (int*)calloc(phoneme_count, sizeof(int));
-    result->prosody_a2 = (int*)calloc(phoneme_count, sizeof(int));
-    result->prosody_a3 = (int*)calloc(phoneme_count, sizeof(int));
-
-    if (!result->phonemes || !result->prosody_a1 || !result->prosody_a2 || !result->prosody_a3) {
-        openjtalk_native_free_prosody_result(result);
-        free(temp_a1);
-        free(temp_a2);
-        free(temp_a3);
+static OpenJTalkNativeProsodyResult* labels_to_phonemes_with_prosody(OpenJTalkNativeContext* ctx, char** label_feature, int label_size,
+                                                                     const OpenJTalkNativeAlignment* alignment) {
+    OpenJTalkNativeProsodyResult* result = (OpenJTalkNativeProsodyResult*)calloc(1, sizeof(OpenJTalkNativeProsodyResult));
+    if (!result) return NULL;
+
+    if (!fill_prosody(ctx, label_feature, label_size, alignment, result)) {
+        ojtn_destroy_prosody_result(result);
         return NULL;
     }
+    return result;
+}
 
-    for (int i = 0; i < phoneme_count; i++) {
-        result->prosody_a1[i] = temp_a1[i];
-        result->prosody_a2[i] = temp_a2[i];
-        result->prosody_a3[i] = temp_a3[i];
+/* Convert full-context labels to numeric label columns (one row per phoneme) */
+static OpenJTalkNativeLabelResult* labels_to_fields(char** label_feature, int label_size) {
+    if (label_size <= 0 || !label_feature) return NULL;
+
+    int row_count = 0;
+    for (int i = 0; i < label_size; i++) {
+        int phoneme_len;
+        if (label_feature[i] && get_label_phoneme(label_feature[i], i, label_size, &phoneme_len)) row_count++;
     }
 
-    free(temp_a1);
-    free(temp_a2);
-    free(temp_a3);
+    size_t value_count = (size_t)row_count * OPENJTALK_NATIVE_LABEL_FIELD_COUNT;
+    OpenJTalkNativeLabelResult* result =
+        (OpenJTalkNativeLabelResult*)malloc(sizeof(OpenJTalkNativeLabelResult) + value_count * sizeof(int16_t));
+    if (!result) return NULL;
+
+    result->values = (int16_t*)(result + 1);
+    result->row_count = row_count;
+    result->field_count = OPENJTALK_NATIVE_LABEL_FIELD_COUNT;
+
+    int16_t fields[OPENJTALK_NATIVE_LABEL_FIELD_COUNT];
+    int row = 0;
+    for (int i = 0; i < label_size; i++) {
+        int phoneme_len;
+        if (!label_feature[i] || !get_label_phoneme(label_feature[i], i, label_size, &phoneme_len)) continue;
+
+        /* Fields after a malformed section stay OPENJTALK_NATIVE_LABEL_UNDEFINED */
+        ojtn_parse_label(label_feature[i], fields);
+        for (int f = 0; f < OPENJTALK_NATIVE_LABEL_FIELD_COUNT; f++) {
+            result->values[f * row_count + row] = fields[f];
+        }
+        row++;
+    }
 
     return result;
 }
 
-/* Run the NJD processing pipeline */
-static void run_njd_pipeline(OpenJTalkNativeContext* ctx) {
-    njd_set_pronunciation(ctx->njd);
-    njd_set_digit(ctx->njd);
-    njd_set_accent_phrase(ctx->njd);
-    njd_set_accent_type(ctx->njd);
-    njd_set_unvoiced_vowel(ctx->njd);
-    njd_set_long_vowel(ctx->njd);
+/* Build NJD nodes from the MeCab output, reusing parsed morphemes from the
+   dictionary's word cache. Equivalent to mecab2njd() node for node; returns
+   false if a node cannot be allocated, since dropping it would phonemize
+   different text. */
+static bool mecab_to_njd(OpenJTalkNativeContext* ctx) {
+    char** feature = Mecab_get_feature(ctx->mecab);
+    int size = Mecab_get_size(ctx->mecab);
+
+    if (!ctx->use_word_cache) {
+        mecab2njd(ctx->njd, feature, size);
+        return true;
+    }
+
+    OpenJTalkNativeWordCache* cache = &ctx->dictionary->word_cache;
+    for (int i = 0; i < size; i++) {
+        if (ojtn_word_cache_lookup(cache, feature[i], ctx->njd)) continue;
+
+        NJDNode* node = (NJDNode*)calloc(1, sizeof(NJDNode));
+        if (!node) return false;
+        NJDNode_initialize(node);
+        NJDNode_load(node, feature[i]);
+        NJD_push_node(ctx->njd, node);
+        ojtn_word_cache_insert(cache, feature[i], node);
+    }
+    return true;
 }
 
-OpenJTalkNativePhonemeResult* openjtalk_native_phonemize(void* handle, const char* text) {
-    if (!handle || !text) return NULL;
+/* Number of NJD stages; stage i is bit 1 << i and the stages run in bit order */
+#define NJD_STAGE_COUNT 6
+
+/* Run the NJD stages selected by stages (OpenJTalkNativeStage mask) */
+static void run_njd_pipeline(OpenJTalkNativeContext* ctx, int stages) {
+    if (stages & OPENJTALK_NATIVE_STAGE_PRONUNCIATION) njd_set_pronunciation(ctx->njd);
+    if (stages & OPENJTALK_NATIVE_STAGE_DIGIT) njd_set_digit(ctx->njd);
+    if (stages & OPENJTALK_NATIVE_STAGE_ACCENT_PHRASE) njd_set_accent_phrase(ctx->njd);
+    if (stages & OPENJTALK_NATIVE_STAGE_ACCENT_TYPE) njd_set_accent_type(ctx->njd);
+    if (stages & OPENJTALK_NATIVE_STAGE_UNVOICED_VOWEL) njd_set_unvoiced_vowel(ctx->njd);
+    if (stages & OPENJTALK_NATIVE_STAGE_LONG_VOWEL) njd_set_long_vowel(ctx->njd);
+}
 
-    OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
+/* Heap held by the MeCab features, NJD nodes and labels of the last call.
+   MeCab's internal lattice and JPCommon's intermediate nodes are not visible
+   here, so this is a lower bound. */
+static uint64_t measure_working_set(OpenJTalkNativeContext* ctx) {
+    uint64_t bytes = 0;
+
+    char** feature = Mecab_get_feature(ctx->mecab);
+    int size = Mecab_get_size(ctx->mecab);
+    for (int i = 0; feature && i < size; i++) {
+        bytes += sizeof(char*) + (feature[i] ? strlen(feature[i]) + 1 : 0);
+    }
+
+    for (NJDNode* node = ctx->njd->head; node; node = node->next) {
+        bytes += ojtn_njd_node_bytes(node);
+    }
+
+    int label_size = JPCommon_get_label_size(ctx->jpcommon);
+    char** label_feature = JPCommon_get_label_feature(ctx->jpcommon);
+    for (int i = 0; label_feature && i < label_size; i++) {
+        bytes += sizeof(char*) + (label_feature[i] ? strlen(label_feature[i]) + 1 : 0);
+    }
+
+    return bytes;
+}
+
+/* Stages that change NJD readings; the rest only feed label generation */
+#define READING_STAGES \
+    (OPENJTALK_NATIVE_STAGE_PRONUNCIATION | OPENJTALK_NATIVE_STAGE_DIGIT | OPENJTALK_NATIVE_STAGE_LONG_VOWEL)
+
+/* MeCab's lattice keeps its node and path pools across calls, sized by the
+   largest input it has seen. After an input above lattice_trim_bytes the
+   lattice is replaced with a fresh one once LATTICE_TRIM_DELAY calls in a
+   row stayed below the mark, so a single outlier does not pin its memory
+   while steady long traffic keeps reusing it. */
+static void track_lattice(OpenJTalkNativeContext* ctx, size_t input_bytes) {
+    if (input_bytes > ctx->lattice_peak_bytes) ctx->lattice_peak_bytes = input_bytes;
+    if (input_bytes > ctx->lattice_retained_bytes) ctx->lattice_retained_bytes = input_bytes;
+
+    if (ctx->lattice_trim_bytes == 0 || ctx->lattice_retained_bytes <= ctx->lattice_trim_bytes) return;
+    if (input_bytes > ctx->lattice_trim_bytes) {
+        ctx->lattice_calls_below = 0;
+        return;
+    }
+    if (++ctx->lattice_calls_below < LATTICE_TRIM_DELAY) return;
+
+    mecab_lattice_t* fresh = mecab_model_new_lattice((mecab_model_t*)ctx->mecab->model);
+    if (!fresh) return;
+    mecab_lattice_destroy((mecab_lattice_t*)ctx->mecab->lattice);
+    ctx->mecab->lattice = fresh;
+
+    DEBUG_LOG("Trimmed MeCab lattice (retained input %lu bytes)", (unsigned long)ctx->lattice_retained_bytes);
+    ctx->lattice_retained_bytes = input_bytes;
+    ctx->lattice_calls_below = 0;
+    ctx->lattice_trims++;
+}
 
+/* Validate the input and run text -> MeCab -> unprocessed NJD nodes.
+   On failure sets ctx->last_error and returns false. */
+static bool run_analysis(OpenJTalkNativeContext* ctx, const char* text) {
     if (!ctx->initialized) {
         ctx->last_error = OPENJTALK_NATIVE_ERROR_INITIALIZATION_FAILED;
-        return NULL;
+        return false;
     }
 
     /* Reject empty strings */
     size_t text_len = strlen(text);
     if (text_len == 0) {
         ctx->last_error = OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
-        return NULL;
+        return false;
     }
 
     /* Validate input length to prevent buffer overflow in text2mecab */
     if (text_len > MAX_INPUT_TEXT_LENGTH) {
         ctx->last_error = OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
-        return NULL;
+        return false;
     }
 
     DEBUG_LOG("Phonemizing text: %s", text);
@@ -373,95 +791,775 @@ OpenJTalkNativePhonemeResult* openjtalk_native_phonemize(void* handle, const cha
     NJD_clear(ctx->njd);
     JPCommon_clear(ctx->jpcommon);
 
-    char mecab_text[8192];
+    /* Rewritten text is capped at MAX_INPUT_TEXT_LENGTH like the input.
+       Numbers that do not fit are left as written, but URLs, emoji and
+       Latin runs must not reach MeCab against latin_mode: a Latin rewrite
+       that does not fit fails the call. */
+    OpenJTalkNativeAlignment* alignment = ctx->alignment;
+    char normalized[MAX_INPUT_TEXT_LENGTH + 1];
+    bool rewritten = false;
+    int normalize = ojtn_normalize_text(text, text_len, ctx->normalize_numbers, ctx->latin_mode,
+                                        normalized, sizeof(normalized), alignment ? alignment->normalized_source : NULL);
+    if (normalize == OJTN_NORMALIZE_OVERFLOW) {
+        ctx->last_error = OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+        return false;
+    }
+    if (normalize == OJTN_NORMALIZE_REWRITTEN) {
+        DEBUG_LOG("Normalized text: %s", normalized);
+        text = normalized;
+        rewritten = true;
+        /* Nothing but skipped URLs, emoji and Latin runs */
+        if (!normalized[0]) {
+            ctx->last_error = OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+            return false;
+        }
+    }
+
+    char mecab_text[MECAB_INPUT_BUFFER_SIZE];
     text2mecab(mecab_text, text);
+    if (alignment) ojtn_alignment_map_input(alignment, text, rewritten, text_len, mecab_text);
 
-    if (Mecab_analysis(ctx->mecab, mecab_text) != TRUE) {
+    bool analyzed = Mecab_analysis(ctx->mecab, mecab_text) == TRUE;
+    track_lattice(ctx, strlen(mecab_text));
+    if (!analyzed) {
         ctx->last_error = OPENJTALK_NATIVE_ERROR_PHONEMIZATION_FAILED;
-        return NULL;
+        return false;
     }
 
-    mecab2njd(ctx->njd, Mecab_get_feature(ctx->mecab), Mecab_get_size(ctx->mecab));
-    run_njd_pipeline(ctx);
+    if (!mecab_to_njd(ctx)) {
+        ctx->last_error = OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
+        return false;
+    }
+    return true;
+}
+
+/* Run the selected NJD stages on ctx->njd and build full-context labels,
+   with input offsets for the label rows when alignment is on */
+static void make_labels(OpenJTalkNativeContext* ctx, int stages) {
+    run_njd_pipeline(ctx, stages);
     njd2jpcommon(ctx->jpcommon, ctx->njd);
-    JPCommon_make_label(ctx->jpcommon);
+    if (ctx->alignment) {
+        ojtn_alignment_make_labels(ctx->alignment, ctx->njd, ctx->jpcommon);
+    } else {
+        JPCommon_make_label(ctx->jpcommon);
+    }
+}
+
+static void update_working_set(OpenJTalkNativeContext* ctx) {
+    ctx->working_set_bytes = measure_working_set(ctx);
+    if (ctx->working_set_bytes > ctx->peak_call_bytes) {
+        ctx->peak_call_bytes = ctx->working_set_bytes;
+    }
+}
+
+/* Validate the input and run text -> MeCab -> NJD, then NJD -> JPCommon
+   labels when labels is set. On failure sets ctx->last_error and
+   returns false. */
+static bool run_frontend(OpenJTalkNativeContext* ctx, const char* text, bool labels) {
+    if (!run_analysis(ctx, text)) return false;
+
+    if (labels) {
+        make_labels(ctx, ctx->njd_stages);
+    } else {
+        run_njd_pipeline(ctx, ctx->njd_stages & READING_STAGES);
+    }
+
+    update_working_set(ctx);
+    return true;
+}
 
-    OpenJTalkNativePhonemeResult* result = labels_to_phonemes(ctx, ctx->jpcommon);
+/* Build each output type from labels, account it and set last_error */
+static OpenJTalkNativePhonemeResult* render_phonemes(OpenJTalkNativeContext* ctx, char** labels, int label_size) {
+    OpenJTalkNativePhonemeResult* result = labels_to_phonemes(ctx, labels, label_size);
     if (!result) {
         ctx->last_error = OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
         return NULL;
     }
+    account_result(ctx, ojtn_phoneme_result_bytes(result));
 
     ctx->last_error = OPENJTALK_NATIVE_SUCCESS;
     return result;
 }
 
+static OpenJTalkNativeProsodyResult* render_prosody(OpenJTalkNativeContext* ctx, char** labels, int label_size,
+                                                    const OpenJTalkNativeAlignment* alignment) {
+    OpenJTalkNativeProsodyResult* result = labels_to_phonemes_with_prosody(ctx, labels, label_size, alignment);
+    if (!result) {
+        ctx->last_error = OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
+        return NULL;
+    }
+    account_result(ctx, ojtn_prosody_result_bytes(result));
+
+    ctx->last_error = OPENJTALK_NATIVE_SUCCESS;
+    return result;
+}
+
+static OpenJTalkNativeLabelResult* render_labels(OpenJTalkNativeContext* ctx, char** labels, int label_size) {
+    OpenJTalkNativeLabelResult* result = labels_to_fields(labels, label_size);
+    if (!result) {
+        ctx->last_error = OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
+        return NULL;
+    }
+    account_result(ctx, label_result_bytes(result));
+
+    ctx->last_error = OPENJTALK_NATIVE_SUCCESS;
+    return result;
+}
+
+/* Add one text call to the handle's metrics; phonemes is -1 for calls that
+   failed or return no phoneme sequence */
+static void record_call(OpenJTalkNativeContext* ctx, uint64_t start, const char* text, int phonemes) {
+    ojtn_metrics_record(&ctx->metrics, ojtn_now_ns() - start, strlen(text), phonemes, ctx->last_error);
+}
+
+OpenJTalkNativePhonemeResult* openjtalk_native_phonemize(void* handle, const char* text) {
+    if (!handle || !text) return NULL;
+
+    OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
+    uint64_t start = ojtn_now_ns();
+
+    OpenJTalkNativePhonemeResult* result = NULL;
+    if (run_frontend(ctx, text, true)) {
+        result = render_phonemes(ctx, JPCommon_get_label_feature(ctx->jpcommon), JPCommon_get_label_size(ctx->jpcommon));
+    }
+    record_call(ctx, start, text, result ? result->phoneme_count : -1);
+    return result;
+}
+
 void openjtalk_native_free_result(OpenJTalkNativePhonemeResult* result) {
     if (!result) return;
-    if (result->phonemes) free(result->phonemes);
-    if (result->phoneme_ids) free(result->phoneme_ids);
-    if (result->durations) free(result->durations);
-    free(result);
+    ojtn_atomic_add(&result_bytes_outstanding, -(int64_t)ojtn_phoneme_result_bytes(result));
+    destroy_phoneme_result(result);
 }
 
 OpenJTalkNativeProsodyResult* openjtalk_native_phonemize_with_prosody(void* handle, const char* text) {
     if (!handle || !text) return NULL;
 
     OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
+    uint64_t start = ojtn_now_ns();
+
+    OpenJTalkNativeProsodyResult* result = NULL;
+    if (run_frontend(ctx, text, true)) {
+        const OpenJTalkNativeAlignment* alignment =
+            ctx->alignment && ctx->alignment->rows_valid ? ctx->alignment : NULL;
+        result = render_prosody(ctx, JPCommon_get_label_feature(ctx->jpcommon), JPCommon_get_label_size(ctx->jpcommon),
+                                alignment);
+    }
+    record_call(ctx, start, text, result ? result->phoneme_count : -1);
+    return result;
+}
 
-    if (!ctx->initialized) {
-        ctx->last_error = OPENJTALK_NATIVE_ERROR_INITIALIZATION_FAILED;
-        return NULL;
+void openjtalk_native_free_prosody_result(OpenJTalkNativeProsodyResult* result) {
+    if (!result) return;
+    ojtn_atomic_add(&result_bytes_outstanding, -(int64_t)ojtn_prosody_result_bytes(result));
+    ojtn_destroy_prosody_result(result);
+}
+
+/* Record the change in a reused result's buffers */
+static void account_reused_result(OpenJTalkNativeContext* ctx, uint64_t before, uint64_t after) {
+    ojtn_atomic_add(&result_bytes_outstanding, (int64_t)after - (int64_t)before);
+    if (ctx->working_set_bytes + after > ctx->peak_call_bytes) {
+        ctx->peak_call_bytes = ctx->working_set_bytes + after;
     }
+}
 
-    /* Reject empty strings */
-    size_t text_len = strlen(text);
-    if (text_len == 0) {
+int openjtalk_native_phonemize_into(void* handle, const char* text, OpenJTalkNativePhonemeResult* result) {
+    if (!handle) return OPENJTALK_NATIVE_ERROR_INVALID_HANDLE;
+
+    OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
+    if (!text || !result) {
         ctx->last_error = OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
-        return NULL;
+        return ctx->last_error;
     }
+    uint64_t start = ojtn_now_ns();
+    uint64_t before = phoneme_buffer_bytes(result);
 
-    /* Validate input length to prevent buffer overflow in text2mecab */
-    if (text_len > MAX_INPUT_TEXT_LENGTH) {
+    bool filled = false;
+    if (run_frontend(ctx, text, true)) {
+        filled = fill_phonemes(ctx, JPCommon_get_label_feature(ctx->jpcommon), JPCommon_get_label_size(ctx->jpcommon), result);
+        ctx->last_error = filled ? OPENJTALK_NATIVE_SUCCESS : OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
+    }
+    if (!filled) {
+        result->phoneme_count = 0;
+        result->total_duration = 0.0f;
+        if (result->phonemes) result->phonemes[0] = '\0';
+    }
+
+    account_reused_result(ctx, before, phoneme_buffer_bytes(result));
+    record_call(ctx, start, text, filled ? result->phoneme_count : -1);
+    return ctx->last_error;
+}
+
+int openjtalk_native_phonemize_with_prosody_into(void* handle, const char* text, OpenJTalkNativeProsodyResult* result) {
+    if (!handle) return OPENJTALK_NATIVE_ERROR_INVALID_HANDLE;
+
+    OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
+    if (!text || !result) {
         ctx->last_error = OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
-        return NULL;
+        return ctx->last_error;
+    }
+    uint64_t start = ojtn_now_ns();
+    uint64_t before = prosody_buffer_bytes(result);
+
+    bool filled = false;
+    if (run_frontend(ctx, text, true)) {
+        const OpenJTalkNativeAlignment* alignment =
+            ctx->alignment && ctx->alignment->rows_valid ? ctx->alignment : NULL;
+        filled = fill_prosody(ctx, JPCommon_get_label_feature(ctx->jpcommon), JPCommon_get_label_size(ctx->jpcommon),
+                              alignment, result);
+        ctx->last_error = filled ? OPENJTALK_NATIVE_SUCCESS : OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
+    }
+    if (!filled) {
+        result->phoneme_count = 0;
+        result->prosody_symbol_count = 0;
+        result->accent_phrase_count = 0;
+        if (result->phonemes) result->phonemes[0] = '\0';
+        if (result->prosody_symbols) result->prosody_symbols[0] = '\0';
     }
 
-    NJD_clear(ctx->njd);
-    JPCommon_clear(ctx->jpcommon);
+    account_reused_result(ctx, before, prosody_buffer_bytes(result));
+    record_call(ctx, start, text, filled ? result->phoneme_count : -1);
+    return ctx->last_error;
+}
 
-    char mecab_text[8192];
-    text2mecab(mecab_text, text);
+void openjtalk_native_clear_result(OpenJTalkNativePhonemeResult* result) {
+    if (!result) return;
+    ojtn_atomic_add(&result_bytes_outstanding, -(int64_t)phoneme_buffer_bytes(result));
+    clear_phoneme_result(result);
+}
 
-    if (Mecab_analysis(ctx->mecab, mecab_text) != TRUE) {
-        ctx->last_error = OPENJTALK_NATIVE_ERROR_PHONEMIZATION_FAILED;
-        return NULL;
+void openjtalk_native_clear_prosody_result(OpenJTalkNativeProsodyResult* result) {
+    if (!result) return;
+    ojtn_atomic_add(&result_bytes_outstanding, -(int64_t)prosody_buffer_bytes(result));
+    clear_prosody_result(result);
+}
+
+OpenJTalkNativeLabelResult* openjtalk_native_extract_labels(void* handle, const char* text) {
+    if (!handle || !text) return NULL;
+
+    OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
+    uint64_t start = ojtn_now_ns();
+
+    OpenJTalkNativeLabelResult* result = NULL;
+    if (run_frontend(ctx, text, true)) {
+        result = render_labels(ctx, JPCommon_get_label_feature(ctx->jpcommon), JPCommon_get_label_size(ctx->jpcommon));
     }
+    record_call(ctx, start, text, result ? result->row_count : -1);
+    return result;
+}
 
-    mecab2njd(ctx->njd, Mecab_get_feature(ctx->mecab), Mecab_get_size(ctx->mecab));
-    run_njd_pipeline(ctx);
-    njd2jpcommon(ctx->jpcommon, ctx->njd);
-    JPCommon_make_label(ctx->jpcommon);
+void openjtalk_native_free_label_result(OpenJTalkNativeLabelResult* result) {
+    if (!result) return;
+    ojtn_atomic_add(&result_bytes_outstanding, -(int64_t)label_result_bytes(result));
+    /* values share the result allocation */
+    free(result);
+}
+
+/* Concatenate the pronunciations left in ctx->njd by the reading stages */
+static char* collect_reading(OpenJTalkNativeContext* ctx) {
+    size_t length = 0;
+    for (NJDNode* node = ctx->njd->head; node; node = node->next) {
+        const char* pron = NJDNode_get_pron(node);
+        if (pron && strcmp(pron, "*") != 0) length += strlen(pron);
+    }
 
-    OpenJTalkNativeProsodyResult* result = labels_to_phonemes_with_prosody(ctx, ctx->jpcommon);
+    char* result = (char*)malloc(length + 1);
     if (!result) {
         ctx->last_error = OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
         return NULL;
     }
 
+    char* p = result;
+    for (NJDNode* node = ctx->njd->head; node; node = node->next) {
+        const char* pron = NJDNode_get_pron(node);
+        if (!pron || strcmp(pron, "*") == 0) continue;
+        size_t n = strlen(pron);
+        memcpy(p, pron, n);
+        p += n;
+    }
+    *p = '\0';
+    account_result(ctx, length + 1);
+
     ctx->last_error = OPENJTALK_NATIVE_SUCCESS;
     return result;
 }
 
-void openjtalk_native_free_prosody_result(OpenJTalkNativeProsodyResult* result) {
+char* openjtalk_native_get_reading(void* handle, const char* text) {
+    if (!handle || !text) return NULL;
+
+    OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
+    uint64_t start = ojtn_now_ns();
+
+    char* result = run_frontend(ctx, text, false) ? collect_reading(ctx) : NULL;
+    record_call(ctx, start, text, -1);
+    return result;
+}
+
+/* Copy a pronunciation without the devoicing marks (’) njd_set_unvoiced_vowel
+   adds; out may be NULL to measure. Returns the length without the NUL. */
+static size_t copy_pron(const char* pron, char* out) {
+    static const char devoiced[] = "\xE2\x80\x99";
+    size_t len = 0;
+    for (const char* p = pron; *p; ) {
+        if (strncmp(p, devoiced, 3) == 0) {
+            p += 3;
+            continue;
+        }
+        if (out) out[len] = *p;
+        len++;
+        p++;
+    }
+    if (out) out[len] = '\0';
+    return len;
+}
+
+static uint64_t reading_result_bytes(const OpenJTalkNativeReadingResult* result) {
+    uint64_t bytes = sizeof(OpenJTalkNativeReadingResult) + (uint64_t)result->word_count * 3 * sizeof(char*) +
+        strlen(result->phonemes) + 1 + strlen(result->reading) + 1 + strlen(result->romaji) + 1;
+    for (int i = 0; i < result->word_count; i++) {
+        bytes += strlen(result->word_surfaces[i]) + 1 + strlen(result->word_readings[i]) + 1 +
+            strlen(result->word_romaji[i]) + 1;
+    }
+    return bytes;
+}
+
+/* Phonemes from labels plus the readings of the NJD nodes they were built
+   from, in one allocation */
+static OpenJTalkNativeReadingResult* labels_to_reading(OpenJTalkNativeContext* ctx, char** labels, int label_size) {
+    OpenJTalkNativePhonemeResult* phonemes = labels_to_phonemes(ctx, labels, label_size);
+    if (!phonemes) return NULL;
+
+    int words = 0;
+    size_t string_bytes = strlen(phonemes->phonemes) + 1;
+    size_t reading_bytes = 1, romaji_bytes = 1;
+    for (NJDNode* node = ctx->njd->head; node; node = node->next) {
+        const char* pron = NJDNode_get_pron(node);
+        if (!pron || strcmp(pron, "*") == 0) continue;
+        const char* surface = NJDNode_get_string(node);
+        size_t reading = copy_pron(pron, NULL);
+        size_t romaji = ojtn_kana_to_romaji(pron, NULL);
+        string_bytes += (surface ? strlen(surface) : 0) + 1 + reading + 1 + romaji + 1;
+        reading_bytes += reading;
+        romaji_bytes += romaji + 1;
+        words++;
+    }
+
+    /* Pointer arrays follow the struct, strings follow the pointers */
+    size_t pointer_bytes = (size_t)words * 3 * sizeof(char*);
+    OpenJTalkNativeReadingResult* result = (OpenJTalkNativeReadingResult*)malloc(
+        sizeof(OpenJTalkNativeReadingResult) + pointer_bytes + string_bytes + reading_bytes + romaji_bytes);
+    if (!result) {
+        destroy_phoneme_result(phonemes);
+        return NULL;
+    }
+
+    char** pointers = (char**)(result + 1);
+    result->word_surfaces = pointers;
+    result->word_readings = pointers + words;
+    result->word_romaji = pointers + 2 * words;
+    result->word_count = words;
+    result->phoneme_count = phonemes->phoneme_count;
+
+    char* p = (char*)(pointers + 3 * words);
+    size_t n = strlen(phonemes->phonemes) + 1;
+    memcpy(p, phonemes->phonemes, n);
+    result->phonemes = p;
+    p += n;
+    destroy_phoneme_result(phonemes);
+
+    char* reading = p;
+    char* romaji = p + reading_bytes;
+    p = romaji + romaji_bytes;
+    result->reading = reading;
+    result->romaji = romaji;
+
+    int i = 0;
+    for (NJDNode* node = ctx->njd->head; node; node = node->next) {
+        const char* pron = NJDNode_get_pron(node);
+        if (!pron || strcmp(pron, "*") == 0) continue;
+        const char* surface = NJDNode_get_string(node);
+
+        n = surface ? strlen(surface) : 0;
+        memcpy(p, surface ? surface : "", n);
+        p[n] = '\0';
+        result->word_surfaces[i] = p;
+        p += n + 1;
+
+        n = copy_pron(pron, p);
+        memcpy(reading, p, n);
+        reading += n;
+        result->word_readings[i] = p;
+        p += n + 1;
+
+        n = ojtn_kana_to_romaji(pron, p);
+        /* No space before punctuation */
+        if (n > 0 && romaji != result->romaji && !strchr(",.?!", p[0])) *romaji++ = ' ';
+        memcpy(romaji, p, n);
+        romaji += n;
+        result->word_romaji[i] = p;
+        p += n + 1;
+        i++;
+    }
+    *reading = '\0';
+    *romaji = '\0';
+
+    return result;
+}
+
+OpenJTalkNativeReadingResult* openjtalk_native_phonemize_with_reading(void* handle, const char* text) {
+    if (!handle || !text) return NULL;
+
+    OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
+    uint64_t start = ojtn_now_ns();
+
+    OpenJTalkNativeReadingResult* result = NULL;
+    if (run_frontend(ctx, text, true)) {
+        result = labels_to_reading(ctx, JPCommon_get_label_feature(ctx->jpcommon), JPCommon_get_label_size(ctx->jpcommon));
+        if (result) {
+            account_result(ctx, reading_result_bytes(result));
+            ctx->last_error = OPENJTALK_NATIVE_SUCCESS;
+        } else {
+            ctx->last_error = OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
+        }
+    }
+    record_call(ctx, start, text, result ? result->phoneme_count : -1);
+    return result;
+}
+
+void openjtalk_native_free_reading_result(OpenJTalkNativeReadingResult* result) {
     if (!result) return;
-    if (result->phonemes) free(result->phonemes);
-    if (result->prosody_a1) free(result->prosody_a1);
-    if (result->prosody_a2) free(result->prosody_a2);
-    if (result->prosody_a3) free(result->prosody_a3);
+    ojtn_atomic_add(&result_bytes_outstanding, -(int64_t)reading_result_bytes(result));
+    /* Words and strings share the result allocation */
     free(result);
 }
 
+/* Analysis snapshot: the MeCab output as unprocessed NJD nodes, plus the
+   labels of the last render and the stage mask they were built with.
+   Once njd_stages changes between renders, the NJD nodes as they stood
+   before the first stage that changed are kept too, so switching between
+   two stage sets re-runs only the stages after their shared prefix. */
+typedef struct {
+    NJDNode* nodes;
+    int node_count;
+    NJDNode* resume_nodes;   /* NJD after the stages below resume_stage, or NULL */
+    int resume_count;
+    int resume_stage;        /* Index of the first stage not applied to resume_nodes */
+    int resume_mask;         /* njd_stages bits below resume_stage applied to resume_nodes */
+    uint64_t resume_bytes;
+    char** labels;           /* Pointers followed by the strings, one allocation */
+    int label_size;
+    int label_stages;        /* njd_stages of labels, -1 before the first render */
+    uint64_t label_bytes;
+    uint64_t bytes;          /* Counted in result_bytes_outstanding */
+} OpenJTalkNativeAnalysis;
+
+/* Copy the nodes of njd into a new array */
+static bool copy_njd_nodes(NJD* njd, NJDNode** out, int* out_count, uint64_t* out_bytes) {
+    int count = NJD_get_size(njd);
+    NJDNode* nodes = (NJDNode*)calloc(count > 0 ? count : 1, sizeof(NJDNode));
+    if (!nodes) return false;
+
+    uint64_t bytes = 0;
+    int i = 0;
+    for (NJDNode* node = njd->head; node && i < count; node = node->next, i++) {
+        NJDNode_initialize(&nodes[i]);
+        NJDNode_copy(&nodes[i], node);
+        bytes += ojtn_njd_node_bytes(&nodes[i]);
+    }
+    *out = nodes;
+    *out_count = i;
+    *out_bytes = bytes;
+    return true;
+}
+
+static void free_njd_nodes(NJDNode* nodes, int count) {
+    for (int i = 0; i < count; i++) {
+        NJDNode_clear(&nodes[i]);
+    }
+    free(nodes);
+}
+
+/* Replace ctx->njd with copies of nodes */
+static bool load_njd_nodes(OpenJTalkNativeContext* ctx, NJDNode* nodes, int count) {
+    NJD_clear(ctx->njd);
+    for (int i = 0; i < count; i++) {
+        NJDNode* node = (NJDNode*)calloc(1, sizeof(NJDNode));
+        if (!node) return false;
+        NJDNode_initialize(node);
+        NJDNode_copy(node, &nodes[i]);
+        NJD_push_node(ctx->njd, node);
+    }
+    return true;
+}
+
+void* openjtalk_native_analyze_text(void* handle, const char* text) {
+    if (!handle || !text) return NULL;
+
+    OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
+
+    if (!run_analysis(ctx, text)) return NULL;
+    update_working_set(ctx);
+
+    OpenJTalkNativeAnalysis* analysis = (OpenJTalkNativeAnalysis*)calloc(1, sizeof(OpenJTalkNativeAnalysis));
+    uint64_t node_bytes = 0;
+    if (!analysis || !copy_njd_nodes(ctx->njd, &analysis->nodes, &analysis->node_count, &node_bytes)) {
+        free(analysis);
+        ctx->last_error = OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
+        return NULL;
+    }
+
+    analysis->bytes = sizeof(OpenJTalkNativeAnalysis) + node_bytes;
+    analysis->label_stages = -1;
+    account_result(ctx, analysis->bytes);
+
+    ctx->last_error = OPENJTALK_NATIVE_SUCCESS;
+    return analysis;
+}
+
+/* Make sure analysis holds labels for the handle's current njd_stages,
+   re-running label generation and the stages from the first one that
+   changed if not */
+static bool ensure_labels(OpenJTalkNativeContext* ctx, OpenJTalkNativeAnalysis* analysis) {
+    int stages = ctx->njd_stages;
+    if (analysis->labels && analysis->label_stages == stages) return true;
+
+    /* First stage whose selection differs from the last render; the NJD
+       state in front of it is shared by both stage sets */
+    int split = 0;
+    if (analysis->label_stages >= 0) {
+        int changed = analysis->label_stages ^ stages;
+        while (split < NJD_STAGE_COUNT && !(changed & (1 << split))) split++;
+    }
+
+    /* Start from the kept state if the stages below it still match */
+    int start = 0;
+    bool resumed = analysis->resume_nodes &&
+                   (stages & ((1 << analysis->resume_stage) - 1)) == analysis->resume_mask;
+    if (resumed) start = analysis->resume_stage;
+
+    JPCommon_clear(ctx->jpcommon);
+    /* Snapshot nodes carry no input offsets */
+    if (ctx->alignment) ctx->alignment->text_mapped = false;
+    bool loaded = resumed ? load_njd_nodes(ctx, analysis->resume_nodes, analysis->resume_count)
+                          : load_njd_nodes(ctx, analysis->nodes, analysis->node_count);
+    if (!loaded) {
+        ctx->last_error = OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
+        return false;
+    }
+
+    /* Keep the state at the split for the next switch between these two
+       stage sets. Failing to keep it only costs a longer re-run later. */
+    if (split > start && split < NJD_STAGE_COUNT) {
+        int below = (1 << split) - 1;
+        run_njd_pipeline(ctx, stages & below & ~((1 << start) - 1));
+        NJDNode* kept;
+        int kept_count;
+        uint64_t kept_bytes;
+        if (copy_njd_nodes(ctx->njd, &kept, &kept_count, &kept_bytes)) {
+            free_njd_nodes(analysis->resume_nodes, analysis->resume_count);
+            ojtn_atomic_add(&result_bytes_outstanding, (int64_t)kept_bytes - (int64_t)analysis->resume_bytes);
+            analysis->bytes = analysis->bytes - analysis->resume_bytes + kept_bytes;
+            analysis->resume_nodes = kept;
+            analysis->resume_count = kept_count;
+            analysis->resume_stage = split;
+            analysis->resume_mask = stages & below;
+            analysis->resume_bytes = kept_bytes;
+        }
+        start = split;
+    }
+    make_labels(ctx, stages & ~((1 << start) - 1));
+    update_working_set(ctx);
+
+    int label_size = JPCommon_get_label_size(ctx->jpcommon);
+    char** feature = JPCommon_get_label_feature(ctx->jpcommon);
+    if (label_size < 0 || !feature) label_size = 0;
+
+    size_t bytes = (size_t)label_size * sizeof(char*);
+    for (int i = 0; i < label_size; i++) {
+        if (feature[i]) bytes += strlen(feature[i]) + 1;
+    }
+    char** labels = (char**)malloc(bytes > 0 ? bytes : 1);
+    if (!labels) {
+        ctx->last_error = OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
+        return false;
+    }
+    char* p = (char*)(labels + label_size);
+    for (int i = 0; i < label_size; i++) {
+        if (!feature[i]) {
+            labels[i] = NULL;
+            continue;
+        }
+        size_t n = strlen(feature[i]) + 1;
+        memcpy(p, feature[i], n);
+        labels[i] = p;
+        p += n;
+    }
+
+    free(analysis->labels);
+    ojtn_atomic_add(&result_bytes_outstanding, (int64_t)bytes - (int64_t)analysis->label_bytes);
+    analysis->bytes = analysis->bytes - analysis->label_bytes + bytes;
+    analysis->labels = labels;
+    analysis->label_size = label_size;
+    analysis->label_bytes = bytes;
+    analysis->label_stages = stages;
+    return true;
+}
+
+OpenJTalkNativePhonemeResult* openjtalk_native_render_phonemes(void* handle, void* analysis) {
+    if (!handle || !analysis) return NULL;
+
+    OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
+    OpenJTalkNativeAnalysis* a = (OpenJTalkNativeAnalysis*)analysis;
+
+    if (!ensure_labels(ctx, a)) return NULL;
+    return render_phonemes(ctx, a->labels, a->label_size);
+}
+
+OpenJTalkNativeProsodyResult* openjtalk_native_render_prosody(void* handle, void* analysis) {
+    if (!handle || !analysis) return NULL;
+
+    OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
+    OpenJTalkNativeAnalysis* a = (OpenJTalkNativeAnalysis*)analysis;
+
+    if (!ensure_labels(ctx, a)) return NULL;
+    return render_prosody(ctx, a->labels, a->label_size, NULL);
+}
+
+OpenJTalkNativeLabelResult* openjtalk_native_render_labels(void* handle, void* analysis) {
+    if (!handle || !analysis) return NULL;
+
+    OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
+    OpenJTalkNativeAnalysis* a = (OpenJTalkNativeAnalysis*)analysis;
+
+    if (!ensure_labels(ctx, a)) return NULL;
+    return render_labels(ctx, a->labels, a->label_size);
+}
+
+void openjtalk_native_free_analysis(void* analysis) {
+    if (!analysis) return;
+
+    OpenJTalkNativeAnalysis* a = (OpenJTalkNativeAnalysis*)analysis;
+    ojtn_atomic_add(&result_bytes_outstanding, -(int64_t)a->bytes);
+    free_njd_nodes(a->nodes, a->node_count);
+    free_njd_nodes(a->resume_nodes, a->resume_count);
+    free(a->labels);
+    free(a);
+}
+
+/* Sentences run by OPENJTALK_NATIVE_WARMUP_PIPELINE: everyday kana and
+   kanji, verb and adjective conjugations, a question, numbers that take the
+   normalizer paths, Latin letters and punctuation */
+static const char* const warmup_sentences[] = {
+    "こんにちは",
+    "今日はいい天気ですね",
+    "明日の会議は午後から始まる予定です",
+    "東京駅から新幹線に乗って大阪へ向かいました",
+    "この本はとても面白かったので、友達にも勧めたいと思います",
+    "すみません、駅までの道を教えていただけますか？",
+    "寒くなってきたので、暖かくしてお過ごしください",
+    "ソフトウェアのアップデートが完了しました",
+    "会議は2024/03/15の10:30からです",
+    "合計金額は1,234,567円になります",
+    "本日の最高気温は32℃、湿度は78%でした",
+    "お問い合わせは03-1234-5678までお願いします",
+    "AIとIoTを活用したDXを推進しています",
+    "えっ！本当に？",
+    "ありがとうございました。"
+};
+
+/* Run one text through every stage and output path; results are dropped */
+static int warmup_text(OpenJTalkNativeContext* ctx, const char* text) {
+    if (!run_frontend(ctx, text, true)) return ctx->last_error;
+
+    char** labels = JPCommon_get_label_feature(ctx->jpcommon);
+    int label_size = JPCommon_get_label_size(ctx->jpcommon);
+    OpenJTalkNativePhonemeResult* phonemes = labels_to_phonemes(ctx, labels, label_size);
+    OpenJTalkNativeProsodyResult* prosody = labels_to_phonemes_with_prosody(ctx, labels, label_size, NULL);
+    int error = phonemes && prosody ? OPENJTALK_NATIVE_SUCCESS : OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
+    destroy_phoneme_result(phonemes);
+    ojtn_destroy_prosody_result(prosody);
+    return error;
+}
+
+int openjtalk_native_warmup(void* handle, int level, const char* const* texts, int text_count) {
+    if (!handle) return OPENJTALK_NATIVE_ERROR_INVALID_HANDLE;
+
+    OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
+    if (level < OPENJTALK_NATIVE_WARMUP_NONE || level > OPENJTALK_NATIVE_WARMUP_PIPELINE ||
+        text_count < 0 || (text_count > 0 && !texts)) {
+        ctx->last_error = OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+        return ctx->last_error;
+    }
+
+    if (level >= OPENJTALK_NATIVE_WARMUP_DICTIONARY) {
+        uint64_t bytes = ojtn_dictionary_prefault(ctx->dictionary);
+        DEBUG_LOG("Warm-up read %llu dictionary bytes", (unsigned long long)bytes);
+        (void)bytes;
+    }
+
+    /* The built-in set must succeed; caller texts are best effort and the
+       last failure is reported after the whole list has run */
+    int error = OPENJTALK_NATIVE_SUCCESS;
+    if (level >= OPENJTALK_NATIVE_WARMUP_PIPELINE) {
+        for (size_t i = 0; i < sizeof(warmup_sentences) / sizeof(warmup_sentences[0]); i++) {
+            int rc = warmup_text(ctx, warmup_sentences[i]);
+            if (rc != OPENJTALK_NATIVE_SUCCESS) {
+                ctx->last_error = rc;
+                return rc;
+            }
+        }
+    }
+    for (int i = 0; i < text_count; i++) {
+        if (!texts[i]) {
+            error = OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+            continue;
+        }
+        int rc = warmup_text(ctx, texts[i]);
+        if (rc != OPENJTALK_NATIVE_SUCCESS) error = rc;
+    }
+
+    ctx->last_error = error;
+    return error;
+}
+
+size_t openjtalk_native_render_metrics(void* handle, char* buffer, size_t capacity) {
+    if (!handle) return 0;
+
+    OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
+    OpenJTalkNativeMetrics snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    ojtn_metrics_merge(&snapshot, &ctx->metrics);
+    return ojtn_metrics_render(&snapshot, NULL, ctx->dictionary, buffer, capacity);
+}
+
+int openjtalk_native_get_memory_stats(void* handle, OpenJTalkNativeMemoryStats* stats) {
+    if (!stats) return OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+
+    memset(stats, 0, sizeof(OpenJTalkNativeMemoryStats));
+    stats->result_bytes_outstanding = (uint64_t)ojtn_atomic_load(&result_bytes_outstanding);
+
+    if (!handle) {
+        ojtn_dictionary_memory_total(&stats->dictionary_shared_bytes, &stats->dictionary_private_bytes);
+        return OPENJTALK_NATIVE_SUCCESS;
+    }
+
+    OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
+    ojtn_dictionary_memory(ctx->dictionary, &stats->dictionary_shared_bytes, &stats->dictionary_private_bytes);
+    stats->context_bytes = sizeof(OpenJTalkNativeContext) + sizeof(Mecab) + sizeof(NJD) + sizeof(JPCommon) +
+        strlen(ctx->dict_path) + 1 + ctx->working_set_bytes +
+        (uint64_t)ctx->row_capacity * (sizeof(const char*) + 2 * sizeof(int) + OPENJTALK_NATIVE_LABEL_FIELD_COUNT * sizeof(int16_t));
+    if (ctx->alignment) {
+        const OpenJTalkNativeAlignment* a = ctx->alignment;
+        stats->context_bytes += sizeof(OpenJTalkNativeAlignment) +
+            ((uint64_t)a->node_capacity + (uint64_t)a->row_capacity) * 2 * sizeof(int);
+    }
+    stats->peak_call_bytes = ctx->peak_call_bytes;
+    stats->lattice_retained_input_bytes = ctx->lattice_retained_bytes;
+    stats->lattice_peak_input_bytes = ctx->lattice_peak_bytes;
+    stats->lattice_trim_count = ctx->lattice_trims;
+    return OPENJTALK_NATIVE_SUCCESS;
+}
+
 int openjtalk_native_get_last_error(void* handle) {
     if (!handle) return OPENJTALK_NATIVE_ERROR_INVALID_HANDLE;
     OpenJTalkNativeContext* ctx = (OpenJTalkNativeContext*)handle;
@@ -481,6 +1579,7 @@ const char* openjtalk_native_get_error_string(int error_code) {
         case OPENJTALK_NATIVE_ERROR_INVALID_OPTION:       return "Invalid option";
         case OPENJTALK_NATIVE_ERROR_INVALID_DICTIONARY:   return "Invalid dictionary";
         case OPENJTALK_NATIVE_ERROR_INVALID_UTF8:         return "Invalid UTF-8";
+        case OPENJTALK_NATIVE_ERROR_CONNECTION:           return "Server connection failed";
         default:                                          return "Unknown error";
     }
 }
@@ -514,6 +1613,61 @@ int openjtalk_native_set_option(void* handle, const char* key, const char* value
         }
         return OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
     }
+    else if (strcmp(key, "word_cache") == 0) {
+        if (strcmp(value, "1") == 0 || strcmp(value, "0") == 0) {
+            ctx->use_word_cache = (value[0] == '1');
+            return OPENJTALK_NATIVE_SUCCESS;
+        }
+        return OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+    }
+    else if (strcmp(key, "normalize_numbers") == 0) {
+        if (strcmp(value, "1") == 0 || strcmp(value, "0") == 0) {
+            ctx->normalize_numbers = (value[0] == '1');
+            return OPENJTALK_NATIVE_SUCCESS;
+        }
+        return OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+    }
+    else if (strcmp(key, "latin_mode") == 0) {
+        if (strcmp(value, "keep") == 0) ctx->latin_mode = OJTN_LATIN_KEEP;
+        else if (strcmp(value, "spell") == 0) ctx->latin_mode = OJTN_LATIN_SPELL;
+        else if (strcmp(value, "skip") == 0) ctx->latin_mode = OJTN_LATIN_SKIP;
+        else return OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+        return OPENJTALK_NATIVE_SUCCESS;
+    }
+    else if (strcmp(key, "alignment") == 0) {
+        if (strcmp(value, "1") != 0 && strcmp(value, "0") != 0) return OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+        if (value[0] == '1' && !ctx->alignment) {
+            ctx->alignment = (OpenJTalkNativeAlignment*)calloc(1, sizeof(OpenJTalkNativeAlignment));
+            if (!ctx->alignment) return OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
+        } else if (value[0] == '0') {
+            ojtn_alignment_destroy(ctx->alignment);
+            ctx->alignment = NULL;
+        }
+        return OPENJTALK_NATIVE_SUCCESS;
+    }
+    else if (strcmp(key, "lattice_trim_bytes") == 0) {
+        char* end;
+        long bytes = strtol(value, &end, 10);
+        if (end == value || *end || bytes < 0 || bytes > 65536) return OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+        ctx->lattice_trim_bytes = (size_t)bytes;
+        return OPENJTALK_NATIVE_SUCCESS;
+    }
+    else if (strcmp(key, "njd_stages") == 0) {
+        int stages;
+        char* end;
+        if (strcmp(value, "full") == 0) stages = OPENJTALK_NATIVE_STAGES_FULL;
+        else if (strcmp(value, "phonemes") == 0) stages = OPENJTALK_NATIVE_STAGES_PHONEMES;
+        else if (strcmp(value, "reading") == 0) stages = OPENJTALK_NATIVE_STAGES_READING;
+        else {
+            long mask = strtol(value, &end, 10);
+            if (end == value || *end || mask < 0 || mask > OPENJTALK_NATIVE_STAGES_FULL) {
+                return OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+            }
+            stages = (int)mask;
+        }
+        ctx->njd_stages = stages;
+        return OPENJTALK_NATIVE_SUCCESS;
+    }
 
     return OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
 }
@@ -535,6 +1689,31 @@ const char* openjtalk_native_get_option(void* handle, const char* key) {
         snprintf(ctx->option_buffer, sizeof(ctx->option_buffer), "%.2f", ctx->volume);
         return ctx->option_buffer;
     }
+    else if (strcmp(key, "word_cache") == 0) {
+        snprintf(ctx->option_buffer, sizeof(ctx->option_buffer), "%d", ctx->use_word_cache ? 1 : 0);
+        return ctx->option_buffer;
+    }
+    else if (strcmp(key, "normalize_numbers") == 0) {
+        snprintf(ctx->option_buffer, sizeof(ctx->option_buffer), "%d", ctx->normalize_numbers ? 1 : 0);
+        return ctx->option_buffer;
+    }
+    else if (strcmp(key, "latin_mode") == 0) {
+        static const char* const modes[] = { "keep", "spell", "skip" };
+        snprintf(ctx->option_buffer, sizeof(ctx->option_buffer), "%s", modes[ctx->latin_mode]);
+        return ctx->option_buffer;
+    }
+    else if (strcmp(key, "njd_stages") == 0) {
+        snprintf(ctx->option_buffer, sizeof(ctx->option_buffer), "%d", ctx->njd_stages);
+        return ctx->option_buffer;
+    }
+    else if (strcmp(key, "alignment") == 0) {
+        snprintf(ctx->option_buffer, sizeof(ctx->option_buffer), "%d", ctx->alignment ? 1 : 0);
+        return ctx->option_buffer;
+    }
+    else if (strcmp(key, "lattice_trim_bytes") == 0) {
+        snprintf(ctx->option_buffer, sizeof(ctx->option_buffer), "%lu", (unsigned long)ctx->lattice_trim_bytes);
+        return ctx->option_buffer;
+    }
 
     return NULL;
 }
@@ -575,6 +1754,7 @@ char* openjtalk_native_analyze_utf8(void* handle, const unsigned char* text_utf8
 
     char* result = strdup(phoneme_result->phonemes);
     openjtalk_native_free_result(phoneme_result);
+    if (result) ojtn_atomic_add(&result_bytes_outstanding, (int64_t)(strlen(result) + 1));
     return result;
 }
 
@@ -584,11 +1764,14 @@ char* openjtalk_native_analyze(void* handle, const char* text) {
 
     char* result = strdup(phoneme_result->phonemes);
     openjtalk_native_free_result(phoneme_result);
+    if (result) ojtn_atomic_add(&result_bytes_outstanding, (int64_t)(strlen(result) + 1));
     return result;
 }
 
 void openjtalk_native_free_string(char* result) {
-    if (result) free(result);
+    if (!result) return;
+    ojtn_atomic_add(&result_bytes_outstanding, -(int64_t)(strlen(result) + 1));
+    free(result);
 }
 
 void openjtalk_native_finalize(void* handle) {
@@ -0,0 +1,247 @@
+#include "openjtalk_native_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#include <text2mecab.h>
+
+/* Input offsets for phonemes, carried through each frontend step in turn:
+
+     input -> normalizer output     recorded by ojtn_normalize_text()
+     -> text2mecab output           replaying the conversion per character
+     -> NJD nodes                   finding node strings in the MeCab input
+     -> phonemes                    pushing the words into the label one at
+                                    a time, as JPCommon_make_label() does
+
+   Nodes whose string no longer appears in the MeCab input (numbers read out
+   by njd_set_digit) share the span between their neighbours, and pauses
+   cover the gap between the words around them. */
+
+/* Bytes in the UTF-8 sequence led by c */
+static size_t utf8_length(unsigned char c) {
+    if (c >= 0xF0) return 4;
+    if (c >= 0xE0) return 3;
+    if (c >= 0xC0) return 2;
+    return 1;
+}
+
+/* text2mecab on len bytes of s; one or two characters fit easily */
+static void convert(const char* s, size_t len, char* out) {
+    char in[16];
+    memcpy(in, s, len);
+    in[len] = '\0';
+    text2mecab(out, in);
+}
+
+/* Input span of text2mecab input bytes [from, from + len) */
+static void input_span(const OpenJTalkNativeAlignment* a, bool normalized, size_t from, size_t len,
+                       int* start, int* end) {
+    if (!normalized) {
+        *start = (int)from;
+        *end = (int)(from + len);
+        return;
+    }
+    *start = a->normalized_source[2 * from];
+    *end = a->normalized_source[2 * from + 1];
+    for (size_t i = from + 1; i < from + len; i++) {
+        if (a->normalized_source[2 * i] < *start) *start = a->normalized_source[2 * i];
+        if (a->normalized_source[2 * i + 1] > *end) *end = a->normalized_source[2 * i + 1];
+    }
+}
+
+void ojtn_alignment_map_input(OpenJTalkNativeAlignment* a, const char* text, bool normalized,
+                              size_t input_length, const char* mecab_text) {
+    size_t mecab_length = strlen(mecab_text);
+    memcpy(a->mecab_text, mecab_text, mecab_length + 1);
+    a->text_length = (int)input_length;
+    a->text_mapped = true;
+    a->rows_valid = false;
+
+    size_t text_length = strlen(text);
+    size_t i = 0, m = 0;
+    char single[64], pair[64];
+
+    while (i < text_length) {
+        size_t n = utf8_length((unsigned char)text[i]);
+        if (n > text_length - i) n = text_length - i;
+        convert(text + i, n, single);
+
+        /* text2mecab merges some pairs (half-width kana with a sound mark) */
+        const char* out = single;
+        size_t consumed = n;
+        if (i + n < text_length) {
+            size_t n2 = utf8_length((unsigned char)text[i + n]);
+            if (n2 > text_length - i - n) n2 = text_length - i - n;
+            convert(text + i, n + n2, pair);
+            if (strncmp(pair, single, strlen(single)) != 0) {
+                out = pair;
+                consumed = n + n2;
+            }
+        }
+
+        size_t out_length = strlen(out);
+        if (out_length > mecab_length - m || memcmp(mecab_text + m, out, out_length) != 0) break;
+
+        int start, end;
+        input_span(a, normalized, i, consumed, &start, &end);
+        for (size_t k = 0; k < out_length; k++) {
+            a->mecab_start[m + k] = start;
+            a->mecab_end[m + k] = end;
+        }
+        m += out_length;
+        i += consumed;
+    }
+
+    if (i < text_length || m != mecab_length) {
+        /* The conversion could not be replayed; fall back to the whole input */
+        for (size_t k = 0; k < mecab_length; k++) {
+            a->mecab_start[k] = 0;
+            a->mecab_end[k] = (int)input_length;
+        }
+    }
+}
+
+static bool reserve(int** start, int** end, int* capacity, int count) {
+    if (count <= *capacity) return true;
+    int n = *capacity > 0 ? *capacity : 64;
+    while (n < count) n *= 2;
+
+    int* s = (int*)realloc(*start, (size_t)n * sizeof(int));
+    if (!s) return false;
+    *start = s;
+    int* e = (int*)realloc(*end, (size_t)n * sizeof(int));
+    if (!e) return false;
+    *end = e;
+    *capacity = n;
+    return true;
+}
+
+/* Input span of every NJD node, in node order */
+static bool map_nodes(OpenJTalkNativeAlignment* a, NJD* njd, int count) {
+    if (!reserve(&a->node_start, &a->node_end, &a->node_capacity, count)) return false;
+
+    size_t cursor = 0;
+    int i = 0;
+    for (NJDNode* node = njd->head; node && i < count; node = node->next, i++) {
+        const char* string = NJDNode_get_string(node);
+        const char* found = (string && *string) ? strstr(a->mecab_text + cursor, string) : NULL;
+        if (!found) {
+            a->node_start[i] = -1;
+            continue;
+        }
+
+        size_t from = (size_t)(found - a->mecab_text);
+        size_t to = from + strlen(string);
+        int start = a->mecab_start[from], end = a->mecab_end[from];
+        for (size_t k = from + 1; k < to; k++) {
+            if (a->mecab_start[k] < start) start = a->mecab_start[k];
+            if (a->mecab_end[k] > end) end = a->mecab_end[k];
+        }
+        a->node_start[i] = start;
+        a->node_end[i] = end;
+        cursor = to;
+    }
+
+    /* Nodes that were not found share the gap between their neighbours */
+    int previous_end = 0;
+    i = 0;
+    while (i < count) {
+        if (a->node_start[i] >= 0) {
+            previous_end = a->node_end[i++];
+            continue;
+        }
+        int next = i + 1;
+        while (next < count && a->node_start[next] < 0) next++;
+        int gap_end = next < count ? a->node_start[next] : a->text_length;
+        int start = gap_end < previous_end ? gap_end : previous_end;
+        int end = gap_end > previous_end ? gap_end : previous_end;
+        for (; i < next; i++) {
+            a->node_start[i] = start;
+            a->node_end[i] = end;
+        }
+    }
+    return true;
+}
+
+/* Pauses and the utterance-edge silences take the gap between the phonemes
+   around them. rows[0] and rows[last] are the edge silences. */
+static void fill_pauses(OpenJTalkNativeAlignment* a, int last) {
+    int first = 1;
+    while (first < last && a->row_start[first] < 0) first++;
+    a->row_start[0] = 0;
+    a->row_end[0] = first < last ? a->row_start[first] : a->text_length;
+
+    int previous_end = 0;
+    for (int r = 1; r < last; r++) {
+        if (a->row_start[r] >= 0) {
+            previous_end = a->row_end[r];
+            continue;
+        }
+        int next = r + 1;
+        while (next < last && a->row_start[next] < 0) next++;
+        int gap_end = next < last ? a->row_start[next] : a->text_length;
+        /* Inside one rewritten span the words overlap; take the overlap */
+        a->row_start[r] = gap_end < previous_end ? gap_end : previous_end;
+        a->row_end[r] = gap_end > previous_end ? gap_end : previous_end;
+    }
+
+    a->row_start[last] = previous_end;
+    a->row_end[last] = a->text_length > previous_end ? a->text_length : previous_end;
+}
+
+void ojtn_alignment_make_labels(OpenJTalkNativeAlignment* a, NJD* njd, JPCommon* jpcommon) {
+    bool aligned = a->text_mapped;
+    a->text_mapped = false;
+    a->rows_valid = false;
+
+    if (jpcommon->label) {
+        JPCommonLabel_clear(jpcommon->label);
+        free(jpcommon->label);
+    }
+    JPCommonLabel* label = (JPCommonLabel*)malloc(sizeof(JPCommonLabel));
+    jpcommon->label = label;
+    if (!label) return;
+    JPCommonLabel_initialize(label);
+
+    /* njd2jpcommon() makes one word per NJD node */
+    int word_count = 0;
+    for (JPCommonNode* node = jpcommon->head; node; node = (JPCommonNode*)node->next) word_count++;
+    aligned = aligned && word_count == NJD_get_size(njd) && map_nodes(a, njd, word_count);
+
+    int rows = 1;
+    int word = 0;
+    for (JPCommonNode* node = jpcommon->head; node; node = (JPCommonNode*)node->next, word++) {
+        JPCommonLabelPhoneme* tail = label->phoneme_tail;
+        JPCommonLabel_push_word(label, JPCommonNode_get_pron(node), JPCommonNode_get_pos(node),
+                                JPCommonNode_get_ctype(node), JPCommonNode_get_cform(node),
+                                JPCommonNode_get_acc(node), JPCommonNode_get_chain_flag(node));
+        if (!aligned) continue;
+
+        /* Phonemes appended by this word; a pause inserted before it belongs to neither word */
+        for (JPCommonLabelPhoneme* p = tail ? tail->next : label->phoneme_head; p; p = p->next) {
+            if (!reserve(&a->row_start, &a->row_end, &a->row_capacity, rows + 2)) {
+                aligned = false;
+                break;
+            }
+            bool pause = strcmp(p->phoneme, "pau") == 0;
+            a->row_start[rows] = pause ? -1 : a->node_start[word];
+            a->row_end[rows] = pause ? -1 : a->node_end[word];
+            rows++;
+        }
+    }
+    JPCommonLabel_make(label);
+
+    /* One row per phoneme between the two edge silences */
+    if (!aligned || label->size != rows + 1) return;
+    fill_pauses(a, rows);
+    a->row_count = rows + 1;
+    a->rows_valid = true;
+}
+
+void ojtn_alignment_destroy(OpenJTalkNativeAlignment* a) {
+    if (!a) return;
+    free(a->node_start);
+    free(a->node_end);
+    free(a->row_start);
+    free(a->row_end);
+    free(a);
+}
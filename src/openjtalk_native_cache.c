@@ -0,0 +1,316 @@
+#include "openjtalk_native_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define strdup _strdup
+#endif
+
+#define WORD_CACHE_INITIAL_CAPACITY 1024
+#define PREFAULT_CHUNK_BYTES (256 * 1024)
+
+/* Files MeCab maps from the dictionary directory */
+static const char* const dictionary_files[] = { "sys.dic", "matrix.bin", "char.bin", "unk.dic" };
+
+/* Process-wide list of loaded dictionaries, keyed by dictionary path */
+static ojtn_mutex_t registry_lock = OJTN_MUTEX_INITIALIZER;
+static OpenJTalkNativeDictionary* registry_head = NULL;
+
+/* FNV-1a over the full feature line (surface + all CSV fields) */
+static uint32_t hash_feature(const char* str) {
+    uint32_t h = 2166136261u;
+    while (*str) {
+        h ^= (unsigned char)*str++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static size_t string_bytes(const char* str) {
+    return str ? strlen(str) + 1 : 0;
+}
+
+size_t ojtn_njd_node_bytes(const NJDNode* node) {
+    return sizeof(NJDNode) +
+        string_bytes(node->string) + string_bytes(node->pos) +
+        string_bytes(node->pos_group1) + string_bytes(node->pos_group2) + string_bytes(node->pos_group3) +
+        string_bytes(node->ctype) + string_bytes(node->cform) + string_bytes(node->orig) +
+        string_bytes(node->read) + string_bytes(node->pron) + string_bytes(node->chain_rule);
+}
+
+static size_t entry_bytes(const OpenJTalkNativeWordCacheEntry* entry) {
+    size_t bytes = sizeof(OpenJTalkNativeWordCacheEntry) + strlen(entry->key) + 1;
+    for (int i = 0; i < entry->node_count; i++) {
+        bytes += ojtn_njd_node_bytes(&entry->nodes[i]);
+    }
+    return bytes;
+}
+
+static uint64_t dictionary_mapped_bytes(const char* dict_path) {
+    uint64_t total = 0;
+    char path[4096];
+    for (size_t i = 0; i < sizeof(dictionary_files) / sizeof(dictionary_files[0]); i++) {
+        struct stat st;
+        snprintf(path, sizeof(path), "%s/%s", dict_path, dictionary_files[i]);
+        if (stat(path, &st) == 0) total += (uint64_t)st.st_size;
+    }
+    return total;
+}
+
+static void free_entry(OpenJTalkNativeWordCacheEntry* entry) {
+    if (!entry) return;
+    for (int i = 0; i < entry->node_count; i++) {
+        NJDNode_clear(&entry->nodes[i]);
+    }
+    free(entry->nodes);
+    free(entry);
+}
+
+static void word_cache_init(OpenJTalkNativeWordCache* cache) {
+    memset(cache, 0, sizeof(*cache));
+    ojtn_rwlock_init(&cache->lock);
+}
+
+static void word_cache_clear(OpenJTalkNativeWordCache* cache) {
+    for (size_t i = 0; i < cache->capacity; i++) {
+        free_entry(cache->slots[i]);
+    }
+    free(cache->slots);
+    ojtn_rwlock_destroy(&cache->lock);
+    memset(cache, 0, sizeof(*cache));
+}
+
+/* Returns the slot holding the key, or the empty slot where it belongs */
+static size_t find_slot(OpenJTalkNativeWordCacheEntry** slots, size_t capacity,
+                        uint32_t hash, const char* key) {
+    size_t mask = capacity - 1;
+    size_t i = hash & mask;
+    while (slots[i]) {
+        if (slots[i]->hash == hash && strcmp(slots[i]->key, key) == 0) break;
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+/* Double the table; caller holds the write lock */
+static bool word_cache_grow(OpenJTalkNativeWordCache* cache) {
+    size_t new_capacity = cache->capacity ? cache->capacity * 2 : WORD_CACHE_INITIAL_CAPACITY;
+    OpenJTalkNativeWordCacheEntry** new_slots =
+        (OpenJTalkNativeWordCacheEntry**)calloc(new_capacity, sizeof(OpenJTalkNativeWordCacheEntry*));
+    if (!new_slots) return false;
+
+    for (size_t i = 0; i < cache->capacity; i++) {
+        OpenJTalkNativeWordCacheEntry* entry = cache->slots[i];
+        if (entry) {
+            new_slots[find_slot(new_slots, new_capacity, entry->hash, entry->key)] = entry;
+        }
+    }
+    free(cache->slots);
+    cache->bytes += (new_capacity - cache->capacity) * sizeof(OpenJTalkNativeWordCacheEntry*);
+    cache->slots = new_slots;
+    cache->capacity = new_capacity;
+    return true;
+}
+
+bool ojtn_word_cache_lookup(OpenJTalkNativeWordCache* cache, const char* feature, NJD* njd) {
+    uint32_t hash = hash_feature(feature);
+    bool found = false;
+
+    ojtn_rwlock_rdlock(&cache->lock);
+    if (cache->capacity > 0) {
+        OpenJTalkNativeWordCacheEntry* entry = cache->slots[find_slot(cache->slots, cache->capacity, hash, feature)];
+        if (entry) {
+            /* Chain the copies first so a failed allocation leaves the NJD
+               untouched and the caller falls back to NJDNode_load */
+            NJDNode* first = NULL;
+            NJDNode* last = NULL;
+            found = true;
+            for (int i = 0; i < entry->node_count; i++) {
+                NJDNode* node = (NJDNode*)calloc(1, sizeof(NJDNode));
+                if (!node) {
+                    found = false;
+                    break;
+                }
+                NJDNode_initialize(node);
+                NJDNode_copy(node, &entry->nodes[i]);
+                if (last) {
+                    last->next = node;
+                    node->prev = last;
+                } else {
+                    first = node;
+                }
+                last = node;
+            }
+            if (found) {
+                NJD_push_node(njd, first);
+            } else {
+                while (first) {
+                    NJDNode* next = first->next;
+                    NJDNode_clear(first);
+                    free(first);
+                    first = next;
+                }
+            }
+        }
+    }
+    ojtn_rwlock_rdunlock(&cache->lock);
+
+    ojtn_atomic_add(found ? &cache->hits : &cache->misses, 1);
+    return found;
+}
+
+void ojtn_word_cache_insert(OpenJTalkNativeWordCache* cache, const char* feature, NJDNode* first) {
+    int node_count = 0;
+    for (NJDNode* node = first; node; node = node->next) node_count++;
+    if (node_count == 0) return;
+
+    /* Build the entry outside the lock; NJDNode_copy deep-copies every field */
+    size_t key_len = strlen(feature);
+    OpenJTalkNativeWordCacheEntry* entry =
+        (OpenJTalkNativeWordCacheEntry*)malloc(sizeof(OpenJTalkNativeWordCacheEntry) + key_len + 1);
+    if (!entry) return;
+    entry->nodes = (NJDNode*)calloc(node_count, sizeof(NJDNode));
+    if (!entry->nodes) {
+        free(entry);
+        return;
+    }
+    entry->hash = hash_feature(feature);
+    entry->node_count = node_count;
+    memcpy(entry->key, feature, key_len + 1);
+
+    NJDNode* src = first;
+    for (int i = 0; i < node_count; i++, src = src->next) {
+        NJDNode_initialize(&entry->nodes[i]);
+        NJDNode_copy(&entry->nodes[i], src);
+        entry->nodes[i].prev = NULL;
+        entry->nodes[i].next = NULL;
+    }
+
+    ojtn_rwlock_wrlock(&cache->lock);
+    if (cache->count >= WORD_CACHE_MAX_ENTRIES ||
+        ((cache->count + 1) * 2 > cache->capacity && !word_cache_grow(cache))) {
+        ojtn_rwlock_wrunlock(&cache->lock);
+        free_entry(entry);
+        return;
+    }
+    size_t slot = find_slot(cache->slots, cache->capacity, entry->hash, entry->key);
+    if (cache->slots[slot]) {
+        /* Another handle inserted the same morpheme first */
+        ojtn_rwlock_wrunlock(&cache->lock);
+        free_entry(entry);
+        return;
+    }
+    cache->slots[slot] = entry;
+    cache->count++;
+    cache->bytes += entry_bytes(entry);
+    ojtn_rwlock_wrunlock(&cache->lock);
+}
+
+OpenJTalkNativeDictionary* ojtn_dictionary_acquire(const char* dict_path) {
+    ojtn_mutex_lock(&registry_lock);
+
+    OpenJTalkNativeDictionary* dict = registry_head;
+    while (dict && strcmp(dict->dict_path, dict_path) != 0) {
+        dict = dict->next;
+    }
+
+    if (dict) {
+        dict->refcount++;
+    } else {
+        dict = (OpenJTalkNativeDictionary*)calloc(1, sizeof(OpenJTalkNativeDictionary));
+        if (dict) {
+            dict->dict_path = strdup(dict_path);
+            if (!dict->dict_path) {
+                free(dict);
+                dict = NULL;
+            } else {
+                dict->refcount = 1;
+                dict->mapped_bytes = dictionary_mapped_bytes(dict_path);
+                word_cache_init(&dict->word_cache);
+                dict->next = registry_head;
+                registry_head = dict;
+            }
+        }
+    }
+
+    ojtn_mutex_unlock(&registry_lock);
+    return dict;
+}
+
+void ojtn_dictionary_release(OpenJTalkNativeDictionary* dict) {
+    if (!dict) return;
+
+    ojtn_mutex_lock(&registry_lock);
+    if (--dict->refcount > 0) {
+        ojtn_mutex_unlock(&registry_lock);
+        return;
+    }
+
+    OpenJTalkNativeDictionary** link = &registry_head;
+    while (*link && *link != dict) {
+        link = &(*link)->next;
+    }
+    if (*link) *link = dict->next;
+    ojtn_mutex_unlock(&registry_lock);
+
+    word_cache_clear(&dict->word_cache);
+    free(dict->dict_path);
+    free(dict);
+}
+
+void ojtn_word_cache_stats(OpenJTalkNativeWordCache* cache, OpenJTalkNativeWordCacheStats* stats) {
+    stats->hits = ojtn_atomic_load(&cache->hits);
+    stats->misses = ojtn_atomic_load(&cache->misses);
+    ojtn_rwlock_rdlock(&cache->lock);
+    stats->entries = cache->count;
+    stats->bytes = cache->bytes;
+    ojtn_rwlock_rdunlock(&cache->lock);
+}
+
+uint64_t ojtn_dictionary_prefault(OpenJTalkNativeDictionary* dict) {
+    /* Reading each file once pulls it into the page cache, so the first
+       lookups in MeCab's own read-only mappings become minor faults
+       instead of disk reads. Only the first caller per dictionary reads. */
+    if (ojtn_atomic_add(&dict->prefaulted, 1) != 1) return 0;
+
+    char* chunk = (char*)malloc(PREFAULT_CHUNK_BYTES);
+    if (!chunk) return 0;
+
+    uint64_t total = 0;
+    char path[4096];
+    for (size_t i = 0; i < sizeof(dictionary_files) / sizeof(dictionary_files[0]); i++) {
+        snprintf(path, sizeof(path), "%s/%s", dict->dict_path, dictionary_files[i]);
+        FILE* f = fopen(path, "rb");
+        if (!f) continue;
+        size_t n;
+        while ((n = fread(chunk, 1, PREFAULT_CHUNK_BYTES, f)) > 0) {
+            total += n;
+        }
+        fclose(f);
+    }
+    free(chunk);
+    return total;
+}
+
+void ojtn_dictionary_memory(OpenJTalkNativeDictionary* dict, uint64_t* shared_bytes, uint64_t* private_bytes) {
+    *shared_bytes = dict->mapped_bytes;
+    ojtn_rwlock_rdlock(&dict->word_cache.lock);
+    *private_bytes = sizeof(OpenJTalkNativeDictionary) + dict->word_cache.bytes;
+    ojtn_rwlock_rdunlock(&dict->word_cache.lock);
+}
+
+void ojtn_dictionary_memory_total(uint64_t* shared_bytes, uint64_t* private_bytes) {
+    *shared_bytes = 0;
+    *private_bytes = 0;
+
+    ojtn_mutex_lock(&registry_lock);
+    for (OpenJTalkNativeDictionary* dict = registry_head; dict; dict = dict->next) {
+        uint64_t shared, priv;
+        ojtn_dictionary_memory(dict, &shared, &priv);
+        *shared_bytes += shared;
+        *private_bytes += priv;
+    }
+    ojtn_mutex_unlock(&registry_lock);
+}
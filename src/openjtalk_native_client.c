@@ -0,0 +1,308 @@
+#include "openjtalk_native.h"
+#include "openjtalk_native_internal.h"
+#include "openjtalk_native_protocol.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/* Synchronous connection to openjtalk_native_server; one request in flight */
+typedef struct {
+    int fd;
+    uint32_t next_request_id;
+    int last_error;
+} OpenJTalkNativeClient;
+
+#ifdef _WIN32
+
+/* The server listens on a Unix domain socket; not supported on Windows */
+void* openjtalk_native_client_connect(const char* socket_path) {
+    (void)socket_path;
+    return NULL;
+}
+
+void openjtalk_native_client_close(void* client) {
+    (void)client;
+}
+
+int openjtalk_native_client_get_last_error(void* client) {
+    (void)client;
+    return OPENJTALK_NATIVE_ERROR_INVALID_HANDLE;
+}
+
+OpenJTalkNativePhonemeResult* openjtalk_native_client_phonemize(void* client, const char* text) {
+    (void)client;
+    (void)text;
+    return NULL;
+}
+
+OpenJTalkNativeProsodyResult* openjtalk_native_client_phonemize_with_prosody(void* client, const char* text) {
+    (void)client;
+    (void)text;
+    return NULL;
+}
+
+#else
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0   /* SO_NOSIGPIPE is set on the socket instead */
+#endif
+
+static int send_all(int fd, const unsigned char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static int recv_all(int fd, unsigned char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = recv(fd, data, len, 0);
+        if (n == 0) return -1;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+void* openjtalk_native_client_connect(const char* socket_path) {
+    if (!socket_path) return NULL;
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) return NULL;
+    strcpy(addr.sun_path, socket_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return NULL;
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    OpenJTalkNativeClient* client = (OpenJTalkNativeClient*)calloc(1, sizeof(OpenJTalkNativeClient));
+    if (!client) {
+        close(fd);
+        return NULL;
+    }
+    client->fd = fd;
+    client->next_request_id = 1;
+    return client;
+}
+
+void openjtalk_native_client_close(void* handle) {
+    if (!handle) return;
+    OpenJTalkNativeClient* client = (OpenJTalkNativeClient*)handle;
+    close(client->fd);
+    free(client);
+}
+
+int openjtalk_native_client_get_last_error(void* handle) {
+    if (!handle) return OPENJTALK_NATIVE_ERROR_INVALID_HANDLE;
+    return ((OpenJTalkNativeClient*)handle)->last_error;
+}
+
+/* Send one request and read its response payload. Returns a malloc'd
+   payload (possibly empty) or NULL with last_error set. */
+static unsigned char* round_trip(OpenJTalkNativeClient* client, uint8_t type, const char* text, uint32_t* payload_len) {
+    size_t text_len = strlen(text);
+    if (text_len == 0 || text_len > MAX_INPUT_TEXT_LENGTH) {
+        client->last_error = OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+        return NULL;
+    }
+
+    unsigned char header[OJTN_HEADER_SIZE];
+    ojtn_frame_header_t h;
+    h.type = type;
+    h.request_id = client->next_request_id++;
+    h.status = 0;
+    h.payload_len = (uint32_t)text_len;
+    ojtn_pack_header(header, &h);
+
+    if (send_all(client->fd, header, sizeof(header)) != 0 ||
+        send_all(client->fd, (const unsigned char*)text, text_len) != 0 ||
+        recv_all(client->fd, header, sizeof(header)) != 0) {
+        client->last_error = OPENJTALK_NATIVE_ERROR_CONNECTION;
+        return NULL;
+    }
+
+    ojtn_frame_header_t response;
+    if (ojtn_unpack_header(header, &response) != 0 || response.request_id != h.request_id ||
+        response.type != type || response.payload_len > OJTN_MAX_RESPONSE_PAYLOAD) {
+        client->last_error = OPENJTALK_NATIVE_ERROR_CONNECTION;
+        return NULL;
+    }
+
+    unsigned char* payload = (unsigned char*)malloc(response.payload_len + 1);
+    if (!payload) {
+        client->last_error = OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
+        return NULL;
+    }
+    if (recv_all(client->fd, payload, response.payload_len) != 0) {
+        free(payload);
+        client->last_error = OPENJTALK_NATIVE_ERROR_CONNECTION;
+        return NULL;
+    }
+    if (response.status != OPENJTALK_NATIVE_SUCCESS) {
+        free(payload);
+        client->last_error = response.status;
+        return NULL;
+    }
+
+    *payload_len = response.payload_len;
+    return payload;
+}
+
+/* Bounds-checked reader over a response payload */
+typedef struct {
+    const unsigned char* p;
+    const unsigned char* end;
+    bool ok;
+} PayloadReader;
+
+static uint32_t read_u32(PayloadReader* r) {
+    if (r->end - r->p < 4) {
+        r->ok = false;
+        return 0;
+    }
+    uint32_t v = ojtn_get_u32(r->p);
+    r->p += 4;
+    return v;
+}
+
+static int* read_i32_array(PayloadReader* r, uint32_t n) {
+    if ((size_t)(r->end - r->p) / 4 < n) {
+        r->ok = false;
+        return NULL;
+    }
+    int* values = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    if (!values) {
+        r->ok = false;
+        return NULL;
+    }
+    for (uint32_t i = 0; i < n; i++, r->p += 4) values[i] = (int32_t)ojtn_get_u32(r->p);
+    return values;
+}
+
+static char* read_string(PayloadReader* r) {
+    uint32_t len = read_u32(r);
+    if (!r->ok || (size_t)(r->end - r->p) < len) {
+        r->ok = false;
+        return NULL;
+    }
+    char* s = (char*)malloc((size_t)len + 1);
+    if (!s) {
+        r->ok = false;
+        return NULL;
+    }
+    memcpy(s, r->p, len);
+    s[len] = '\0';
+    r->p += len;
+    return s;
+}
+
+OpenJTalkNativePhonemeResult* openjtalk_native_client_phonemize(void* handle, const char* text) {
+    if (!handle || !text) return NULL;
+    OpenJTalkNativeClient* client = (OpenJTalkNativeClient*)handle;
+
+    uint32_t len;
+    unsigned char* payload = round_trip(client, OJTN_MSG_PHONEMIZE, text, &len);
+    if (!payload) return NULL;
+
+    OpenJTalkNativePhonemeResult* result = (OpenJTalkNativePhonemeResult*)calloc(1, sizeof(OpenJTalkNativePhonemeResult));
+    PayloadReader r = { payload, payload + len, result != NULL };
+    uint32_t n = read_u32(&r);
+    if (r.ok && r.end - r.p >= 4) {
+        result->total_duration = ojtn_get_f32(r.p);
+        r.p += 4;
+    } else {
+        r.ok = false;
+    }
+    if (r.ok) result->phoneme_ids = read_i32_array(&r, n);
+    if (r.ok) {
+        result->durations = (float*)malloc(((size_t)n + 1) * sizeof(float));
+        if (!result->durations || (size_t)(r.end - r.p) / 4 < n) {
+            r.ok = false;
+        } else {
+            for (uint32_t i = 0; i < n; i++, r.p += 4) result->durations[i] = ojtn_get_f32(r.p);
+        }
+    }
+    if (r.ok) result->phonemes = read_string(&r);
+    free(payload);
+
+    if (!r.ok) {
+        if (result) {
+            free(result->phonemes);
+            free(result->phoneme_ids);
+            free(result->durations);
+            free(result);
+        }
+        client->last_error = OPENJTALK_NATIVE_ERROR_CONNECTION;
+        return NULL;
+    }
+    result->phoneme_count = (int)n;
+    ojtn_track_result_bytes((int64_t)ojtn_phoneme_result_bytes(result));
+    client->last_error = OPENJTALK_NATIVE_SUCCESS;
+    return result;
+}
+
+OpenJTalkNativeProsodyResult* openjtalk_native_client_phonemize_with_prosody(void* handle, const char* text) {
+    if (!handle || !text) return NULL;
+    OpenJTalkNativeClient* client = (OpenJTalkNativeClient*)handle;
+
+    uint32_t len;
+    unsigned char* payload = round_trip(client, OJTN_MSG_PROSODY, text, &len);
+    if (!payload) return NULL;
+
+    OpenJTalkNativeProsodyResult* result = (OpenJTalkNativeProsodyResult*)calloc(1, sizeof(OpenJTalkNativeProsodyResult));
+    PayloadReader r = { payload, payload + len, result != NULL };
+    uint32_t n = read_u32(&r);
+    uint32_t symbol_count = read_u32(&r);
+    if (r.ok) result->prosody_a1 = read_i32_array(&r, n);
+    if (r.ok) result->prosody_a2 = read_i32_array(&r, n);
+    if (r.ok) result->prosody_a3 = read_i32_array(&r, n);
+    if (r.ok) result->prosody_marks = read_i32_array(&r, n);
+    if (r.ok) result->accent_phrase_index = read_i32_array(&r, n);
+    if (r.ok) result->mora_index = read_i32_array(&r, n);
+    if (r.ok) result->phonemes = read_string(&r);
+    if (r.ok) result->prosody_symbols = read_string(&r);
+    free(payload);
+
+    if (!r.ok) {
+        ojtn_destroy_prosody_result(result);
+        client->last_error = OPENJTALK_NATIVE_ERROR_CONNECTION;
+        return NULL;
+    }
+    result->phoneme_count = (int)n;
+    result->prosody_symbol_count = (int)symbol_count;
+    for (uint32_t i = 0; i < n; i++) {
+        if (result->accent_phrase_index[i] >= result->accent_phrase_count) {
+            result->accent_phrase_count = result->accent_phrase_index[i] + 1;
+        }
+    }
+    ojtn_track_result_bytes((int64_t)ojtn_prosody_result_bytes(result));
+    client->last_error = OPENJTALK_NATIVE_SUCCESS;
+    return result;
+}
+
+#endif
@@ -0,0 +1,79 @@
+#include "openjtalk_native_internal.h"
+#include <string.h>
+
+/* Rule-based phoneme duration estimate. Base durations are typical values
+   for read Japanese speech at normal rate; the modifiers cover the two
+   effects that move utterance length most: final lengthening and the
+   compression of long accent phrases. Good enough to size audio buffers
+   and plan streaming chunks, not a substitute for an acoustic model. */
+
+#define DURATION_EDGE_SILENCE 0.100f   /* Leading/trailing sil */
+#define DURATION_PAUSE        0.200f   /* Phrase-internal pau */
+
+#define PHRASE_FINAL_FACTOR   1.15f    /* Last mora of an accent phrase */
+#define BREATH_FINAL_FACTOR   1.35f    /* Last mora before a pause or the end */
+#define COMPRESSION_PER_MORA  0.02f    /* Per mora beyond COMPRESSION_START */
+#define COMPRESSION_START     4
+#define COMPRESSION_MAX_MORAE 8
+
+static float base_duration(const char* p, int len, bool* mora_final) {
+    *mora_final = false;
+    if (len == 2 && p[0] == 'c' && p[1] == 'l') {
+        *mora_final = true;
+        return 0.075f;
+    }
+    if (len == 1) {
+        if (strchr("aiueo", p[0])) {
+            *mora_final = true;
+            return 0.085f;
+        }
+        if (strchr("AIUEO", p[0])) {
+            *mora_final = true;
+            return 0.045f;
+        }
+        if (p[0] == 'N') {
+            *mora_final = true;
+            return 0.075f;
+        }
+    }
+    if (len == 2 && ((p[0] == 'c' && p[1] == 'h') || (p[0] == 't' && p[1] == 's'))) return 0.070f;
+    switch (p[0]) {
+        case 'k': case 'g': case 't': case 'd': case 'p': case 'b':
+            return 0.055f;                                  /* Plosives */
+        case 's': case 'z': case 'j': case 'h': case 'f':
+            return 0.075f;                                  /* Fricatives */
+        case 'n': case 'm':
+            return 0.050f;                                  /* Nasals */
+        default:
+            return 0.040f;                                  /* y, r, w, v */
+    }
+}
+
+float ojtn_phoneme_duration(const char* phoneme, int len, const int16_t* fields, bool utterance_edge, double speech_rate) {
+    float duration;
+
+    if (len == 3 && strncmp(phoneme, "pau", 3) == 0) {
+        duration = utterance_edge ? DURATION_EDGE_SILENCE : DURATION_PAUSE;
+    } else {
+        bool mora_final;
+        duration = base_duration(phoneme, len, &mora_final);
+
+        if (fields) {
+            /* Long accent phrases are spoken faster */
+            int morae = fields[OPENJTALK_NATIVE_LABEL_F1];
+            if (morae > COMPRESSION_START) {
+                int extra = morae - COMPRESSION_START;
+                if (extra > COMPRESSION_MAX_MORAE) extra = COMPRESSION_MAX_MORAE;
+                duration *= 1.0f - COMPRESSION_PER_MORA * (float)extra;
+            }
+
+            /* A3 == 1 is the last mora of the phrase; F6 == 1 the last
+               phrase of the breath group */
+            if (mora_final && fields[OPENJTALK_NATIVE_LABEL_A3] == 1) {
+                duration *= fields[OPENJTALK_NATIVE_LABEL_F6] == 1 ? BREATH_FINAL_FACTOR : PHRASE_FINAL_FACTOR;
+            }
+        }
+    }
+
+    return (float)(duration / speech_rate);
+}
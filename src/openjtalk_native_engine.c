@@ -0,0 +1,753 @@
+/* sched_setaffinity() and the CPU_* macros */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "openjtalk_native.h"
+#include "openjtalk_native_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#define ENGINE_DEFAULT_QUEUE_LIMIT 1024
+#define ENGINE_MAX_QUEUE_LIMIT 65536
+#define ENGINE_ARENA_SLOTS 64    /* Idle result buffers a worker keeps */
+
+struct EngineWorker;
+
+/* Unit of work executed by an engine worker on its own context */
+typedef struct EngineTask {
+    void (*run)(struct EngineTask* task, struct EngineWorker* worker);
+    /* Called after run() with the task's timings; may release the task */
+    void (*done)(struct EngineTask* task, uint64_t wait_ns, uint64_t run_ns);
+    struct EngineTask* next;
+    uint64_t enqueued_ns;
+} EngineTask;
+
+/* Sentence result buffer from a worker's arena; keeps its capacity between uses */
+typedef struct ResultSlot {
+    OpenJTalkNativeProsodyResult result;   /* Must be first */
+    struct ResultSlot* next;
+    struct EngineWorker* owner;
+} ResultSlot;
+
+typedef struct EngineWorker {
+    struct OpenJTalkNativeEngine* engine;
+    void* handle;            /* Context owned by this worker, created on its thread */
+    int index;               /* Workers below reserved_workers serve only the interactive lane */
+    int cpu;                 /* CPU the thread is pinned to, or -1 */
+    ojtn_thread_t thread;
+    bool started;
+    ojtn_mutex_t arena_lock;
+    ResultSlot* free_slots;
+    int free_slot_count;
+} EngineWorker;
+
+/* FIFO of one priority class; submitters block while it is full */
+typedef struct {
+    EngineTask* head;
+    EngineTask* tail;
+    int count;
+    int limit;
+    ojtn_cond_t space_available;
+} EngineLane;
+
+/* Multi-context engine: one task queue per priority lane served by one
+   thread per context. Every worker prefers the interactive lane; reserved
+   workers never take bulk work, so interactive calls find a free context
+   even while a bulk batch saturates the rest. */
+typedef struct OpenJTalkNativeEngine {
+    ojtn_mutex_t lock;
+    ojtn_cond_t work_available;          /* Any lane has work */
+    ojtn_cond_t interactive_available;   /* The interactive lane has work */
+    EngineLane lanes[OJTN_LANE_COUNT];
+    int reserved_workers;
+    bool stopping;
+    int worker_count;
+    EngineWorker* workers;
+    int flags;                           /* OpenJTalkNativeEngineFlags */
+    const char* dict_path;               /* Only while workers start up */
+    ojtn_cond_t workers_ready;
+    int ready_count;                     /* Workers done creating their context */
+    bool create_failed;
+    OpenJTalkNativeLaneMetrics lane_metrics[OJTN_LANE_COUNT];
+} OpenJTalkNativeEngine;
+
+/* One document call: sentence texts in, per-sentence results out */
+typedef struct {
+    ojtn_mutex_t lock;
+    ojtn_cond_t done;
+    int remaining;
+    char** texts;
+    OpenJTalkNativeProsodyResult** results;
+    int* errors;
+    uint64_t wait_ns;        /* Longest queue wait of any sentence */
+    uint64_t run_ns;         /* Processing time summed over sentences */
+} DocumentBatch;
+
+typedef struct {
+    EngineTask task;         /* Must be first */
+    DocumentBatch* batch;
+    int index;
+} SentenceTask;
+
+/* Pin the calling thread to the slot-th CPU it may run on, wrapping
+   around; returns the CPU, or -1 where pinning is unsupported or fails */
+static int pin_current_thread(int slot) {
+#if defined(__linux__)
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return -1;
+    int count = CPU_COUNT(&allowed);
+    if (count <= 0) return -1;
+    slot %= count;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &allowed) || slot-- > 0) continue;
+        cpu_set_t one;
+        CPU_ZERO(&one);
+        CPU_SET(cpu, &one);
+        return sched_setaffinity(0, sizeof(one), &one) == 0 ? cpu : -1;
+    }
+    return -1;
+#elif defined(_WIN32)
+    DWORD_PTR allowed, system_mask;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &allowed, &system_mask) || !allowed) return -1;
+    int count = 0;
+    for (int cpu = 0; cpu < (int)(sizeof(DWORD_PTR) * 8); cpu++) {
+        if (allowed & ((DWORD_PTR)1 << cpu)) count++;
+    }
+    slot %= count;
+    for (int cpu = 0; cpu < (int)(sizeof(DWORD_PTR) * 8); cpu++) {
+        DWORD_PTR mask = (DWORD_PTR)1 << cpu;
+        if (!(allowed & mask) || slot-- > 0) continue;
+        return SetThreadAffinityMask(GetCurrentThread(), mask) ? cpu : -1;
+    }
+    return -1;
+#else
+    (void)slot;
+    return -1;
+#endif
+}
+
+/* Take a result buffer from the worker's arena, or allocate one */
+static ResultSlot* arena_take(EngineWorker* worker) {
+    ojtn_mutex_lock(&worker->arena_lock);
+    ResultSlot* slot = worker->free_slots;
+    if (slot) {
+        worker->free_slots = slot->next;
+        worker->free_slot_count--;
+    }
+    ojtn_mutex_unlock(&worker->arena_lock);
+
+    if (!slot) {
+        slot = (ResultSlot*)calloc(1, sizeof(ResultSlot));
+        if (slot) slot->owner = worker;
+    }
+    return slot;
+}
+
+/* Give a buffer back to the worker that filled it; past ENGINE_ARENA_SLOTS
+   idle buffers it is freed instead */
+static void arena_release(ResultSlot* slot) {
+    EngineWorker* worker = slot->owner;
+    ojtn_mutex_lock(&worker->arena_lock);
+    bool kept = worker->free_slot_count < ENGINE_ARENA_SLOTS;
+    if (kept) {
+        slot->next = worker->free_slots;
+        worker->free_slots = slot;
+        worker->free_slot_count++;
+    }
+    ojtn_mutex_unlock(&worker->arena_lock);
+
+    if (!kept) {
+        openjtalk_native_clear_prosody_result(&slot->result);
+        free(slot);
+    }
+}
+
+/* Pop the next task a worker may run, interactive lane first. Caller holds
+   the engine lock. */
+static EngineTask* take_task(OpenJTalkNativeEngine* engine, bool reserved, int* lane) {
+    int lane_count = reserved ? 1 : OJTN_LANE_COUNT;
+    for (int i = 0; i < lane_count; i++) {
+        EngineLane* l = &engine->lanes[i];
+        EngineTask* task = l->head;
+        if (!task) continue;
+        l->head = task->next;
+        if (!l->head) l->tail = NULL;
+        l->count--;
+        ojtn_cond_signal(&l->space_available);
+        *lane = i;
+        return task;
+    }
+    return NULL;
+}
+
+static void worker_main(void* arg) {
+    EngineWorker* worker = (EngineWorker*)arg;
+    OpenJTalkNativeEngine* engine = worker->engine;
+
+    /* Pin before creating the context so its memory is first touched, and
+       placed, on this CPU's node */
+    if (engine->flags & OPENJTALK_NATIVE_ENGINE_PIN_WORKERS) worker->cpu = pin_current_thread(worker->index);
+    worker->handle = openjtalk_native_create(engine->dict_path);
+
+    ojtn_mutex_lock(&engine->lock);
+    if (!worker->handle) engine->create_failed = true;
+    engine->ready_count++;
+    ojtn_cond_broadcast(&engine->workers_ready);
+    ojtn_mutex_unlock(&engine->lock);
+    if (!worker->handle) return;
+
+    for (;;) {
+        EngineTask* task;
+        int lane = 0;
+
+        ojtn_mutex_lock(&engine->lock);
+        for (;;) {
+            bool reserved = worker->index < engine->reserved_workers;
+            task = take_task(engine, reserved, &lane);
+            /* Stopping: unreserved workers drain what is left */
+            if (task || engine->stopping) break;
+            ojtn_cond_wait(reserved ? &engine->interactive_available : &engine->work_available, &engine->lock);
+        }
+        ojtn_mutex_unlock(&engine->lock);
+        if (!task) break;
+
+        /* Record before done() so a finished call sees its own timings */
+        uint64_t started = ojtn_now_ns();
+        uint64_t wait_ns = started - task->enqueued_ns;
+        task->run(task, worker);
+        uint64_t run_ns = ojtn_now_ns() - started;
+        ojtn_lane_record(&engine->lane_metrics[lane], wait_ns, run_ns);
+        task->done(task, wait_ns, run_ns);
+    }
+}
+
+/* Queue a chain of tasks on a lane in order, blocking while the lane is
+   full, and wake a worker per task */
+static void engine_submit(OpenJTalkNativeEngine* engine, int lane, EngineTask* first) {
+    EngineLane* l = &engine->lanes[lane];
+
+    ojtn_mutex_lock(&engine->lock);
+    for (EngineTask* task = first; task;) {
+        while (l->count >= l->limit) {
+            ojtn_cond_wait(&l->space_available, &engine->lock);
+        }
+        EngineTask* next = task->next;
+        task->next = NULL;
+        task->enqueued_ns = ojtn_now_ns();
+        if (l->tail) {
+            l->tail->next = task;
+        } else {
+            l->head = task;
+        }
+        l->tail = task;
+        l->count++;
+
+        if (lane == OPENJTALK_NATIVE_PRIORITY_INTERACTIVE) ojtn_cond_signal(&engine->interactive_available);
+        ojtn_cond_signal(&engine->work_available);
+        task = next;
+    }
+    ojtn_mutex_unlock(&engine->lock);
+}
+
+static void run_sentence(EngineTask* task, EngineWorker* worker) {
+    SentenceTask* sentence = (SentenceTask*)task;
+    DocumentBatch* batch = sentence->batch;
+    int i = sentence->index;
+
+    ResultSlot* slot = arena_take(worker);
+    int error = slot ? openjtalk_native_phonemize_with_prosody_into(worker->handle, batch->texts[i], &slot->result)
+                     : OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
+    if (slot && error != OPENJTALK_NATIVE_SUCCESS) {
+        arena_release(slot);
+        slot = NULL;
+    }
+    batch->results[i] = slot ? &slot->result : NULL;
+    batch->errors[i] = error;
+}
+
+static void finish_sentence(EngineTask* task, uint64_t wait_ns, uint64_t run_ns) {
+    DocumentBatch* batch = ((SentenceTask*)task)->batch;
+
+    ojtn_mutex_lock(&batch->lock);
+    if (wait_ns > batch->wait_ns) batch->wait_ns = wait_ns;
+    batch->run_ns += run_ns;
+    if (--batch->remaining == 0) ojtn_cond_signal(&batch->done);
+    ojtn_mutex_unlock(&batch->lock);
+}
+
+void* openjtalk_native_engine_create(const char* dict_path, int worker_count) {
+    return openjtalk_native_engine_create_with_flags(dict_path, worker_count, 0);
+}
+
+void* openjtalk_native_engine_create_with_flags(const char* dict_path, int worker_count, int flags) {
+    if (!dict_path) return NULL;
+    if (worker_count <= 0) worker_count = ojtn_cpu_count();
+
+    OpenJTalkNativeEngine* engine = (OpenJTalkNativeEngine*)calloc(1, sizeof(OpenJTalkNativeEngine));
+    if (!engine) return NULL;
+
+    engine->workers = (EngineWorker*)calloc(worker_count, sizeof(EngineWorker));
+    if (!engine->workers) {
+        free(engine);
+        return NULL;
+    }
+    ojtn_mutex_init(&engine->lock);
+    ojtn_cond_init(&engine->work_available);
+    ojtn_cond_init(&engine->interactive_available);
+    ojtn_cond_init(&engine->workers_ready);
+    for (int i = 0; i < OJTN_LANE_COUNT; i++) {
+        engine->lanes[i].limit = ENGINE_DEFAULT_QUEUE_LIMIT;
+        ojtn_cond_init(&engine->lanes[i].space_available);
+    }
+    engine->worker_count = worker_count;
+    engine->reserved_workers = worker_count > 1 ? 1 : 0;
+    engine->flags = flags;
+    engine->dict_path = dict_path;
+
+    for (int i = 0; i < worker_count; i++) {
+        EngineWorker* worker = &engine->workers[i];
+        worker->engine = engine;
+        worker->index = i;
+        worker->cpu = -1;
+        ojtn_mutex_init(&worker->arena_lock);
+    }
+
+    /* Each worker creates its own context; contexts share the dictionary's
+       word cache through the registry */
+    int started = 0;
+    for (int i = 0; i < worker_count; i++) {
+        EngineWorker* worker = &engine->workers[i];
+        if (ojtn_thread_create(&worker->thread, worker_main, worker) != 0) break;
+        worker->started = true;
+        started++;
+    }
+
+    ojtn_mutex_lock(&engine->lock);
+    while (engine->ready_count < started) {
+        ojtn_cond_wait(&engine->workers_ready, &engine->lock);
+    }
+    bool failed = engine->create_failed || started < worker_count;
+    engine->dict_path = NULL;
+    ojtn_mutex_unlock(&engine->lock);
+
+    if (failed) {
+        openjtalk_native_engine_destroy(engine);
+        return NULL;
+    }
+    return engine;
+}
+
+void openjtalk_native_engine_destroy(void* engine_handle) {
+    if (!engine_handle) return;
+
+    OpenJTalkNativeEngine* engine = (OpenJTalkNativeEngine*)engine_handle;
+
+    /* Workers drain queued tasks before they exit */
+    ojtn_mutex_lock(&engine->lock);
+    engine->stopping = true;
+    ojtn_cond_broadcast(&engine->work_available);
+    ojtn_cond_broadcast(&engine->interactive_available);
+    ojtn_mutex_unlock(&engine->lock);
+
+    for (int i = 0; i < engine->worker_count; i++) {
+        if (engine->workers[i].started) ojtn_thread_join(engine->workers[i].thread);
+    }
+    for (int i = 0; i < engine->worker_count; i++) {
+        EngineWorker* worker = &engine->workers[i];
+        openjtalk_native_destroy(worker->handle);
+        while (worker->free_slots) {
+            ResultSlot* slot = worker->free_slots;
+            worker->free_slots = slot->next;
+            openjtalk_native_clear_prosody_result(&slot->result);
+            free(slot);
+        }
+        ojtn_mutex_destroy(&worker->arena_lock);
+    }
+
+    for (int i = 0; i < OJTN_LANE_COUNT; i++) {
+        ojtn_cond_destroy(&engine->lanes[i].space_available);
+    }
+    ojtn_cond_destroy(&engine->workers_ready);
+    ojtn_cond_destroy(&engine->interactive_available);
+    ojtn_cond_destroy(&engine->work_available);
+    ojtn_mutex_destroy(&engine->lock);
+    free(engine->workers);
+    free(engine);
+}
+
+int openjtalk_native_engine_get_worker_count(void* engine_handle) {
+    if (!engine_handle) return 0;
+    return ((OpenJTalkNativeEngine*)engine_handle)->worker_count;
+}
+
+int openjtalk_native_engine_get_worker_cpu(void* engine_handle, int worker) {
+    if (!engine_handle) return -1;
+    OpenJTalkNativeEngine* engine = (OpenJTalkNativeEngine*)engine_handle;
+    if (worker < 0 || worker >= engine->worker_count) return -1;
+    return engine->workers[worker].cpu;
+}
+
+int openjtalk_native_engine_set_option(void* engine_handle, const char* key, const char* value) {
+    if (!engine_handle || !key || !value) return OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+
+    OpenJTalkNativeEngine* engine = (OpenJTalkNativeEngine*)engine_handle;
+    char* end;
+    long n = strtol(value, &end, 10);
+    if (end == value || *end) return OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+
+    int lane;
+    if (strcmp(key, "reserved_workers") == 0) {
+        /* At least one worker must stay available to the bulk lane */
+        if (n < 0 || n >= engine->worker_count) return OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+        ojtn_mutex_lock(&engine->lock);
+        engine->reserved_workers = (int)n;
+        ojtn_cond_broadcast(&engine->work_available);
+        ojtn_cond_broadcast(&engine->interactive_available);
+        ojtn_mutex_unlock(&engine->lock);
+        return OPENJTALK_NATIVE_SUCCESS;
+    }
+    else if (strcmp(key, "interactive_queue_limit") == 0) lane = OPENJTALK_NATIVE_PRIORITY_INTERACTIVE;
+    else if (strcmp(key, "bulk_queue_limit") == 0) lane = OPENJTALK_NATIVE_PRIORITY_BULK;
+    else return OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+
+    if (n < 1 || n > ENGINE_MAX_QUEUE_LIMIT) return OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+    ojtn_mutex_lock(&engine->lock);
+    engine->lanes[lane].limit = (int)n;
+    ojtn_cond_broadcast(&engine->lanes[lane].space_available);
+    ojtn_mutex_unlock(&engine->lock);
+    return OPENJTALK_NATIVE_SUCCESS;
+}
+
+size_t openjtalk_native_engine_render_metrics(void* engine_handle, char* buffer, size_t capacity) {
+    if (!engine_handle) return 0;
+
+    OpenJTalkNativeEngine* engine = (OpenJTalkNativeEngine*)engine_handle;
+    OpenJTalkNativeMetrics snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    for (int i = 0; i < engine->worker_count; i++) {
+        ojtn_metrics_merge(&snapshot, &((OpenJTalkNativeContext*)engine->workers[i].handle)->metrics);
+    }
+    /* Every worker shares the first worker's dictionary */
+    return ojtn_metrics_render(&snapshot, engine->lane_metrics, ((OpenJTalkNativeContext*)engine->workers[0].handle)->dictionary,
+                               buffer, capacity);
+}
+
+/* Sentence splitting */
+
+static bool is_space_at(const unsigned char* p, const unsigned char* end, int* len) {
+    if (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+        *len = 1;
+        return true;
+    }
+    /* U+3000 IDEOGRAPHIC SPACE */
+    if (end - p >= 3 && p[0] == 0xE3 && p[1] == 0x80 && p[2] == 0x80) {
+        *len = 3;
+        return true;
+    }
+    return false;
+}
+
+/* Sentence terminators: 。 ． ！ ？ ! ? and newline */
+static int terminator_length(const unsigned char* p, const unsigned char* end) {
+    if (*p == '!' || *p == '?' || *p == '\n') return 1;
+    if (end - p >= 3) {
+        if (p[0] == 0xE3 && p[1] == 0x80 && p[2] == 0x82) return 3;                  /* 。 */
+        if (p[0] == 0xEF && p[1] == 0xBC && (p[2] == 0x8E || p[2] == 0x81 || p[2] == 0x9F)) {
+            return 3;                                                                /* ． ！ ？ */
+        }
+    }
+    return 0;
+}
+
+/* Closing brackets that stay with the sentence they close: 」 』 ） ) */
+static int closer_length(const unsigned char* p, const unsigned char* end) {
+    if (*p == ')') return 1;
+    if (end - p >= 3) {
+        if (p[0] == 0xE3 && p[1] == 0x80 && (p[2] == 0x8D || p[2] == 0x8F)) return 3;
+        if (p[0] == 0xEF && p[1] == 0xBC && p[2] == 0x89) return 3;
+    }
+    return 0;
+}
+
+/* Cut point for a sentence longer than the per-call input limit: after the
+   last 、 or ， that fits, else at the last UTF-8 boundary that fits. */
+static size_t split_oversized(const unsigned char* s, size_t len) {
+    size_t limit = len < MAX_INPUT_TEXT_LENGTH ? len : MAX_INPUT_TEXT_LENGTH;
+    for (size_t i = limit; i >= 3; i--) {
+        const unsigned char* p = s + i - 3;
+        if ((p[0] == 0xE3 && p[1] == 0x80 && p[2] == 0x81) ||
+            (p[0] == 0xEF && p[1] == 0xBC && p[2] == 0x8C)) {
+            return i;
+        }
+    }
+    while (limit > 0 && (s[limit] & 0xC0) == 0x80) limit--;
+    return limit > 0 ? limit : 1;
+}
+
+/* Append a trimmed [start, end) span as a sentence; whitespace-only spans are dropped */
+static bool add_sentence(const unsigned char* text, const unsigned char* start, const unsigned char* end,
+                         int** offsets, int** lengths, int* count, int* capacity) {
+    int len;
+    while (start < end && is_space_at(start, end, &len)) start += len;
+    while (end > start) {
+        if (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n') {
+            end--;
+        } else if (end - start >= 3 && end[-3] == 0xE3 && end[-2] == 0x80 && end[-1] == 0x80) {
+            end -= 3;
+        } else {
+            break;
+        }
+    }
+
+    while (start < end) {
+        size_t piece = (size_t)(end - start);
+        if (piece > MAX_INPUT_TEXT_LENGTH) piece = split_oversized(start, piece);
+
+        if (*count == *capacity) {
+            int new_capacity = *capacity ? *capacity * 2 : 64;
+            int* new_offsets = (int*)realloc(*offsets, new_capacity * sizeof(int));
+            if (!new_offsets) return false;
+            *offsets = new_offsets;
+            int* new_lengths = (int*)realloc(*lengths, new_capacity * sizeof(int));
+            if (!new_lengths) return false;
+            *lengths = new_lengths;
+            *capacity = new_capacity;
+        }
+        (*offsets)[*count] = (int)(start - text);
+        (*lengths)[*count] = (int)piece;
+        (*count)++;
+        start += piece;
+    }
+    return true;
+}
+
+static bool split_sentences(const char* text, size_t text_len, int** offsets, int** lengths, int* count) {
+    const unsigned char* s = (const unsigned char*)text;
+    const unsigned char* end = s + text_len;
+    const unsigned char* start = s;
+    const unsigned char* p = s;
+    int capacity = 0;
+
+    *offsets = NULL;
+    *lengths = NULL;
+    *count = 0;
+
+    while (p < end) {
+        int len = terminator_length(p, end);
+        if (!len) {
+            p++;
+            continue;
+        }
+        p += len;
+        /* Keep runs like "！？" and trailing closers with this sentence */
+        while (p < end && ((len = terminator_length(p, end)) > 0 || (len = closer_length(p, end)) > 0)) {
+            p += len;
+        }
+        if (!add_sentence(s, start, p, offsets, lengths, count, &capacity)) return false;
+        start = p;
+    }
+    return add_sentence(s, start, end, offsets, lengths, count, &capacity);
+}
+
+/* Document result */
+
+static uint64_t document_result_bytes(const OpenJTalkNativeDocumentResult* result) {
+    return sizeof(OpenJTalkNativeDocumentResult) + ojtn_prosody_result_bytes(result->prosody) +
+        (uint64_t)result->sentence_count * 5 * sizeof(int);
+}
+
+static void destroy_document_result(OpenJTalkNativeDocumentResult* result) {
+    if (!result) return;
+    ojtn_destroy_prosody_result(result->prosody);
+    free(result->sentence_offsets);
+    free(result->sentence_lengths);
+    free(result->sentence_phoneme_offsets);
+    free(result->sentence_phoneme_counts);
+    free(result->sentence_errors);
+    free(result);
+}
+
+/* Concatenate per-sentence results in order. Accent phrase and mora
+   indices continue across sentences. */
+static bool stitch_results(OpenJTalkNativeDocumentResult* result, OpenJTalkNativeProsodyResult** parts, int count) {
+    size_t phoneme_bytes = 1, symbol_bytes = 1;
+    int phoneme_count = 0;
+    for (int i = 0; i < count; i++) {
+        if (!parts[i]) continue;
+        phoneme_bytes += strlen(parts[i]->phonemes) + 1;
+        symbol_bytes += strlen(parts[i]->prosody_symbols) + 1;
+        phoneme_count += parts[i]->phoneme_count;
+    }
+
+    OpenJTalkNativeProsodyResult* out = (OpenJTalkNativeProsodyResult*)calloc(1, sizeof(OpenJTalkNativeProsodyResult));
+    if (!out) return false;
+    result->prosody = out;
+
+    /* +1 keeps allocations non-empty when no sentence produced phonemes */
+    size_t n = (size_t)phoneme_count + 1;
+    out->phonemes = (char*)malloc(phoneme_bytes);
+    out->prosody_symbols = (char*)malloc(symbol_bytes);
+    out->prosody_a1 = (int*)malloc(n * sizeof(int));
+    out->prosody_a2 = (int*)malloc(n * sizeof(int));
+    out->prosody_a3 = (int*)malloc(n * sizeof(int));
+    out->prosody_marks = (int*)malloc(n * sizeof(int));
+    out->accent_phrase_index = (int*)malloc(n * sizeof(int));
+    out->mora_index = (int*)malloc(n * sizeof(int));
+    if (!out->phonemes || !out->prosody_symbols || !out->prosody_a1 || !out->prosody_a2 || !out->prosody_a3 ||
+        !out->prosody_marks || !out->accent_phrase_index || !out->mora_index) {
+        return false;
+    }
+
+    char* phoneme_ptr = out->phonemes;
+    char* symbol_ptr = out->prosody_symbols;
+    int phrase_base = 0, mora_base = 0;
+    int pos = 0;
+
+    for (int i = 0; i < count; i++) {
+        OpenJTalkNativeProsodyResult* part = parts[i];
+        result->sentence_phoneme_offsets[i] = pos;
+        result->sentence_phoneme_counts[i] = part ? part->phoneme_count : 0;
+        if (!part) continue;
+
+        size_t len = strlen(part->phonemes);
+        if (phoneme_ptr != out->phonemes && len > 0) *phoneme_ptr++ = ' ';
+        memcpy(phoneme_ptr, part->phonemes, len);
+        phoneme_ptr += len;
+
+        len = strlen(part->prosody_symbols);
+        if (symbol_ptr != out->prosody_symbols && len > 0) *symbol_ptr++ = ' ';
+        memcpy(symbol_ptr, part->prosody_symbols, len);
+        symbol_ptr += len;
+        out->prosody_symbol_count += part->prosody_symbol_count;
+
+        int max_phrase = -1, max_mora = -1;
+        for (int j = 0; j < part->phoneme_count; j++, pos++) {
+            out->prosody_a1[pos] = part->prosody_a1[j];
+            out->prosody_a2[pos] = part->prosody_a2[j];
+            out->prosody_a3[pos] = part->prosody_a3[j];
+            out->prosody_marks[pos] = part->prosody_marks[j];
+            out->accent_phrase_index[pos] = part->accent_phrase_index[j] >= 0 ? part->accent_phrase_index[j] + phrase_base : -1;
+            out->mora_index[pos] = part->mora_index[j] >= 0 ? part->mora_index[j] + mora_base : -1;
+            if (part->accent_phrase_index[j] > max_phrase) max_phrase = part->accent_phrase_index[j];
+            if (part->mora_index[j] > max_mora) max_mora = part->mora_index[j];
+        }
+        phrase_base += max_phrase + 1;
+        mora_base += max_mora + 1;
+    }
+
+    *phoneme_ptr = '\0';
+    *symbol_ptr = '\0';
+    out->phoneme_count = phoneme_count;
+    out->accent_phrase_count = phrase_base;
+    return true;
+}
+
+OpenJTalkNativeDocumentResult* openjtalk_native_engine_phonemize_document(void* engine_handle, const char* text) {
+    return openjtalk_native_engine_phonemize_document_with_priority(engine_handle, text, OPENJTALK_NATIVE_PRIORITY_INTERACTIVE);
+}
+
+OpenJTalkNativeDocumentResult* openjtalk_native_engine_phonemize_document_with_priority(void* engine_handle, const char* text,
+                                                                                       int priority) {
+    if (!engine_handle || !text || !*text) return NULL;
+    if (priority < 0 || priority >= OJTN_LANE_COUNT) return NULL;
+
+    OpenJTalkNativeEngine* engine = (OpenJTalkNativeEngine*)engine_handle;
+    size_t text_len = strlen(text);
+
+    OpenJTalkNativeDocumentResult* result = (OpenJTalkNativeDocumentResult*)calloc(1, sizeof(OpenJTalkNativeDocumentResult));
+    if (!result) return NULL;
+
+    int count;
+    if (!split_sentences(text, text_len, &result->sentence_offsets, &result->sentence_lengths, &count)) {
+        destroy_document_result(result);
+        return NULL;
+    }
+    result->sentence_count = count;
+
+    size_t n = (size_t)count + 1;
+    result->sentence_phoneme_offsets = (int*)calloc(n, sizeof(int));
+    result->sentence_phoneme_counts = (int*)calloc(n, sizeof(int));
+    result->sentence_errors = (int*)calloc(n, sizeof(int));
+
+    DocumentBatch batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.texts = (char**)calloc(n, sizeof(char*));
+    batch.results = (OpenJTalkNativeProsodyResult**)calloc(n, sizeof(OpenJTalkNativeProsodyResult*));
+    batch.errors = result->sentence_errors;
+    SentenceTask* tasks = (SentenceTask*)calloc(n, sizeof(SentenceTask));
+    /* All sentence texts live in one buffer, each NUL-terminated */
+    char* text_buffer = (char*)malloc(text_len + n);
+
+    if (!result->sentence_phoneme_offsets || !result->sentence_phoneme_counts || !result->sentence_errors ||
+        !batch.texts || !batch.results || !tasks || !text_buffer) {
+        free(batch.texts);
+        free(batch.results);
+        free(tasks);
+        free(text_buffer);
+        destroy_document_result(result);
+        return NULL;
+    }
+
+    char* buf_ptr = text_buffer;
+    for (int i = 0; i < count; i++) {
+        memcpy(buf_ptr, text + result->sentence_offsets[i], result->sentence_lengths[i]);
+        batch.texts[i] = buf_ptr;
+        buf_ptr += result->sentence_lengths[i];
+        *buf_ptr++ = '\0';
+
+        tasks[i].task.run = run_sentence;
+        tasks[i].task.done = finish_sentence;
+        tasks[i].task.next = (i + 1 < count) ? &tasks[i + 1].task : NULL;
+        tasks[i].batch = &batch;
+        tasks[i].index = i;
+    }
+
+    if (count > 0) {
+        ojtn_mutex_init(&batch.lock);
+        ojtn_cond_init(&batch.done);
+        batch.remaining = count;
+
+        engine_submit(engine, priority, &tasks[0].task);
+
+        ojtn_mutex_lock(&batch.lock);
+        while (batch.remaining > 0) {
+            ojtn_cond_wait(&batch.done, &batch.lock);
+        }
+        ojtn_mutex_unlock(&batch.lock);
+
+        ojtn_cond_destroy(&batch.done);
+        ojtn_mutex_destroy(&batch.lock);
+    }
+
+    result->queue_wait_seconds = (double)batch.wait_ns * 1e-9;
+    result->processing_seconds = (double)batch.run_ns * 1e-9;
+    bool stitched = stitch_results(result, batch.results, count);
+
+    for (int i = 0; i < count; i++) {
+        if (batch.results[i]) arena_release((ResultSlot*)batch.results[i]);
+    }
+    free(batch.texts);
+    free(batch.results);
+    free(tasks);
+    free(text_buffer);
+
+    if (!stitched) {
+        destroy_document_result(result);
+        return NULL;
+    }
+
+    ojtn_track_result_bytes((int64_t)document_result_bytes(result));
+    return result;
+}
+
+void openjtalk_native_free_document_result(OpenJTalkNativeDocumentResult* result) {
+    if (!result) return;
+    ojtn_track_result_bytes(-(int64_t)document_result_bytes(result));
+    destroy_document_result(result);
+}
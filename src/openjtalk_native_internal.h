@@ -0,0 +1,224 @@
+/*
+ * Internal declarations shared between the openjtalk_native translation units.
+ * Nothing in this header is part of the public API.
+ */
+
+#ifndef OPENJTALK_NATIVE_INTERNAL_H
+#define OPENJTALK_NATIVE_INTERNAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <jpcommon.h>
+#include <mecab.h>
+#include <njd.h>
+
+#include "openjtalk_native.h"
+#include "openjtalk_native_thread.h"
+
+/* Maximum input text length (in bytes) to prevent buffer overflows */
+#define MAX_INPUT_TEXT_LENGTH 4096
+
+/* text2mecab output buffer. text2mecab widens each ASCII character to a
+   3-byte full-width one, so the output is at most three times the input. */
+#define MECAB_INPUT_BUFFER_SIZE (MAX_INPUT_TEXT_LENGTH * 3 + 1)
+
+/* Upper bound on distinct morphemes kept in a dictionary's word cache.
+   Once reached the cache stops growing; existing entries keep hitting. */
+#define WORD_CACHE_MAX_ENTRIES 65536
+
+/* Cached mecab2njd output for one MeCab feature line.
+   A single line can expand into several chained NJD nodes. */
+typedef struct {
+    uint32_t hash;
+    int node_count;
+    NJDNode* nodes;          /* Prototype nodes, copied into the NJD on a hit */
+    char key[];              /* Feature line, NUL-terminated (allocated inline) */
+} OpenJTalkNativeWordCacheEntry;
+
+/* Open-addressing hash table of morpheme prototypes, read-mostly */
+typedef struct {
+    ojtn_rwlock_t lock;
+    OpenJTalkNativeWordCacheEntry** slots;
+    size_t capacity;         /* Power of two */
+    size_t count;
+    size_t bytes;            /* Heap held by slots and entries, guarded by lock */
+    volatile int64_t hits;
+    volatile int64_t misses;
+} OpenJTalkNativeWordCache;
+
+/* Word cache counters for metrics */
+typedef struct {
+    int64_t hits;
+    int64_t misses;
+    uint64_t entries;
+    uint64_t bytes;
+} OpenJTalkNativeWordCacheStats;
+
+#define OJTN_LATENCY_BUCKETS 15  /* 50us .. 1s, then +Inf */
+#define OJTN_SIZE_BUCKETS 10     /* 16 .. 4096, then +Inf; input bytes and phonemes */
+#define OJTN_ERROR_CODES (1 - OPENJTALK_NATIVE_ERROR_CONNECTION)  /* -OpenJTalkNativeError; last code + 1 */
+
+/* Call histograms of one handle. Written with relaxed atomic adds by the
+   owning thread, read with atomic loads by any thread. */
+typedef struct {
+    volatile int64_t latency[OJTN_LATENCY_BUCKETS];
+    volatile int64_t latency_sum_ns;
+    volatile int64_t input[OJTN_SIZE_BUCKETS];
+    volatile int64_t input_sum;
+    volatile int64_t phonemes[OJTN_SIZE_BUCKETS];
+    volatile int64_t phoneme_sum;
+    volatile int64_t errors[OJTN_ERROR_CODES];
+} OpenJTalkNativeMetrics;
+
+#define OJTN_LANE_COUNT 2        /* OpenJTalkNativePriority */
+
+/* Engine lane timings: time queued before a worker picks a task up, and
+   time the worker spent on it */
+typedef struct {
+    volatile int64_t wait[OJTN_LATENCY_BUCKETS];
+    volatile int64_t wait_sum_ns;
+    volatile int64_t run[OJTN_LATENCY_BUCKETS];
+    volatile int64_t run_sum_ns;
+} OpenJTalkNativeLaneMetrics;
+
+/* Per-dictionary state shared by every handle created with the same path */
+typedef struct OpenJTalkNativeDictionary {
+    char* dict_path;
+    int refcount;            /* Guarded by the registry mutex */
+    uint64_t mapped_bytes;   /* Size of the dictionary files MeCab maps read-only */
+    volatile int64_t prefaulted; /* Non-zero once a warm-up has read the files */
+    OpenJTalkNativeWordCache word_cache;
+    struct OpenJTalkNativeDictionary* next;
+} OpenJTalkNativeDictionary;
+
+/* Input offsets carried through the frontend while the "alignment" option
+   is on. Offsets are bytes of the caller's text, end exclusive. */
+typedef struct {
+    int normalized_source[2 * (MAX_INPUT_TEXT_LENGTH + 1)]; /* Normalizer output -> input */
+    char mecab_text[MECAB_INPUT_BUFFER_SIZE];
+    int mecab_start[MECAB_INPUT_BUFFER_SIZE];   /* Input span per byte of mecab_text */
+    int mecab_end[MECAB_INPUT_BUFFER_SIZE];
+    int text_length;
+    bool text_mapped;        /* mecab_* describe the current call's MeCab input */
+    int* node_start;         /* Input span per NJD node */
+    int* node_end;
+    int node_capacity;
+    int* row_start;          /* Input span per label row: sil, phonemes, sil */
+    int* row_end;
+    int row_count;
+    int row_capacity;
+    bool rows_valid;         /* row_* describe the labels held by JPCommon */
+} OpenJTalkNativeAlignment;
+
+/* OpenJTalk context structure */
+typedef struct {
+    Mecab* mecab;
+    NJD* njd;
+    JPCommon* jpcommon;
+    char* dict_path;
+    OpenJTalkNativeDictionary* dictionary;
+    int last_error;
+    bool initialized;
+    bool use_word_cache;
+    bool normalize_numbers;
+    int latin_mode;          /* OJTN_LATIN_* */
+    int njd_stages;          /* OpenJTalkNativeStage mask */
+    size_t lattice_trim_bytes;      /* High-water mark for MeCab input, 0 = never trim */
+    size_t lattice_retained_bytes;  /* Largest MeCab input since the lattice was created */
+    size_t lattice_peak_bytes;      /* Largest MeCab input over the handle's lifetime */
+    int lattice_calls_below;        /* Consecutive calls under the mark while inflated */
+    uint64_t lattice_trims;
+    uint64_t working_set_bytes; /* Heap held by MeCab/NJD/JPCommon after the last call */
+    uint64_t peak_call_bytes;   /* Largest working set plus result seen in one call */
+    OpenJTalkNativeMetrics metrics;
+    OpenJTalkNativeAlignment* alignment; /* NULL unless the "alignment" option is on */
+    const char** row_phoneme;   /* Label rows parsed by the prosody renderer; */
+    int* row_len;               /* grown to the largest label count, never shrunk */
+    int16_t* row_fields;
+    int* row_label;
+    int row_capacity;
+    double speech_rate;
+    double pitch;
+    double volume;
+    char option_buffer[32]; /* Per-instance buffer for get_option return values */
+} OpenJTalkNativeContext;
+
+/* Dictionary registry (openjtalk_native_cache.c) */
+OpenJTalkNativeDictionary* ojtn_dictionary_acquire(const char* dict_path);
+void ojtn_dictionary_release(OpenJTalkNativeDictionary* dict);
+uint64_t ojtn_dictionary_prefault(OpenJTalkNativeDictionary* dict);
+
+/* Result bookkeeping (openjtalk_native.c) */
+uint64_t ojtn_phoneme_result_bytes(const OpenJTalkNativePhonemeResult* result);
+uint64_t ojtn_prosody_result_bytes(const OpenJTalkNativeProsodyResult* result);
+void ojtn_destroy_prosody_result(OpenJTalkNativeProsodyResult* result);
+void ojtn_track_result_bytes(int64_t delta);
+
+/* Memory accounting (openjtalk_native_cache.c) */
+size_t ojtn_njd_node_bytes(const NJDNode* node);
+void ojtn_dictionary_memory(OpenJTalkNativeDictionary* dict, uint64_t* shared_bytes, uint64_t* private_bytes);
+void ojtn_dictionary_memory_total(uint64_t* shared_bytes, uint64_t* private_bytes);
+
+/* Word cache (openjtalk_native_cache.c) */
+bool ojtn_word_cache_lookup(OpenJTalkNativeWordCache* cache, const char* feature, NJD* njd);
+void ojtn_word_cache_insert(OpenJTalkNativeWordCache* cache, const char* feature, NJDNode* first);
+void ojtn_word_cache_stats(OpenJTalkNativeWordCache* cache, OpenJTalkNativeWordCacheStats* stats);
+
+/* Call metrics (openjtalk_native_metrics.c). phonemes < 0 skips the phoneme
+   histogram; render returns the bytes required including the NUL and writes
+   nothing unless capacity covers them. */
+uint64_t ojtn_now_ns(void);
+void ojtn_metrics_record(OpenJTalkNativeMetrics* m, uint64_t elapsed_ns, size_t input_bytes, int phonemes, int error);
+void ojtn_metrics_merge(OpenJTalkNativeMetrics* into, OpenJTalkNativeMetrics* from);
+void ojtn_lane_record(OpenJTalkNativeLaneMetrics* m, uint64_t wait_ns, uint64_t run_ns);
+/* lanes holds OJTN_LANE_COUNT entries, or is NULL outside an engine */
+size_t ojtn_metrics_render(const OpenJTalkNativeMetrics* snapshot, OpenJTalkNativeLaneMetrics* lanes,
+                           OpenJTalkNativeDictionary* dict, char* buffer, size_t capacity);
+
+/* Full-context label parsing (openjtalk_native_label.c) */
+int ojtn_phoneme_id(const char* symbol, int len);
+bool ojtn_parse_label(const char* label, int16_t* fields);
+
+/* "latin_mode" option values */
+enum {
+    OJTN_LATIN_KEEP = 0,     /* Pass Latin, URLs and emoji to MeCab */
+    OJTN_LATIN_SPELL = 1,    /* Loanword or spelled-out katakana; URLs read as "URL", emoji dropped */
+    OJTN_LATIN_SKIP = 2      /* Drop Latin runs, URLs and emoji */
+};
+
+/* ojtn_normalize_text() results */
+enum {
+    OJTN_NORMALIZE_UNCHANGED = 0,   /* Nothing to rewrite; use the text as is */
+    OJTN_NORMALIZE_REWRITTEN = 1,   /* out holds the rewritten text */
+    OJTN_NORMALIZE_OVERFLOW = -1    /* The Latin rewrite does not fit in out */
+};
+
+/* Number/date/unit and Latin/URL/emoji rewriting (openjtalk_native_normalize.c).
+   On OJTN_NORMALIZE_REWRITTEN writes a NUL-terminated text to out, which
+   may be empty when everything was skipped. Numbers whose readings do not
+   fit are left as written and the Latin rewrite is retried on its own, so
+   latin_mode applies to every text that fits at all. source, when not
+   NULL, holds 2 * capacity ints and receives the input span [start, end)
+   of every output byte. */
+int ojtn_normalize_text(const char* text, size_t text_len, bool numbers, int latin_mode,
+                        char* out, size_t capacity, int* source);
+
+/* Input offsets (openjtalk_native_align.c). map_input records where each
+   byte of mecab_text came from; text is what text2mecab was given, which
+   is the normalizer output when normalized is set. make_labels does what
+   JPCommon_make_label() does and, when the input is mapped, fills the
+   label row offsets. */
+void ojtn_alignment_map_input(OpenJTalkNativeAlignment* a, const char* text, bool normalized,
+                              size_t input_length, const char* mecab_text);
+void ojtn_alignment_make_labels(OpenJTalkNativeAlignment* a, NJD* njd, JPCommon* jpcommon);
+void ojtn_alignment_destroy(OpenJTalkNativeAlignment* a);
+
+/* Katakana -> romaji (openjtalk_native_romaji.c). Writes the romaji and a
+   NUL to out unless out is NULL; returns its length without the NUL. */
+size_t ojtn_kana_to_romaji(const char* kana, char* out);
+
+/* Duration estimate (openjtalk_native_duration.c); fields may be NULL */
+float ojtn_phoneme_duration(const char* phoneme, int len, const int16_t* fields, bool utterance_edge, double speech_rate);
+
+#endif /* OPENJTALK_NATIVE_INTERNAL_H */
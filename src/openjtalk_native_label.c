@@ -0,0 +1,102 @@
+#include "openjtalk_native.h"
+#include "openjtalk_native_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Phoneme inventory of OpenJTalk full-context labels. The index is the
+   phoneme ID used in label columns P1..P5; do not reorder. */
+static const char* const phoneme_symbols[] = {
+    "pau", "sil",
+    "a", "i", "u", "e", "o",
+    "A", "I", "U", "E", "O",
+    "N", "cl",
+    "k", "ky", "kw", "g", "gy", "gw",
+    "s", "sh", "z", "j",
+    "t", "ch", "ts", "ty", "d", "dy",
+    "n", "ny", "h", "hy", "f",
+    "b", "by", "p", "py", "m", "my",
+    "y", "r", "ry", "w", "v"
+};
+#define PHONEME_SYMBOL_COUNT ((int)(sizeof(phoneme_symbols) / sizeof(phoneme_symbols[0])))
+
+/* Field names, in OpenJTalkNativeLabelField order */
+static const char* const label_field_names[OPENJTALK_NATIVE_LABEL_FIELD_COUNT] = {
+    "P1", "P2", "P3", "P4", "P5",
+    "A1", "A2", "A3",
+    "B1", "B2", "B3",
+    "C1", "C2", "C3",
+    "D1", "D2", "D3",
+    "E1", "E2", "E3", "E4", "E5",
+    "F1", "F2", "F3", "F4", "F5", "F6", "F7", "F8",
+    "G1", "G2", "G3", "G4", "G5",
+    "H1", "H2",
+    "I1", "I2", "I3", "I4", "I5", "I6", "I7", "I8",
+    "J1", "J2",
+    "K1", "K2", "K3"
+};
+
+/* Layout of a full-context label. 'p' is a phoneme field, 'n' a numeric
+   field (or "xx"); every other character must match literally. */
+static const char label_template[] =
+    "p^p-p+p=p"
+    "/A:n+n+n/B:n-n_n/C:n_n+n/D:n+n_n"
+    "/E:n_n!n_n-n/F:n_n#n_n@n_n|n_n/G:n_n%n_n_n"
+    "/H:n_n/I:n-n@n+n&n-n|n+n/J:n_n/K:n+n-n";
+
+int ojtn_phoneme_id(const char* symbol, int len) {
+    for (int i = 0; i < PHONEME_SYMBOL_COUNT; i++) {
+        if ((int)strlen(phoneme_symbols[i]) == len && strncmp(phoneme_symbols[i], symbol, len) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool ojtn_parse_label(const char* label, int16_t* fields) {
+    const char* t = label_template;
+    const char* p = label;
+    int field = 0;
+
+    for (int i = 0; i < OPENJTALK_NATIVE_LABEL_FIELD_COUNT; i++) {
+        fields[i] = OPENJTALK_NATIVE_LABEL_UNDEFINED;
+    }
+
+    for (; *t; t++) {
+        if (*t == 'p') {
+            /* Phonemes run up to the next literal in the template */
+            const char* end = strchr(p, t[1]);
+            if (!end) return false;
+            int id = ojtn_phoneme_id(p, (int)(end - p));
+            if (id >= 0) fields[field] = (int16_t)id;
+            field++;
+            p = end;
+        } else if (*t == 'n') {
+            if (p[0] == 'x' && p[1] == 'x') {
+                p += 2;
+            } else {
+                char* end;
+                long value = strtol(p, &end, 10);
+                if (end == p) return false;
+                if (value < -32767) value = -32767;
+                if (value > 32767) value = 32767;
+                fields[field] = (int16_t)value;
+                p = end;
+            }
+            field++;
+        } else {
+            if (*p != *t) return false;
+            p++;
+        }
+    }
+    return true;
+}
+
+const char* openjtalk_native_get_label_field_name(int field) {
+    if (field < 0 || field >= OPENJTALK_NATIVE_LABEL_FIELD_COUNT) return NULL;
+    return label_field_names[field];
+}
+
+const char* openjtalk_native_get_phoneme_symbol(int phoneme_id) {
+    if (phoneme_id < 0 || phoneme_id >= PHONEME_SYMBOL_COUNT) return NULL;
+    return phoneme_symbols[phoneme_id];
+}
@@ -0,0 +1,227 @@
+#include "openjtalk_native.h"
+#include "openjtalk_native_internal.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Per-handle call metrics. Recording is a handful of relaxed atomic adds on
+   counters owned by the handle; rendering snapshots them into a plain copy
+   and formats the copy, so a scrape never blocks a call. Bucket counters
+   are per bucket, the exposition cumulates them. */
+
+/* Upper bounds; the last bucket of each histogram is +Inf */
+static const uint64_t latency_bounds_ns[OJTN_LATENCY_BUCKETS - 1] = {
+    50000, 100000, 250000, 500000, 1000000, 2500000, 5000000,
+    10000000, 25000000, 50000000, 100000000, 250000000, 500000000, 1000000000
+};
+static const uint64_t size_bounds[OJTN_SIZE_BUCKETS - 1] = {
+    16, 32, 64, 128, 256, 512, 1024, 2048, 4096
+};
+
+/* "le" label values, spelled out so the host's LC_NUMERIC cannot turn the
+   decimal point into a comma */
+static const char* const latency_labels[OJTN_LATENCY_BUCKETS] = {
+    "0.00005", "0.0001", "0.00025", "0.0005", "0.001", "0.0025", "0.005",
+    "0.01", "0.025", "0.05", "0.1", "0.25", "0.5", "1", "+Inf"
+};
+static const char* const size_labels[OJTN_SIZE_BUCKETS] = {
+    "16", "32", "64", "128", "256", "512", "1024", "2048", "4096", "+Inf"
+};
+
+static const char* const lane_names[OJTN_LANE_COUNT] = { "interactive", "bulk" };
+
+/* Label values for the errors counter, indexed by -OpenJTalkNativeError */
+static const char* const error_names[] = {
+    "success", "invalid_handle", "invalid_input", "memory_allocation", "dictionary_not_found",
+    "initialization_failed", "phonemization_failed", "processing", "invalid_option", "invalid_dictionary",
+    "invalid_utf8", "connection"
+};
+
+/* Fails to compile when an error code is added without a name above */
+typedef char error_names_cover_every_code[(sizeof(error_names) / sizeof(error_names[0]) == OJTN_ERROR_CODES) ? 1 : -1];
+
+uint64_t ojtn_now_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (uint64_t)((double)count.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static int bucket_index(const uint64_t* bounds, int bound_count, uint64_t value) {
+    int i = 0;
+    while (i < bound_count && value > bounds[i]) i++;
+    return i;
+}
+
+void ojtn_metrics_record(OpenJTalkNativeMetrics* m, uint64_t elapsed_ns, size_t input_bytes, int phonemes, int error) {
+    ojtn_atomic_add(&m->latency[bucket_index(latency_bounds_ns, OJTN_LATENCY_BUCKETS - 1, elapsed_ns)], 1);
+    ojtn_atomic_add(&m->latency_sum_ns, (int64_t)elapsed_ns);
+    ojtn_atomic_add(&m->input[bucket_index(size_bounds, OJTN_SIZE_BUCKETS - 1, input_bytes)], 1);
+    ojtn_atomic_add(&m->input_sum, (int64_t)input_bytes);
+    if (phonemes >= 0) {
+        ojtn_atomic_add(&m->phonemes[bucket_index(size_bounds, OJTN_SIZE_BUCKETS - 1, (uint64_t)phonemes)], 1);
+        ojtn_atomic_add(&m->phoneme_sum, phonemes);
+    }
+    if (error < 0 && -error < OJTN_ERROR_CODES) {
+        ojtn_atomic_add(&m->errors[-error], 1);
+    }
+}
+
+void ojtn_lane_record(OpenJTalkNativeLaneMetrics* m, uint64_t wait_ns, uint64_t run_ns) {
+    ojtn_atomic_add(&m->wait[bucket_index(latency_bounds_ns, OJTN_LATENCY_BUCKETS - 1, wait_ns)], 1);
+    ojtn_atomic_add(&m->wait_sum_ns, (int64_t)wait_ns);
+    ojtn_atomic_add(&m->run[bucket_index(latency_bounds_ns, OJTN_LATENCY_BUCKETS - 1, run_ns)], 1);
+    ojtn_atomic_add(&m->run_sum_ns, (int64_t)run_ns);
+}
+
+void ojtn_metrics_merge(OpenJTalkNativeMetrics* into, OpenJTalkNativeMetrics* from) {
+    for (int i = 0; i < OJTN_LATENCY_BUCKETS; i++) into->latency[i] += ojtn_atomic_load(&from->latency[i]);
+    for (int i = 0; i < OJTN_SIZE_BUCKETS; i++) {
+        into->input[i] += ojtn_atomic_load(&from->input[i]);
+        into->phonemes[i] += ojtn_atomic_load(&from->phonemes[i]);
+    }
+    for (int i = 0; i < OJTN_ERROR_CODES; i++) into->errors[i] += ojtn_atomic_load(&from->errors[i]);
+    into->latency_sum_ns += ojtn_atomic_load(&from->latency_sum_ns);
+    into->input_sum += ojtn_atomic_load(&from->input_sum);
+    into->phoneme_sum += ojtn_atomic_load(&from->phoneme_sum);
+}
+
+/* Text sink that only counts once the buffer is exhausted */
+typedef struct {
+    char* buffer;
+    size_t capacity;
+    size_t length;
+} TextOut;
+
+static void out_printf(TextOut* out, const char* fmt, ...) {
+    char line[160];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+    if (n <= 0) return;
+    if ((size_t)n >= sizeof(line)) n = (int)sizeof(line) - 1;
+    if (out->buffer && out->length + (size_t)n < out->capacity) {
+        memcpy(out->buffer + out->length, line, (size_t)n);
+    }
+    out->length += (size_t)n;
+}
+
+static void out_header(TextOut* out, const char* name, const char* type, const char* help) {
+    out_printf(out, "# HELP %s %s\n", name, help);
+    out_printf(out, "# TYPE %s %s\n", name, type);
+}
+
+/* Header and cumulative buckets; the caller prints _sum, then out_count() */
+static void out_buckets(TextOut* out, const char* name, const char* help, const volatile int64_t* counts,
+                        const char* const* labels, int bucket_count) {
+    out_header(out, name, "histogram", help);
+    int64_t cumulative = 0;
+    for (int i = 0; i < bucket_count; i++) {
+        cumulative += counts[i];
+        out_printf(out, "%s_bucket{le=\"%s\"} %lld\n", name, labels[i], (long long)cumulative);
+    }
+}
+
+static void out_count(TextOut* out, const char* name, const volatile int64_t* counts, int bucket_count) {
+    int64_t total = 0;
+    for (int i = 0; i < bucket_count; i++) total += counts[i];
+    out_printf(out, "%s_count %lld\n", name, (long long)total);
+}
+
+/* One lane's series of a per-lane latency histogram */
+static void out_lane_latency(TextOut* out, const char* name, const char* lane, const volatile int64_t* counts,
+                             int64_t sum) {
+    int64_t cumulative = 0;
+    for (int i = 0; i < OJTN_LATENCY_BUCKETS; i++) {
+        cumulative += counts[i];
+        out_printf(out, "%s_bucket{lane=\"%s\",le=\"%s\"} %lld\n", name, lane, latency_labels[i], (long long)cumulative);
+    }
+    out_printf(out, "%s_sum{lane=\"%s\"} %lld.%09lld\n", name, lane,
+        (long long)(sum / 1000000000), (long long)(sum % 1000000000));
+    out_printf(out, "%s_count{lane=\"%s\"} %lld\n", name, lane, (long long)cumulative);
+}
+
+static void render_lanes(TextOut* out, const OpenJTalkNativeLaneMetrics* lanes) {
+    const char* name = "openjtalk_native_engine_queue_wait_seconds";
+    out_header(out, name, "histogram", "Time a sentence waited in its priority lane");
+    for (int i = 0; i < OJTN_LANE_COUNT; i++) {
+        out_lane_latency(out, name, lane_names[i], lanes[i].wait, lanes[i].wait_sum_ns);
+    }
+    name = "openjtalk_native_engine_processing_seconds";
+    out_header(out, name, "histogram", "Time a worker spent on a sentence");
+    for (int i = 0; i < OJTN_LANE_COUNT; i++) {
+        out_lane_latency(out, name, lane_names[i], lanes[i].run, lanes[i].run_sum_ns);
+    }
+}
+
+static void render(TextOut* out, const OpenJTalkNativeMetrics* m, const OpenJTalkNativeWordCacheStats* cache) {
+    const char* name = "openjtalk_native_call_duration_seconds";
+    out_buckets(out, name, "Time spent inside the library per text call", m->latency, latency_labels, OJTN_LATENCY_BUCKETS);
+    out_printf(out, "%s_sum %lld.%09lld\n", name,
+        (long long)(m->latency_sum_ns / 1000000000), (long long)(m->latency_sum_ns % 1000000000));
+    out_count(out, name, m->latency, OJTN_LATENCY_BUCKETS);
+
+    name = "openjtalk_native_input_bytes";
+    out_buckets(out, name, "UTF-8 input size per text call", m->input, size_labels, OJTN_SIZE_BUCKETS);
+    out_printf(out, "%s_sum %lld\n", name, (long long)m->input_sum);
+    out_count(out, name, m->input, OJTN_SIZE_BUCKETS);
+
+    name = "openjtalk_native_phonemes";
+    out_buckets(out, name, "Phonemes per successful phonemize, prosody or label call", m->phonemes, size_labels, OJTN_SIZE_BUCKETS);
+    out_printf(out, "%s_sum %lld\n", name, (long long)m->phoneme_sum);
+    out_count(out, name, m->phonemes, OJTN_SIZE_BUCKETS);
+
+    out_header(out, "openjtalk_native_errors_total", "counter", "Failed text calls by error code");
+    for (int i = 1; i < OJTN_ERROR_CODES; i++) {
+        out_printf(out, "openjtalk_native_errors_total{code=\"%s\"} %lld\n", error_names[i], (long long)m->errors[i]);
+    }
+
+    /* The word cache belongs to the dictionary and is shared by every handle on it */
+    out_header(out, "openjtalk_native_word_cache_hits_total", "counter", "Word cache hits on this dictionary");
+    out_printf(out, "openjtalk_native_word_cache_hits_total %lld\n", (long long)cache->hits);
+    out_header(out, "openjtalk_native_word_cache_misses_total", "counter", "Word cache misses on this dictionary");
+    out_printf(out, "openjtalk_native_word_cache_misses_total %lld\n", (long long)cache->misses);
+    out_header(out, "openjtalk_native_word_cache_entries", "gauge", "Morphemes held in the word cache");
+    out_printf(out, "openjtalk_native_word_cache_entries %llu\n", (unsigned long long)cache->entries);
+    out_header(out, "openjtalk_native_word_cache_bytes", "gauge", "Heap held by the word cache");
+    out_printf(out, "openjtalk_native_word_cache_bytes %llu\n", (unsigned long long)cache->bytes);
+}
+
+size_t ojtn_metrics_render(const OpenJTalkNativeMetrics* snapshot, OpenJTalkNativeLaneMetrics* lanes,
+                           OpenJTalkNativeDictionary* dict, char* buffer, size_t capacity) {
+    OpenJTalkNativeWordCacheStats cache;
+    ojtn_word_cache_stats(&dict->word_cache, &cache);
+
+    OpenJTalkNativeLaneMetrics lane_snapshot[OJTN_LANE_COUNT];
+    for (int l = 0; lanes && l < OJTN_LANE_COUNT; l++) {
+        for (int i = 0; i < OJTN_LATENCY_BUCKETS; i++) {
+            lane_snapshot[l].wait[i] = ojtn_atomic_load(&lanes[l].wait[i]);
+            lane_snapshot[l].run[i] = ojtn_atomic_load(&lanes[l].run[i]);
+        }
+        lane_snapshot[l].wait_sum_ns = ojtn_atomic_load(&lanes[l].wait_sum_ns);
+        lane_snapshot[l].run_sum_ns = ojtn_atomic_load(&lanes[l].run_sum_ns);
+    }
+
+    /* Size first so the buffer is either complete or untouched */
+    TextOut out = { NULL, 0, 0 };
+    render(&out, snapshot, &cache);
+    if (lanes) render_lanes(&out, lane_snapshot);
+    size_t required = out.length + 1;
+    if (!buffer || capacity < required) return required;
+
+    out.buffer = buffer;
+    out.capacity = capacity;
+    out.length = 0;
+    render(&out, snapshot, &cache);
+    if (lanes) render_lanes(&out, lane_snapshot);
+    buffer[out.length] = '\0';
+    return required;
+}
@@ -0,0 +1,661 @@
+#include "openjtalk_native_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Number, date, time, currency and unit normalization ahead of text2mecab.
+   A single left-to-right scan recognizes digit runs and the separators
+   between them, then rewrites the structured forms MeCab would otherwise
+   split into many symbol morphemes:
+
+     2024/01/05, 2024-01-05   -> 2024年1月5日
+     9:05, 12:30:15           -> 9時5分, 12時30分15秒
+     1,234,567                -> 1234567
+     $12, ¥100, €5, £3        -> 12ドル, 100円, 5ユーロ, 3ポンド
+     5km, 30%, 2.4GHz         -> 5キロメートル, 30パーセント, 2.4ギガヘルツ
+     090-1234-5678            -> ゼロキューゼロのイチニーサンヨンの...
+
+   Digits themselves are kept so njd_set_digit still applies counter and
+   rendaku rules.
+
+   The same scan optionally takes non-Japanese runs out of MeCab's way;
+   full-width Latin costs an unknown-word search per letter and yields a
+   reading per letter at best. With OJTN_LATIN_SPELL:
+
+     https://example.com/a    -> ユーアールエル
+     OK, Wi-Fi, getUserName   -> オーケー, ワイ-ファイ, ゲットユーザーネーム
+     API, Qx                  -> エーピーアイ, キューエックス
+     emoji (😀, 👍🏽, ❤️)       -> dropped
+
+   Latin runs split at camelCase boundaries and each piece is read from a
+   loanword table or spelled letter by letter. OJTN_LATIN_SKIP drops URLs,
+   emoji and Latin runs alike.
+
+   Anything that does not match a pattern is copied as is. When asked,
+   every output byte also records the input span it came from; a rewritten
+   form maps to the whole run it replaced. */
+
+#define MAX_GROUPS 8
+#define MAX_GROUP_DIGITS 32
+#define MAX_LATIN_RUN 64         /* Letters per Latin run; longer runs continue as a new run */
+
+typedef struct {
+    char* out;
+    size_t len;
+    size_t capacity;
+    bool overflow;
+    int* source;                 /* Optional: start/end input offset per output byte */
+    const unsigned char* base;
+    int from, to;                /* Input span of the bytes being written */
+} Writer;
+
+/* Digit groups and the separators between them, e.g. 2024 / 01 / 05 */
+typedef struct {
+    char digits[MAX_GROUPS][MAX_GROUP_DIGITS + 1];   /* ASCII */
+    int lens[MAX_GROUPS];
+    char seps[MAX_GROUPS];                           /* seps[i] precedes group i + 1 */
+    int count;
+    bool long_group;
+    const unsigned char* end;                        /* First byte after the run */
+} NumberRun;
+
+typedef struct {
+    const char* symbol;
+    const char* reading;
+} Word;
+
+/* Longest symbols first; the first match followed by a non-letter wins */
+static const Word units[] = {
+    { "km/h", "キロメートル毎時" },
+    { "m/s",  "メートル毎秒" },
+    { "kHz",  "キロヘルツ" },
+    { "MHz",  "メガヘルツ" },
+    { "GHz",  "ギガヘルツ" },
+    { "\xC2\xB0" "C", "度" },                        /* °C */
+    { "\xE2\x84\x83", "度" },                        /* ℃ */
+    { "\xEF\xBC\x85", "パーセント" },                /* ％ */
+    { "km",   "キロメートル" },
+    { "cm",   "センチメートル" },
+    { "mm",   "ミリメートル" },
+    { "kg",   "キログラム" },
+    { "mg",   "ミリグラム" },
+    { "ml",   "ミリリットル" },
+    { "mL",   "ミリリットル" },
+    { "Hz",   "ヘルツ" },
+    { "KB",   "キロバイト" },
+    { "MB",   "メガバイト" },
+    { "GB",   "ギガバイト" },
+    { "TB",   "テラバイト" },
+    { "ms",   "ミリ秒" },
+    { "kW",   "キロワット" },
+    { "m",    "メートル" },
+    { "g",    "グラム" },
+    { "L",    "リットル" },
+    { "W",    "ワット" },
+    { "V",    "ボルト" },
+    { "%",    "パーセント" }
+};
+
+static const Word currencies[] = {
+    { "$",            "ドル" },
+    { "\xEF\xBC\x84", "ドル" },                      /* ＄ */
+    { "\xC2\xA5",     "円" },                        /* ¥ */
+    { "\xEF\xBF\xA5", "円" },                        /* ￥ */
+    { "\xE2\x82\xAC", "ユーロ" },                    /* € */
+    { "\xC2\xA3",     "ポンド" }                     /* £ */
+};
+
+/* Sorted by symbol, lowercase; looked up case-insensitively */
+static const Word loanwords[] = {
+    { "app",      "アプリ" },
+    { "apple",    "アップル" },
+    { "blog",     "ブログ" },
+    { "book",     "ブック" },
+    { "bug",      "バグ" },
+    { "chat",     "チャット" },
+    { "cloud",    "クラウド" },
+    { "code",     "コード" },
+    { "cool",     "クール" },
+    { "data",     "データ" },
+    { "email",    "イーメール" },
+    { "error",    "エラー" },
+    { "fi",       "ファイ" },
+    { "file",     "ファイル" },
+    { "free",     "フリー" },
+    { "game",     "ゲーム" },
+    { "get",      "ゲット" },
+    { "good",     "グッド" },
+    { "google",   "グーグル" },
+    { "happy",    "ハッピー" },
+    { "hello",    "ハロー" },
+    { "home",     "ホーム" },
+    { "image",    "イメージ" },
+    { "input",    "インプット" },
+    { "list",     "リスト" },
+    { "login",    "ログイン" },
+    { "logout",   "ログアウト" },
+    { "love",     "ラブ" },
+    { "mail",     "メール" },
+    { "max",      "マックス" },
+    { "menu",     "メニュー" },
+    { "mini",     "ミニ" },
+    { "mode",     "モード" },
+    { "music",    "ミュージック" },
+    { "name",     "ネーム" },
+    { "network",  "ネットワーク" },
+    { "new",      "ニュー" },
+    { "news",     "ニュース" },
+    { "nice",     "ナイス" },
+    { "no",       "ノー" },
+    { "note",     "ノート" },
+    { "ok",       "オーケー" },
+    { "okay",     "オーケー" },
+    { "online",   "オンライン" },
+    { "open",     "オープン" },
+    { "output",   "アウトプット" },
+    { "page",     "ページ" },
+    { "password", "パスワード" },
+    { "phone",    "フォン" },
+    { "plus",     "プラス" },
+    { "pro",      "プロ" },
+    { "python",   "パイソン" },
+    { "sale",     "セール" },
+    { "search",   "サーチ" },
+    { "server",   "サーバー" },
+    { "service",  "サービス" },
+    { "set",      "セット" },
+    { "shop",     "ショップ" },
+    { "site",     "サイト" },
+    { "smart",    "スマート" },
+    { "start",    "スタート" },
+    { "stop",     "ストップ" },
+    { "system",   "システム" },
+    { "test",     "テスト" },
+    { "text",     "テキスト" },
+    { "thanks",   "サンクス" },
+    { "the",      "ザ" },
+    { "time",     "タイム" },
+    { "type",     "タイプ" },
+    { "update",   "アップデート" },
+    { "user",     "ユーザー" },
+    { "version",  "バージョン" },
+    { "video",    "ビデオ" },
+    { "web",      "ウェブ" },
+    { "wi",       "ワイ" },
+    { "wifi",     "ワイファイ" },
+    { "windows",  "ウィンドウズ" },
+    { "word",     "ワード" },
+    { "yes",      "イエス" },
+    { "youtube",  "ユーチューブ" }
+};
+
+static const char* const letter_readings[26] = {
+    "エー", "ビー", "シー", "ディー", "イー", "エフ", "ジー", "エイチ", "アイ", "ジェー", "ケー", "エル", "エム",
+    "エヌ", "オー", "ピー", "キュー", "アール", "エス", "ティー", "ユー", "ブイ", "ダブリュー", "エックス", "ワイ", "ゼット"
+};
+
+static const char url_reading[] = "ユーアールエル";
+
+static const char* const digit_readings[10] = {
+    "ゼロ", "イチ", "ニー", "サン", "ヨン", "ゴー", "ロク", "ナナ", "ハチ", "キュー"
+};
+
+static void put(Writer* w, const void* s, size_t n) {
+    if (w->overflow || w->len + n >= w->capacity) {
+        w->overflow = true;
+        return;
+    }
+    memcpy(w->out + w->len, s, n);
+    if (w->source) {
+        for (size_t i = 0; i < n; i++) {
+            w->source[2 * (w->len + i)] = w->from;
+            w->source[2 * (w->len + i) + 1] = w->to;
+        }
+    }
+    w->len += n;
+}
+
+/* Attribute the following output to input bytes [from, to) */
+static void set_source(Writer* w, const unsigned char* from, const unsigned char* to) {
+    w->from = (int)(from - w->base);
+    w->to = (int)(to - w->base);
+}
+
+static void put_str(Writer* w, const char* s) {
+    put(w, s, strlen(s));
+}
+
+/* Value of the ASCII or full-width digit at p, or -1 */
+static int digit_at(const unsigned char* p, const unsigned char* end, int* len) {
+    if (p < end && *p >= '0' && *p <= '9') {
+        *len = 1;
+        return *p - '0';
+    }
+    if (end - p >= 3 && p[0] == 0xEF && p[1] == 0xBC && p[2] >= 0x90 && p[2] <= 0x99) {
+        *len = 3;
+        return p[2] - 0x90;
+    }
+    return -1;
+}
+
+/* ASCII equivalent of the separator at p (, . / - :), or 0 */
+static char separator_at(const unsigned char* p, const unsigned char* end, int* len) {
+    if (p < end && *p && strchr(",./-:", *p)) {
+        *len = 1;
+        return (char)*p;
+    }
+    if (end - p >= 3 && p[0] == 0xEF && p[1] == 0xBC) {
+        *len = 3;
+        switch (p[2]) {
+            case 0x8C: return ',';
+            case 0x8E: return '.';
+            case 0x8F: return '/';
+            case 0x8D: return '-';
+            case 0x9A: return ':';
+        }
+    }
+    return 0;
+}
+
+static bool is_ascii_alnum(unsigned char c) {
+    return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'z');
+}
+
+static bool is_ascii_letter(unsigned char c) {
+    return (c | 0x20) >= 'a' && (c | 0x20) <= 'z';
+}
+
+static void scan_run(const unsigned char* p, const unsigned char* end, NumberRun* run) {
+    run->count = 0;
+    run->long_group = false;
+
+    for (;;) {
+        int g = run->count++;
+        int n = 0, len, d;
+        while ((d = digit_at(p, end, &len)) >= 0) {
+            if (n < MAX_GROUP_DIGITS) run->digits[g][n] = (char)('0' + d);
+            else run->long_group = true;
+            n++;
+            p += len;
+        }
+        run->lens[g] = n;
+        run->digits[g][n < MAX_GROUP_DIGITS ? n : MAX_GROUP_DIGITS] = '\0';
+
+        /* Continue only across a separator that is followed by a digit */
+        int sep_len;
+        char sep = separator_at(p, end, &sep_len);
+        if (!sep || run->count == MAX_GROUPS || digit_at(p + sep_len, end, &len) < 0) break;
+        run->seps[g] = sep;
+        p += sep_len;
+    }
+    run->end = p;
+}
+
+static bool all_separators(const NumberRun* run, char sep, int groups) {
+    for (int i = 0; i < groups - 1; i++) {
+        if (run->seps[i] != sep) return false;
+    }
+    return true;
+}
+
+static int group_value(const NumberRun* run, int g) {
+    int v = 0;
+    for (int i = 0; i < run->lens[g]; i++) v = v * 10 + (run->digits[g][i] - '0');
+    return v;
+}
+
+static void put_value(Writer* w, int v, const char* suffix) {
+    char buf[16];
+    int n = 0;
+    do {
+        buf[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v && n < (int)sizeof(buf));
+    while (n > 0) put(w, &buf[--n], 1);
+    put_str(w, suffix);
+}
+
+/* YYYY/MM/DD or YYYY-MM-DD */
+static bool emit_date(Writer* w, const NumberRun* run) {
+    if (run->count != 3 || (!all_separators(run, '/', 3) && !all_separators(run, '-', 3))) return false;
+    if (run->lens[0] != 4 || run->lens[1] > 2 || run->lens[2] > 2) return false;
+    int month = group_value(run, 1), day = group_value(run, 2);
+    if (month < 1 || month > 12 || day < 1 || day > 31) return false;
+
+    put_value(w, group_value(run, 0), "年");
+    put_value(w, month, "月");
+    put_value(w, day, "日");
+    return true;
+}
+
+/* H:MM or H:MM:SS */
+static bool emit_time(Writer* w, const NumberRun* run) {
+    if (run->count < 2 || run->count > 3 || !all_separators(run, ':', run->count)) return false;
+    if (run->lens[0] > 2 || run->lens[1] != 2 || (run->count == 3 && run->lens[2] != 2)) return false;
+    int hour = group_value(run, 0), minute = group_value(run, 1);
+    int second = run->count == 3 ? group_value(run, 2) : 0;
+    if (hour > 24 || minute > 59 || second > 59) return false;
+
+    put_value(w, hour, "時");
+    if (minute > 0 || run->count == 3) put_value(w, minute, "分");
+    if (run->count == 3) put_value(w, second, "秒");
+    return true;
+}
+
+/* Hyphenated numbers starting with 0 and 10-11 digits long, read digit by digit */
+static bool emit_phone(Writer* w, const NumberRun* run) {
+    if (run->count < 3 || !all_separators(run, '-', run->count) || run->digits[0][0] != '0') return false;
+    int total = 0;
+    for (int g = 0; g < run->count; g++) {
+        if (run->lens[g] > 5) return false;
+        total += run->lens[g];
+    }
+    if (total < 10 || total > 11) return false;
+
+    for (int g = 0; g < run->count; g++) {
+        if (g > 0) put_str(w, "の");
+        for (int i = 0; i < run->lens[g]; i++) put_str(w, digit_readings[run->digits[g][i] - '0']);
+    }
+    return true;
+}
+
+/* Plain, decimal or comma-grouped number; commas are dropped */
+static bool emit_number(Writer* w, const NumberRun* run) {
+    if (run->long_group) return false;
+    int groups = run->count;
+    bool decimal = groups >= 2 && run->seps[groups - 2] == '.';
+    int integer_groups = decimal ? groups - 1 : groups;
+
+    if (integer_groups > 1) {
+        if (!all_separators(run, ',', integer_groups) || run->lens[0] > 3) return false;
+        for (int g = 1; g < integer_groups; g++) {
+            if (run->lens[g] != 3) return false;
+        }
+    }
+
+    for (int g = 0; g < groups; g++) {
+        if (decimal && g == groups - 1) put(w, ".", 1);
+        put(w, run->digits[g], (size_t)run->lens[g]);
+    }
+    return true;
+}
+
+static const Word* match_word(const Word* table, size_t count, const unsigned char* p, const unsigned char* end) {
+    for (size_t i = 0; i < count; i++) {
+        size_t n = strlen(table[i].symbol);
+        if ((size_t)(end - p) >= n && memcmp(p, table[i].symbol, n) == 0 &&
+            (p + n == end || !is_ascii_letter(p[n]))) {
+            return &table[i];
+        }
+    }
+    return NULL;
+}
+
+static bool contains_digit(const unsigned char* p, const unsigned char* end) {
+    int len;
+    for (; p < end; p++) {
+        if (digit_at(p, end, &len) >= 0) return true;
+    }
+    return false;
+}
+
+/* ASCII letter for the half- or full-width Latin letter at p, or 0 */
+static char letter_at(const unsigned char* p, const unsigned char* end, int* len) {
+    if (p < end && is_ascii_letter(*p)) {
+        *len = 1;
+        return (char)*p;
+    }
+    if (end - p >= 3 && p[0] == 0xEF) {
+        *len = 3;
+        if (p[1] == 0xBC && p[2] >= 0xA1 && p[2] <= 0xBA) return (char)('A' + (p[2] - 0xA1));   /* Ａ-Ｚ */
+        if (p[1] == 0xBD && p[2] >= 0x81 && p[2] <= 0x9A) return (char)('a' + (p[2] - 0x81));   /* ａ-ｚ */
+    }
+    return 0;
+}
+
+/* Code point of the UTF-8 sequence at p, or -1 if it is not well formed */
+static long code_point_at(const unsigned char* p, const unsigned char* end, int* len) {
+    int n = *p >= 0xF0 ? 4 : *p >= 0xE0 ? 3 : *p >= 0xC0 ? 2 : 1;
+    if (end - p < n) return -1;
+    long cp = n == 1 ? *p : *p & (0x3F >> (n - 1));
+    for (int i = 1; i < n; i++) {
+        if ((p[i] & 0xC0) != 0x80) return -1;
+        cp = (cp << 6) | (p[i] & 0x3F);
+    }
+    *len = n;
+    return cp;
+}
+
+/* Pictographs, symbols and dingbats, flags, skin tones */
+static bool is_emoji(long cp) {
+    return (cp >= 0x1F000 && cp <= 0x1FAFF) || (cp >= 0x2600 && cp <= 0x27BF) || (cp >= 0x2B00 && cp <= 0x2BFF);
+}
+
+/* Joiners and selectors that continue an emoji sequence: ZWJ, variation
+   selectors, the keycap mark and tag characters */
+static bool is_emoji_modifier(long cp) {
+    return cp == 0x200D || cp == 0xFE0E || cp == 0xFE0F || cp == 0x20E3 || (cp >= 0xE0020 && cp <= 0xE007F);
+}
+
+/* End of the emoji sequence at p, or p if there is none */
+static const unsigned char* emoji_end(const unsigned char* p, const unsigned char* end) {
+    int len;
+    long cp = code_point_at(p, end, &len);
+    if (cp < 0 || (!is_emoji(cp) && !is_emoji_modifier(cp))) return p;
+    while (p < end && (cp = code_point_at(p, end, &len)) >= 0 && (is_emoji(cp) || is_emoji_modifier(cp))) p += len;
+    return p;
+}
+
+static bool starts_with_ignore_case(const unsigned char* p, const unsigned char* end, const char* prefix) {
+    size_t n = strlen(prefix);
+    if ((size_t)(end - p) < n) return false;
+    for (size_t i = 0; i < n; i++) {
+        unsigned char c = p[i];
+        if (c >= 'A' && c <= 'Z') c = (unsigned char)(c | 0x20);
+        if (c != (unsigned char)prefix[i]) return false;
+    }
+    return true;
+}
+
+/* End of the URL at p, or p if there is none. A URL runs to the next space,
+   non-ASCII byte, quote or bracket, less trailing sentence punctuation. */
+static const unsigned char* url_end(const unsigned char* p, const unsigned char* end) {
+    if (!starts_with_ignore_case(p, end, "http://") && !starts_with_ignore_case(p, end, "https://") &&
+        !starts_with_ignore_case(p, end, "www.")) {
+        return p;
+    }
+    const unsigned char* q = p;
+    while (q < end && *q > ' ' && *q < 0x7F && !strchr("\"'<>()[]{}", *q)) q++;
+    while (q > p && strchr(".,;:!?", q[-1])) q--;
+    return q;
+}
+
+static int compare_loanword(const void* key, const void* element) {
+    return strcmp((const char*)key, ((const Word*)element)->symbol);
+}
+
+/* Reading of one piece of a Latin run: a loanword, or the letters spelled out */
+static void put_latin_piece(Writer* w, const char* letters, int count) {
+    char key[MAX_LATIN_RUN + 1];
+    for (int i = 0; i < count; i++) key[i] = (char)(letters[i] | 0x20);
+    key[count] = '\0';
+
+    const Word* word = count >= 2 ? (const Word*)bsearch(key, loanwords, sizeof(loanwords) / sizeof(loanwords[0]),
+                                                         sizeof(Word), compare_loanword) : NULL;
+    if (word) {
+        put_str(w, word->reading);
+        return;
+    }
+    for (int i = 0; i < count; i++) put_str(w, letter_readings[key[i] - 'a']);
+}
+
+static bool is_upper(char c) {
+    return c >= 'A' && c <= 'Z';
+}
+
+/* Spell or skip the Latin run at p; returns the first byte after it */
+static const unsigned char* put_latin_run(Writer* w, const unsigned char* p, const unsigned char* end, int mode) {
+    char letters[MAX_LATIN_RUN];
+    const unsigned char* starts[MAX_LATIN_RUN + 1];
+    int count = 0, len;
+    char c;
+
+    while (count < MAX_LATIN_RUN && (c = letter_at(p, end, &len)) != 0) {
+        letters[count] = c;
+        starts[count++] = p;
+        p += len;
+    }
+    starts[count] = p;
+    if (mode == OJTN_LATIN_SKIP) return p;
+
+    /* Pieces break before an upper-case letter that follows a lower-case
+       one (getUser) or starts a word after capitals (HTTPServer) */
+    int piece = 0;
+    for (int i = 1; i <= count; i++) {
+        bool split = i == count ||
+            (is_upper(letters[i]) && (!is_upper(letters[i - 1]) || (i + 1 < count && !is_upper(letters[i + 1]))));
+        if (!split) continue;
+        set_source(w, starts[piece], starts[i]);
+        put_latin_piece(w, letters + piece, i - piece);
+        piece = i;
+    }
+    return p;
+}
+
+/* Anything the Latin modes may rewrite; URLs start with a letter */
+static bool contains_latin(const unsigned char* p, const unsigned char* end) {
+    int len;
+    for (; p < end; p++) {
+        if (letter_at(p, end, &len) || emoji_end(p, end) != p) return true;
+    }
+    return false;
+}
+
+/* One rewriting pass over the text with the given rewrites enabled */
+static int normalize_pass(const unsigned char* p, const unsigned char* end, bool numbers, int latin_mode,
+                          char* out, size_t capacity, int* source) {
+    Writer w = { out, 0, capacity, false, source, p, 0, 0 };
+    bool changed = false;
+    bool prev_alnum = false;
+    NumberRun run;
+
+    while (p < end && !w.overflow) {
+        int len;
+
+        if (latin_mode != OJTN_LATIN_KEEP) {
+            const unsigned char* next = prev_alnum ? p : url_end(p, end);
+            if (next != p) {
+                set_source(&w, p, next);
+                if (latin_mode == OJTN_LATIN_SPELL) put(&w, url_reading, sizeof(url_reading) - 1);
+            } else if ((next = emoji_end(p, end)) != p) {
+                /* Emoji have no reading in either mode */
+            } else if (letter_at(p, end, &len)) {
+                next = put_latin_run(&w, p, end, latin_mode);
+            }
+            if (next != p) {
+                p = next;
+                prev_alnum = latin_mode == OJTN_LATIN_SPELL;
+                changed = true;
+                continue;
+            }
+        }
+        if (!numbers) {
+            prev_alnum = is_ascii_alnum(*p);
+            set_source(&w, p, p + 1);
+            put(&w, p, 1);
+            p++;
+            continue;
+        }
+
+        /* Currency symbol directly before a number */
+        const Word* currency = NULL;
+        if (!prev_alnum) {
+            currency = match_word(currencies, sizeof(currencies) / sizeof(currencies[0]), p, end);
+        }
+        if (currency) {
+            const unsigned char* number = p + strlen(currency->symbol);
+            if (digit_at(number, end, &len) >= 0) {
+                scan_run(number, end, &run);
+                set_source(&w, p, run.end);
+                size_t mark = w.len;
+                if (emit_number(&w, &run)) {
+                    put_str(&w, currency->reading);
+                    p = run.end;
+                    prev_alnum = true;
+                    changed = true;
+                    continue;
+                }
+                w.len = mark;
+            }
+        }
+
+        /* Digit run at a token start; digits inside words like mp3 are kept */
+        if (!prev_alnum && digit_at(p, end, &len) >= 0) {
+            scan_run(p, end, &run);
+            set_source(&w, p, run.end);
+            size_t mark = w.len;
+            bool number = false;
+
+            if (emit_date(&w, &run) || emit_time(&w, &run) || emit_phone(&w, &run)) {
+                changed = true;
+            } else if (emit_number(&w, &run)) {
+                number = true;
+                changed |= run.count > 1 && run.seps[0] == ',';
+            } else {
+                w.len = mark;
+                put(&w, p, (size_t)(run.end - p));
+            }
+            p = run.end;
+            prev_alnum = true;
+
+            if (number) {
+                const Word* unit = match_word(units, sizeof(units) / sizeof(units[0]), p, end);
+                if (unit) {
+                    size_t n = strlen(unit->symbol);
+                    set_source(&w, p, p + n);
+                    put_str(&w, unit->reading);
+                    p += n;
+                    prev_alnum = is_ascii_alnum((unsigned char)unit->symbol[n - 1]);
+                    changed = true;
+                }
+            }
+            continue;
+        }
+
+        if (digit_at(p, end, &len) >= 0) {
+            set_source(&w, p, p + len);
+            put(&w, p, (size_t)len);
+            p += len;
+            prev_alnum = true;
+            continue;
+        }
+
+        prev_alnum = is_ascii_alnum(*p);
+        set_source(&w, p, p + 1);
+        put(&w, p, 1);
+        p++;
+    }
+
+    if (w.overflow) return OJTN_NORMALIZE_OVERFLOW;
+    if (!changed) return OJTN_NORMALIZE_UNCHANGED;
+    out[w.len] = '\0';
+    return OJTN_NORMALIZE_REWRITTEN;
+}
+
+int ojtn_normalize_text(const char* text, size_t text_len, bool numbers, int latin_mode,
+                        char* out, size_t capacity, int* source) {
+    const unsigned char* p = (const unsigned char*)text;
+    const unsigned char* end = p + text_len;
+
+    /* Fast path: nothing to rewrite */
+    numbers = numbers && contains_digit(p, end);
+    if (latin_mode != OJTN_LATIN_KEEP && !contains_latin(p, end)) latin_mode = OJTN_LATIN_KEEP;
+    if (!numbers && latin_mode == OJTN_LATIN_KEEP) return OJTN_NORMALIZE_UNCHANGED;
+
+    int result = normalize_pass(p, end, numbers, latin_mode, out, capacity, source);
+    if (result != OJTN_NORMALIZE_OVERFLOW || !numbers) return result;
+
+    /* Number readings are longer than the digits; leave the numbers as
+       written and retry the Latin rewrite on its own */
+    if (latin_mode == OJTN_LATIN_KEEP) return OJTN_NORMALIZE_UNCHANGED;
+    return normalize_pass(p, end, false, latin_mode, out, capacity, source);
+}
@@ -0,0 +1,102 @@
+/*
+ * Wire protocol between openjtalk_native_server and the client helper
+ * (openjtalk_native_client_*). Shared by the library and the server tool.
+ *
+ * Every message is a 20-byte header followed by payload_len bytes; all
+ * integers are little-endian, floats are IEEE-754 binary32.
+ *
+ *   u32 magic        "OJTN"
+ *   u8  version      OJTN_PROTOCOL_VERSION
+ *   u8  type         OJTN_MSG_*
+ *   u16 reserved     0
+ *   u32 request_id   echoed in the response; lets a client pipeline requests
+ *   i32 status       0 in requests, OpenJTalkNativeError in responses
+ *   u32 payload_len
+ *
+ * Request payload: UTF-8 text, not NUL-terminated.
+ *
+ * OJTN_MSG_PHONEMIZE response payload:
+ *   u32 n, f32 total_duration, i32 phoneme_ids[n], f32 durations[n],
+ *   u32 phonemes_len, phonemes
+ *
+ * OJTN_MSG_PROSODY response payload:
+ *   u32 n, u32 prosody_symbol_count,
+ *   i32 a1[n], a2[n], a3[n], prosody_marks[n], accent_phrase_index[n], mora_index[n],
+ *   u32 phonemes_len, phonemes, u32 prosody_symbols_len, prosody_symbols
+ *
+ * Responses with a non-zero status carry no payload.
+ */
+
+#ifndef OPENJTALK_NATIVE_PROTOCOL_H
+#define OPENJTALK_NATIVE_PROTOCOL_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define OJTN_PROTOCOL_MAGIC 0x4E544A4Fu   /* "OJTN" read as little-endian u32 */
+#define OJTN_PROTOCOL_VERSION 1
+#define OJTN_HEADER_SIZE 20
+
+/* Requests above this are rejected without being read into memory */
+#define OJTN_MAX_REQUEST_PAYLOAD (1u << 20)
+/* Sanity bound a client applies before allocating a response */
+#define OJTN_MAX_RESPONSE_PAYLOAD (64u << 20)
+
+enum {
+    OJTN_MSG_PHONEMIZE = 1,
+    OJTN_MSG_PROSODY = 2
+};
+
+typedef struct {
+    uint8_t type;
+    uint32_t request_id;
+    int32_t status;
+    uint32_t payload_len;
+} ojtn_frame_header_t;
+
+static inline void ojtn_put_u32(unsigned char* p, uint32_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+static inline uint32_t ojtn_get_u32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void ojtn_put_f32(unsigned char* p, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, 4);
+    ojtn_put_u32(p, bits);
+}
+
+static inline float ojtn_get_f32(const unsigned char* p) {
+    uint32_t bits = ojtn_get_u32(p);
+    float v;
+    memcpy(&v, &bits, 4);
+    return v;
+}
+
+static inline void ojtn_pack_header(unsigned char* p, const ojtn_frame_header_t* h) {
+    ojtn_put_u32(p, OJTN_PROTOCOL_MAGIC);
+    p[4] = OJTN_PROTOCOL_VERSION;
+    p[5] = h->type;
+    p[6] = 0;
+    p[7] = 0;
+    ojtn_put_u32(p + 8, h->request_id);
+    ojtn_put_u32(p + 12, (uint32_t)h->status);
+    ojtn_put_u32(p + 16, h->payload_len);
+}
+
+/* Returns 0 if the header is well-formed */
+static inline int ojtn_unpack_header(const unsigned char* p, ojtn_frame_header_t* h) {
+    if (ojtn_get_u32(p) != OJTN_PROTOCOL_MAGIC || p[4] != OJTN_PROTOCOL_VERSION) return -1;
+    h->type = p[5];
+    h->request_id = ojtn_get_u32(p + 8);
+    h->status = (int32_t)ojtn_get_u32(p + 12);
+    h->payload_len = ojtn_get_u32(p + 16);
+    return 0;
+}
+
+#endif /* OPENJTALK_NATIVE_PROTOCOL_H */
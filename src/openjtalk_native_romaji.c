@@ -0,0 +1,173 @@
+#include "openjtalk_native_internal.h"
+#include <string.h>
+
+/* Katakana reading -> romaji (modified Hepburn, ASCII only):
+     シ shi, チ chi, ツ tsu, フ fu, ジ/ヂ ji, ヅ zu, ヲ o
+     ッ doubles the next consonant (ch -> tch)
+     ー repeats the previous vowel (トーキョー -> tookyoo)
+     ン is n, followed by ' before a vowel or y (キンヨー -> kin'yoo)
+   Hiragana is read as katakana and devoicing marks (’) are dropped.
+   Japanese punctuation becomes its ASCII counterpart; anything else is
+   copied unchanged. */
+
+typedef struct {
+    const char* kana;
+    const char* romaji;
+} Mora;
+
+/* Two-character morae first; the first match wins */
+static const Mora morae[] = {
+    { "キャ", "kya" }, { "キュ", "kyu" }, { "キョ", "kyo" }, { "キェ", "kye" },
+    { "ギャ", "gya" }, { "ギュ", "gyu" }, { "ギョ", "gyo" }, { "ギェ", "gye" },
+    { "シャ", "sha" }, { "シュ", "shu" }, { "ショ", "sho" }, { "シェ", "she" },
+    { "ジャ", "ja" },  { "ジュ", "ju" },  { "ジョ", "jo" },  { "ジェ", "je" },
+    { "チャ", "cha" }, { "チュ", "chu" }, { "チョ", "cho" }, { "チェ", "che" },
+    { "ヂャ", "ja" },  { "ヂュ", "ju" },  { "ヂョ", "jo" },
+    { "ニャ", "nya" }, { "ニュ", "nyu" }, { "ニョ", "nyo" }, { "ニェ", "nye" },
+    { "ヒャ", "hya" }, { "ヒュ", "hyu" }, { "ヒョ", "hyo" }, { "ヒェ", "hye" },
+    { "ビャ", "bya" }, { "ビュ", "byu" }, { "ビョ", "byo" },
+    { "ピャ", "pya" }, { "ピュ", "pyu" }, { "ピョ", "pyo" },
+    { "ミャ", "mya" }, { "ミュ", "myu" }, { "ミョ", "myo" },
+    { "リャ", "rya" }, { "リュ", "ryu" }, { "リョ", "ryo" },
+    { "ティ", "ti" },  { "テュ", "tyu" }, { "トゥ", "tu" },
+    { "ディ", "di" },  { "デュ", "dyu" }, { "ドゥ", "du" },
+    { "ツァ", "tsa" }, { "ツィ", "tsi" }, { "ツェ", "tse" }, { "ツォ", "tso" },
+    { "ファ", "fa" },  { "フィ", "fi" },  { "フェ", "fe" },  { "フォ", "fo" },  { "フュ", "fyu" },
+    { "ウィ", "wi" },  { "ウェ", "we" },  { "ウォ", "wo" },  { "イェ", "ye" },
+    { "ヴァ", "va" },  { "ヴィ", "vi" },  { "ヴェ", "ve" },  { "ヴォ", "vo" },  { "ヴュ", "vyu" },
+    { "クァ", "kwa" }, { "クィ", "kwi" }, { "クェ", "kwe" }, { "クォ", "kwo" }, { "グァ", "gwa" },
+    { "スィ", "si" },  { "ズィ", "zi" },
+
+    { "ア", "a" },  { "イ", "i" },   { "ウ", "u" },   { "エ", "e" },  { "オ", "o" },
+    { "カ", "ka" }, { "キ", "ki" },  { "ク", "ku" },  { "ケ", "ke" }, { "コ", "ko" },
+    { "ガ", "ga" }, { "ギ", "gi" },  { "グ", "gu" },  { "ゲ", "ge" }, { "ゴ", "go" },
+    { "サ", "sa" }, { "シ", "shi" }, { "ス", "su" },  { "セ", "se" }, { "ソ", "so" },
+    { "ザ", "za" }, { "ジ", "ji" },  { "ズ", "zu" },  { "ゼ", "ze" }, { "ゾ", "zo" },
+    { "タ", "ta" }, { "チ", "chi" }, { "ツ", "tsu" }, { "テ", "te" }, { "ト", "to" },
+    { "ダ", "da" }, { "ヂ", "ji" },  { "ヅ", "zu" },  { "デ", "de" }, { "ド", "do" },
+    { "ナ", "na" }, { "ニ", "ni" },  { "ヌ", "nu" },  { "ネ", "ne" }, { "ノ", "no" },
+    { "ハ", "ha" }, { "ヒ", "hi" },  { "フ", "fu" },  { "ヘ", "he" }, { "ホ", "ho" },
+    { "バ", "ba" }, { "ビ", "bi" },  { "ブ", "bu" },  { "ベ", "be" }, { "ボ", "bo" },
+    { "パ", "pa" }, { "ピ", "pi" },  { "プ", "pu" },  { "ペ", "pe" }, { "ポ", "po" },
+    { "マ", "ma" }, { "ミ", "mi" },  { "ム", "mu" },  { "メ", "me" }, { "モ", "mo" },
+    { "ヤ", "ya" }, { "ユ", "yu" },  { "ヨ", "yo" },
+    { "ラ", "ra" }, { "リ", "ri" },  { "ル", "ru" },  { "レ", "re" }, { "ロ", "ro" },
+    { "ワ", "wa" }, { "ヰ", "i" },   { "ヱ", "e" },   { "ヲ", "o" },  { "ヴ", "vu" },
+    { "ァ", "a" },  { "ィ", "i" },   { "ゥ", "u" },   { "ェ", "e" },  { "ォ", "o" },
+    { "ャ", "ya" }, { "ュ", "yu" },  { "ョ", "yo" },  { "ヮ", "wa" },
+    { "ヵ", "ka" }, { "ヶ", "ke" },
+
+    { "、", "," },  { "。", "." },   { "？", "?" },   { "！", "!" },  { "・", " " }
+};
+
+#define KANA_BYTES 3
+#define MORA_COUNT ((int)(sizeof(morae) / sizeof(morae[0])))
+
+/* Copy up to two characters at p into buf as katakana (hiragana U+3041..U+3096
+   shifted by 0x60); returns the number of input bytes converted */
+static size_t to_katakana(const unsigned char* p, char* buf) {
+    size_t n = 0;
+    while (n < 2 * KANA_BYTES && p[n] == 0xE3 && (p[n + 1] & 0xC0) == 0x80 && (p[n + 2] & 0xC0) == 0x80) {
+        unsigned cp = ((unsigned)(p[n] & 0x0F) << 12) | ((unsigned)(p[n + 1] & 0x3F) << 6) | (p[n + 2] & 0x3F);
+        if (cp >= 0x3041 && cp <= 0x3096) cp += 0x60;
+        buf[n] = (char)0xE3;
+        buf[n + 1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        buf[n + 2] = (char)(0x80 | (cp & 0x3F));
+        n += KANA_BYTES;
+    }
+    buf[n] = '\0';
+    return n;
+}
+
+/* Longest mora at p; sets *len to the input bytes it covers */
+static const Mora* match_mora(const unsigned char* p, size_t* len) {
+    char kana[2 * KANA_BYTES + 1];
+    /* Full-width punctuation outside the kana block is matched as is */
+    const char* s = to_katakana(p, kana) > 0 ? kana : (const char*)p;
+    for (int i = 0; i < MORA_COUNT; i++) {
+        size_t n = strlen(morae[i].kana);
+        if (strncmp(s, morae[i].kana, n) == 0) {
+            *len = n;
+            return &morae[i];
+        }
+    }
+    return NULL;
+}
+
+static bool starts_with(const unsigned char* p, const char* s) {
+    return strncmp((const char*)p, s, strlen(s)) == 0;
+}
+
+static bool is_vowel(char c) {
+    return c == 'a' || c == 'i' || c == 'u' || c == 'e' || c == 'o';
+}
+
+static void emit(char* out, size_t* len, const char* s, size_t n) {
+    if (out) memcpy(out + *len, s, n);
+    *len += n;
+}
+
+size_t ojtn_kana_to_romaji(const char* kana, char* out) {
+    static const char sokuon[] = "ッ", sokuon_hiragana[] = "っ";
+    static const char long_vowel[] = "ー", syllabic_n[] = "ン", syllabic_n_hiragana[] = "ん";
+    static const char devoiced[] = "\xE2\x80\x99";  /* ’ */
+    const unsigned char* p = (const unsigned char*)kana;
+    size_t len = 0;
+    char last_vowel = 0;
+    bool double_next = false;
+    bool after_n = false;
+
+    while (*p) {
+        if (starts_with(p, devoiced)) {
+            p += KANA_BYTES;
+            continue;
+        }
+        if (starts_with(p, sokuon) || starts_with(p, sokuon_hiragana)) {
+            double_next = true;
+            after_n = false;
+            p += KANA_BYTES;
+            continue;
+        }
+        if (starts_with(p, long_vowel)) {
+            if (last_vowel) emit(out, &len, &last_vowel, 1);
+            after_n = false;
+            p += KANA_BYTES;
+            continue;
+        }
+        if (starts_with(p, syllabic_n) || starts_with(p, syllabic_n_hiragana)) {
+            emit(out, &len, "n", 1);
+            last_vowel = 0;
+            double_next = false;
+            after_n = true;
+            p += KANA_BYTES;
+            continue;
+        }
+
+        size_t n;
+        const Mora* mora = match_mora(p, &n);
+        if (!mora) {
+            /* Not kana: copy one UTF-8 sequence */
+            n = 1;
+            while (p[n] && (p[n] & 0xC0) == 0x80) n++;
+            emit(out, &len, (const char*)p, n);
+            last_vowel = 0;
+            double_next = after_n = false;
+            p += n;
+            continue;
+        }
+
+        const char* r = mora->romaji;
+        if (after_n && (is_vowel(r[0]) || r[0] == 'y')) emit(out, &len, "'", 1);
+        if (double_next && !is_vowel(r[0]) && r[0] >= 'a' && r[0] <= 'z') {
+            emit(out, &len, r[0] == 'c' ? "t" : r, 1);
+        }
+        size_t rn = strlen(r);
+        emit(out, &len, r, rn);
+        last_vowel = is_vowel(r[rn - 1]) ? r[rn - 1] : 0;
+        double_next = after_n = false;
+        p += n;
+    }
+
+    if (out) out[len] = '\0';
+    return len;
+}
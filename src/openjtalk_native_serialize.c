@@ -0,0 +1,213 @@
+#include "openjtalk_native.h"
+#include "openjtalk_native_internal.h"
+#include <string.h>
+
+#define SERIALIZED_MAGIC 0x52544A4Fu      /* "OJTR" read as little-endian u32 */
+#define SERIALIZED_HEADER_SIZE 24
+#define SERIALIZED_ENTRY_SIZE 12
+#define SERIALIZED_MAX_SECTIONS 12
+
+/* Section to be written: source column and how to narrow it */
+typedef struct {
+    int id;
+    int type;
+    uint32_t count;
+    const int* ints;         /* Source for integer columns */
+    const float* floats;     /* Source for OPENJTALK_NATIVE_SECTION_DURATIONS */
+    const char* bytes;       /* Source for raw byte sections */
+} SectionSource;
+
+static size_t element_size(int type) {
+    switch (type) {
+        case OPENJTALK_NATIVE_ELEMENT_U8:  return 1;
+        case OPENJTALK_NATIVE_ELEMENT_I16: return 2;
+        default:                           return 4;
+    }
+}
+
+static size_t align8(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+static void put_u16(unsigned char* p, uint32_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+}
+
+static void put_u32(unsigned char* p, uint32_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+static uint32_t get_u32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t get_u16(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+static size_t layout_size(const SectionSource* sections, int section_count) {
+    size_t size = align8(SERIALIZED_HEADER_SIZE + (size_t)section_count * SERIALIZED_ENTRY_SIZE);
+    for (int i = 0; i < section_count; i++) {
+        size += align8((size_t)sections[i].count * element_size(sections[i].type));
+    }
+    return size;
+}
+
+/* Phoneme IDs from the space-separated phoneme string, in inventory order */
+static void write_phoneme_ids(unsigned char* out, const char* phonemes, uint32_t count) {
+    const char* p = phonemes;
+    for (uint32_t i = 0; i < count; i++) {
+        while (*p == ' ') p++;
+        const char* end = p;
+        while (*end && *end != ' ') end++;
+        int id = ojtn_phoneme_id(p, (int)(end - p));
+        out[i] = (unsigned char)(id >= 0 ? id : 255);
+        p = end;
+    }
+}
+
+static void write_section(unsigned char* out, const SectionSource* s, const char* phonemes) {
+    uint32_t n = s->count;
+    if (s->id == OPENJTALK_NATIVE_SECTION_PHONEME_IDS) {
+        write_phoneme_ids(out, phonemes, n);
+    } else if (s->bytes) {
+        memcpy(out, s->bytes, n);
+    } else if (s->floats) {
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t bits;
+            memcpy(&bits, &s->floats[i], 4);
+            put_u32(out + i * 4, bits);
+        }
+    } else if (s->type == OPENJTALK_NATIVE_ELEMENT_U8) {
+        for (uint32_t i = 0; i < n; i++) out[i] = (unsigned char)s->ints[i];
+    } else if (s->type == OPENJTALK_NATIVE_ELEMENT_I16) {
+        for (uint32_t i = 0; i < n; i++) {
+            int v = s->ints[i];
+            v = v < -32768 ? -32768 : v > 32767 ? 32767 : v;
+            put_u16(out + i * 2, (uint32_t)(uint16_t)(int16_t)v);
+        }
+    } else {
+        for (uint32_t i = 0; i < n; i++) put_u32(out + i * 4, (uint32_t)s->ints[i]);
+    }
+}
+
+static size_t serialize(const SectionSource* sections, int section_count, uint32_t phoneme_count,
+                        float total_duration, const char* phonemes, void* buffer, size_t capacity) {
+    size_t size = layout_size(sections, section_count);
+    if (!buffer || capacity < size) return size;
+
+    unsigned char* out = (unsigned char*)buffer;
+    uint32_t duration_bits;
+    memcpy(&duration_bits, &total_duration, 4);
+
+    put_u32(out, SERIALIZED_MAGIC);
+    put_u16(out + 4, OPENJTALK_NATIVE_SERIALIZED_VERSION);
+    put_u16(out + 6, (uint32_t)section_count);
+    put_u32(out + 8, (uint32_t)size);
+    put_u32(out + 12, phoneme_count);
+    put_u32(out + 16, duration_bits);
+    put_u32(out + 20, 0);
+
+    size_t table_end = SERIALIZED_HEADER_SIZE + (size_t)section_count * SERIALIZED_ENTRY_SIZE;
+    size_t offset = align8(table_end);
+    memset(out + table_end, 0, offset - table_end);
+
+    for (int i = 0; i < section_count; i++) {
+        const SectionSource* s = &sections[i];
+        unsigned char* entry = out + SERIALIZED_HEADER_SIZE + (size_t)i * SERIALIZED_ENTRY_SIZE;
+        size_t bytes = (size_t)s->count * element_size(s->type);
+
+        put_u16(entry, (uint32_t)s->id);
+        entry[2] = (unsigned char)s->type;
+        entry[3] = 0;
+        put_u32(entry + 4, (uint32_t)offset);
+        put_u32(entry + 8, s->count);
+
+        write_section(out + offset, s, phonemes);
+        memset(out + offset + bytes, 0, align8(bytes) - bytes);
+        offset += align8(bytes);
+    }
+    return size;
+}
+
+static SectionSource int_section(int id, int type, const int* values, uint32_t count) {
+    SectionSource s;
+    memset(&s, 0, sizeof(s));
+    s.id = id;
+    s.type = type;
+    s.count = count;
+    s.ints = values;
+    return s;
+}
+
+size_t openjtalk_native_serialize_result(const OpenJTalkNativePhonemeResult* result, void* buffer, size_t capacity) {
+    if (!result || !result->phonemes || result->phoneme_count < 0) return 0;
+
+    uint32_t n = (uint32_t)result->phoneme_count;
+    SectionSource sections[2];
+    sections[0] = int_section(OPENJTALK_NATIVE_SECTION_PHONEME_IDS, OPENJTALK_NATIVE_ELEMENT_U8, NULL, n);
+    sections[1] = int_section(OPENJTALK_NATIVE_SECTION_DURATIONS, OPENJTALK_NATIVE_ELEMENT_F32, NULL, n);
+    sections[1].floats = result->durations;
+
+    return serialize(sections, 2, n, result->total_duration, result->phonemes, buffer, capacity);
+}
+
+size_t openjtalk_native_serialize_prosody_result(const OpenJTalkNativeProsodyResult* result, void* buffer, size_t capacity) {
+    if (!result || !result->phonemes || !result->prosody_symbols || result->phoneme_count < 0) return 0;
+
+    uint32_t n = (uint32_t)result->phoneme_count;
+    SectionSource sections[SERIALIZED_MAX_SECTIONS];
+    int count = 0;
+    sections[count++] = int_section(OPENJTALK_NATIVE_SECTION_PHONEME_IDS, OPENJTALK_NATIVE_ELEMENT_U8, NULL, n);
+    sections[count++] = int_section(OPENJTALK_NATIVE_SECTION_A1, OPENJTALK_NATIVE_ELEMENT_I16, result->prosody_a1, n);
+    sections[count++] = int_section(OPENJTALK_NATIVE_SECTION_A2, OPENJTALK_NATIVE_ELEMENT_I16, result->prosody_a2, n);
+    sections[count++] = int_section(OPENJTALK_NATIVE_SECTION_A3, OPENJTALK_NATIVE_ELEMENT_I16, result->prosody_a3, n);
+    sections[count++] = int_section(OPENJTALK_NATIVE_SECTION_PROSODY_MARKS, OPENJTALK_NATIVE_ELEMENT_U8, result->prosody_marks, n);
+    sections[count++] = int_section(OPENJTALK_NATIVE_SECTION_ACCENT_PHRASE_INDEX, OPENJTALK_NATIVE_ELEMENT_I32,
+                                    result->accent_phrase_index, n);
+    sections[count++] = int_section(OPENJTALK_NATIVE_SECTION_MORA_INDEX, OPENJTALK_NATIVE_ELEMENT_I32, result->mora_index, n);
+    sections[count] = int_section(OPENJTALK_NATIVE_SECTION_PROSODY_SYMBOLS, OPENJTALK_NATIVE_ELEMENT_U8, NULL,
+                                  (uint32_t)strlen(result->prosody_symbols));
+    sections[count++].bytes = result->prosody_symbols;
+    if (result->source_start && result->source_end) {
+        sections[count++] = int_section(OPENJTALK_NATIVE_SECTION_SOURCE_START, OPENJTALK_NATIVE_ELEMENT_I32, result->source_start, n);
+        sections[count++] = int_section(OPENJTALK_NATIVE_SECTION_SOURCE_END, OPENJTALK_NATIVE_ELEMENT_I32, result->source_end, n);
+    }
+    if (result->accent_phrase_start && result->accent_phrase_end && result->accent_phrase_count >= 0) {
+        uint32_t phrases = (uint32_t)result->accent_phrase_count;
+        sections[count++] = int_section(OPENJTALK_NATIVE_SECTION_ACCENT_PHRASE_START, OPENJTALK_NATIVE_ELEMENT_I32,
+                                        result->accent_phrase_start, phrases);
+        sections[count++] = int_section(OPENJTALK_NATIVE_SECTION_ACCENT_PHRASE_END, OPENJTALK_NATIVE_ELEMENT_I32,
+                                        result->accent_phrase_end, phrases);
+    }
+
+    return serialize(sections, count, n, 0.0f, result->phonemes, buffer, capacity);
+}
+
+const void* openjtalk_native_find_section(const void* buffer, size_t size, int section_id, int* element_type, int* count) {
+    if (!buffer || size < SERIALIZED_HEADER_SIZE) return NULL;
+
+    const unsigned char* in = (const unsigned char*)buffer;
+    if (get_u32(in) != SERIALIZED_MAGIC || get_u16(in + 4) != OPENJTALK_NATIVE_SERIALIZED_VERSION) return NULL;
+    uint32_t section_count = get_u16(in + 6);
+    if (get_u32(in + 8) > size || SERIALIZED_HEADER_SIZE + (size_t)section_count * SERIALIZED_ENTRY_SIZE > size) return NULL;
+
+    for (uint32_t i = 0; i < section_count; i++) {
+        const unsigned char* entry = in + SERIALIZED_HEADER_SIZE + (size_t)i * SERIALIZED_ENTRY_SIZE;
+        if ((int)get_u16(entry) != section_id) continue;
+
+        int type = entry[2];
+        uint32_t offset = get_u32(entry + 4);
+        uint32_t n = get_u32(entry + 8);
+        if (offset > size || (size - offset) / element_size(type) < n) return NULL;
+
+        if (element_type) *element_type = type;
+        if (count) *count = (int)n;
+        return in + offset;
+    }
+    return NULL;
+}
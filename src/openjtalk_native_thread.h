@@ -0,0 +1,162 @@
+/*
+ * Portable threading primitives used internally by openjtalk_native.
+ *
+ * Windows uses SRW locks, condition variables and Interlocked* intrinsics;
+ * every other platform uses pthreads and the GCC/Clang __atomic builtins.
+ * All locks support static initialization so that process-wide registries
+ * need no init call.
+ */
+
+#ifndef OPENJTALK_NATIVE_THREAD_H
+#define OPENJTALK_NATIVE_THREAD_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+typedef SRWLOCK ojtn_mutex_t;
+typedef SRWLOCK ojtn_rwlock_t;
+#define OJTN_MUTEX_INITIALIZER SRWLOCK_INIT
+#define OJTN_RWLOCK_INITIALIZER SRWLOCK_INIT
+
+static __inline void ojtn_mutex_init(ojtn_mutex_t* m)    { InitializeSRWLock(m); }
+static __inline void ojtn_mutex_destroy(ojtn_mutex_t* m) { (void)m; }
+static __inline void ojtn_mutex_lock(ojtn_mutex_t* m)    { AcquireSRWLockExclusive(m); }
+static __inline void ojtn_mutex_unlock(ojtn_mutex_t* m)  { ReleaseSRWLockExclusive(m); }
+
+static __inline void ojtn_rwlock_init(ojtn_rwlock_t* l)     { InitializeSRWLock(l); }
+static __inline void ojtn_rwlock_destroy(ojtn_rwlock_t* l)  { (void)l; }
+static __inline void ojtn_rwlock_rdlock(ojtn_rwlock_t* l)   { AcquireSRWLockShared(l); }
+static __inline void ojtn_rwlock_rdunlock(ojtn_rwlock_t* l) { ReleaseSRWLockShared(l); }
+static __inline void ojtn_rwlock_wrlock(ojtn_rwlock_t* l)   { AcquireSRWLockExclusive(l); }
+static __inline void ojtn_rwlock_wrunlock(ojtn_rwlock_t* l) { ReleaseSRWLockExclusive(l); }
+
+static __inline int64_t ojtn_atomic_add(volatile int64_t* p, int64_t v) {
+    return InterlockedExchangeAdd64((volatile LONG64*)p, v) + v;
+}
+static __inline int64_t ojtn_atomic_load(volatile int64_t* p) {
+    return InterlockedCompareExchange64((volatile LONG64*)p, 0, 0);
+}
+/* Drop one reference and return the count left (full barrier) */
+static __inline int64_t ojtn_ref_release(volatile int64_t* p) {
+    return InterlockedDecrement64((volatile LONG64*)p);
+}
+
+typedef CONDITION_VARIABLE ojtn_cond_t;
+static __inline void ojtn_cond_init(ojtn_cond_t* c)      { InitializeConditionVariable(c); }
+static __inline void ojtn_cond_destroy(ojtn_cond_t* c)   { (void)c; }
+static __inline void ojtn_cond_wait(ojtn_cond_t* c, ojtn_mutex_t* m) { SleepConditionVariableSRW(c, m, INFINITE, 0); }
+static __inline void ojtn_cond_signal(ojtn_cond_t* c)    { WakeConditionVariable(c); }
+static __inline void ojtn_cond_broadcast(ojtn_cond_t* c) { WakeAllConditionVariable(c); }
+
+typedef HANDLE ojtn_thread_t;
+typedef struct { void (*fn)(void*); void* arg; } ojtn_thread_start_t;
+
+static __inline DWORD WINAPI ojtn_thread_main(LPVOID param) {
+    ojtn_thread_start_t start = *(ojtn_thread_start_t*)param;
+    free(param);
+    start.fn(start.arg);
+    return 0;
+}
+
+static __inline int ojtn_thread_create(ojtn_thread_t* t, void (*fn)(void*), void* arg) {
+    ojtn_thread_start_t* start = (ojtn_thread_start_t*)malloc(sizeof(ojtn_thread_start_t));
+    if (!start) return -1;
+    start->fn = fn;
+    start->arg = arg;
+    *t = CreateThread(NULL, 0, ojtn_thread_main, start, 0, NULL);
+    if (!*t) {
+        free(start);
+        return -1;
+    }
+    return 0;
+}
+static __inline void ojtn_thread_join(ojtn_thread_t t) {
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+
+static __inline int ojtn_cpu_count(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+}
+
+#else
+#include <pthread.h>
+#include <unistd.h>
+
+typedef pthread_mutex_t ojtn_mutex_t;
+typedef pthread_rwlock_t ojtn_rwlock_t;
+#define OJTN_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+#define OJTN_RWLOCK_INITIALIZER PTHREAD_RWLOCK_INITIALIZER
+
+static inline void ojtn_mutex_init(ojtn_mutex_t* m)    { pthread_mutex_init(m, NULL); }
+static inline void ojtn_mutex_destroy(ojtn_mutex_t* m) { pthread_mutex_destroy(m); }
+static inline void ojtn_mutex_lock(ojtn_mutex_t* m)    { pthread_mutex_lock(m); }
+static inline void ojtn_mutex_unlock(ojtn_mutex_t* m)  { pthread_mutex_unlock(m); }
+
+static inline void ojtn_rwlock_init(ojtn_rwlock_t* l)     { pthread_rwlock_init(l, NULL); }
+static inline void ojtn_rwlock_destroy(ojtn_rwlock_t* l)  { pthread_rwlock_destroy(l); }
+static inline void ojtn_rwlock_rdlock(ojtn_rwlock_t* l)   { pthread_rwlock_rdlock(l); }
+static inline void ojtn_rwlock_rdunlock(ojtn_rwlock_t* l) { pthread_rwlock_unlock(l); }
+static inline void ojtn_rwlock_wrlock(ojtn_rwlock_t* l)   { pthread_rwlock_wrlock(l); }
+static inline void ojtn_rwlock_wrunlock(ojtn_rwlock_t* l) { pthread_rwlock_unlock(l); }
+
+static inline int64_t ojtn_atomic_add(volatile int64_t* p, int64_t v) {
+    return __atomic_add_fetch(p, v, __ATOMIC_RELAXED);
+}
+static inline int64_t ojtn_atomic_load(volatile int64_t* p) {
+    return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+/* Drop one reference and return the count left. Acquire-release, so the
+   owner that sees zero also sees every other owner's writes before it frees. */
+static inline int64_t ojtn_ref_release(volatile int64_t* p) {
+    return __atomic_sub_fetch(p, 1, __ATOMIC_ACQ_REL);
+}
+
+typedef pthread_cond_t ojtn_cond_t;
+static inline void ojtn_cond_init(ojtn_cond_t* c)      { pthread_cond_init(c, NULL); }
+static inline void ojtn_cond_destroy(ojtn_cond_t* c)   { pthread_cond_destroy(c); }
+static inline void ojtn_cond_wait(ojtn_cond_t* c, ojtn_mutex_t* m) { pthread_cond_wait(c, m); }
+static inline void ojtn_cond_signal(ojtn_cond_t* c)    { pthread_cond_signal(c); }
+static inline void ojtn_cond_broadcast(ojtn_cond_t* c) { pthread_cond_broadcast(c); }
+
+typedef pthread_t ojtn_thread_t;
+typedef struct { void (*fn)(void*); void* arg; } ojtn_thread_start_t;
+
+static inline void* ojtn_thread_main(void* param) {
+    ojtn_thread_start_t start = *(ojtn_thread_start_t*)param;
+    free(param);
+    start.fn(start.arg);
+    return NULL;
+}
+
+static inline int ojtn_thread_create(ojtn_thread_t* t, void (*fn)(void*), void* arg) {
+    ojtn_thread_start_t* start = (ojtn_thread_start_t*)malloc(sizeof(ojtn_thread_start_t));
+    if (!start) return -1;
+    start->fn = fn;
+    start->arg = arg;
+    if (pthread_create(t, NULL, ojtn_thread_main, start) != 0) {
+        free(start);
+        return -1;
+    }
+    return 0;
+}
+static inline void ojtn_thread_join(ojtn_thread_t t) {
+    pthread_join(t, NULL);
+}
+
+static inline int ojtn_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+#endif
+
+#endif /* OPENJTALK_NATIVE_THREAD_H */
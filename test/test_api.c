@@ -51,6 +51,40 @@ void test_null_handling(void) {
     openjtalk_native_free_prosody_result(NULL);
     ASSERT(1, "free_prosody_result NULL does not crash");
 
+    /* Extract labels with NULL handle should return NULL */
+    OpenJTalkNativeLabelResult* labels = openjtalk_native_extract_labels(NULL, "test");
+    ASSERT(labels == NULL, "extract_labels with NULL handle returns NULL");
+
+    /* Free NULL label result should not crash */
+    openjtalk_native_free_label_result(NULL);
+    ASSERT(1, "free_label_result NULL does not crash");
+
+    /* Analysis with NULL handle/analysis should return NULL */
+    ASSERT(openjtalk_native_analyze_text(NULL, "test") == NULL, "analyze_text with NULL handle returns NULL");
+    ASSERT(openjtalk_native_render_phonemes(NULL, NULL) == NULL, "render_phonemes with NULL returns NULL");
+    ASSERT(openjtalk_native_render_prosody(NULL, NULL) == NULL, "render_prosody with NULL returns NULL");
+    ASSERT(openjtalk_native_render_labels(NULL, NULL) == NULL, "render_labels with NULL returns NULL");
+    openjtalk_native_free_analysis(NULL);
+    ASSERT(1, "free_analysis NULL does not crash");
+
+    /* Reading with NULL handle should return NULL */
+    ASSERT(openjtalk_native_get_reading(NULL, "test") == NULL, "get_reading with NULL handle returns NULL");
+    ASSERT(openjtalk_native_phonemize_with_reading(NULL, "test") == NULL, "phonemize_with_reading with NULL handle returns NULL");
+
+    /* Reusable results with NULL handle should fail; clearing NULL is a no-op */
+    OpenJTalkNativePhonemeResult reused = {0};
+    ASSERT(openjtalk_native_phonemize_into(NULL, "test", &reused) == OPENJTALK_NATIVE_ERROR_INVALID_HANDLE,
+        "phonemize_into with NULL handle returns INVALID_HANDLE");
+    openjtalk_native_clear_result(NULL);
+    openjtalk_native_clear_prosody_result(NULL);
+
+    /* Metrics with NULL handle should report nothing */
+    ASSERT(openjtalk_native_render_metrics(NULL, NULL, 0) == 0, "render_metrics with NULL handle returns 0");
+
+    /* Warm-up with NULL handle should fail */
+    ASSERT(openjtalk_native_warmup(NULL, OPENJTALK_NATIVE_WARMUP_PIPELINE, NULL, 0) == OPENJTALK_NATIVE_ERROR_INVALID_HANDLE,
+        "warmup with NULL handle returns INVALID_HANDLE");
+
     /* Free NULL string should not crash */
     openjtalk_native_free_string(NULL);
     ASSERT(1, "free_string NULL does not crash");
@@ -128,6 +162,94 @@ void test_error_string_coverage(void) {
         "error string for INVALID_DICTIONARY");
     ASSERT(strcmp(openjtalk_native_get_error_string(OPENJTALK_NATIVE_ERROR_INVALID_UTF8), "Invalid UTF-8") == 0,
         "error string for INVALID_UTF8");
+    ASSERT(strcmp(openjtalk_native_get_error_string(OPENJTALK_NATIVE_ERROR_CONNECTION), "Server connection failed") == 0,
+        "error string for CONNECTION");
+}
+
+void test_label_metadata(void) {
+    printf("\n--- test_label_metadata ---\n");
+
+    const char* name = openjtalk_native_get_label_field_name(OPENJTALK_NATIVE_LABEL_A1);
+    ASSERT(name != NULL && strcmp(name, "A1") == 0, "field name for LABEL_A1 is 'A1'");
+    name = openjtalk_native_get_label_field_name(OPENJTALK_NATIVE_LABEL_K3);
+    ASSERT(name != NULL && strcmp(name, "K3") == 0, "field name for LABEL_K3 is 'K3'");
+    ASSERT(openjtalk_native_get_label_field_name(-1) == NULL, "field name for -1 is NULL");
+    ASSERT(openjtalk_native_get_label_field_name(OPENJTALK_NATIVE_LABEL_FIELD_COUNT) == NULL,
+        "field name for FIELD_COUNT is NULL");
+
+    const char* symbol = openjtalk_native_get_phoneme_symbol(0);
+    ASSERT(symbol != NULL && strcmp(symbol, "pau") == 0, "phoneme ID 0 is 'pau'");
+    ASSERT(openjtalk_native_get_phoneme_symbol(-1) == NULL, "phoneme ID -1 is NULL");
+    ASSERT(openjtalk_native_get_phoneme_symbol(1000) == NULL, "phoneme ID 1000 is NULL");
+}
+
+void test_engine_null(void) {
+    printf("\n--- test_engine_null ---\n");
+
+    void* engine = openjtalk_native_engine_create(NULL, 2);
+    ASSERT(engine == NULL, "engine_create with NULL path returns NULL");
+
+    engine = openjtalk_native_engine_create("/nonexistent/path/to/dict", 2);
+    ASSERT(engine == NULL, "engine_create with invalid path returns NULL");
+
+    ASSERT(openjtalk_native_engine_phonemize_document(NULL, "テスト") == NULL, "phonemize_document with NULL engine returns NULL");
+    ASSERT(openjtalk_native_engine_get_worker_count(NULL) == 0, "get_worker_count with NULL engine returns 0");
+    ASSERT(openjtalk_native_engine_get_worker_cpu(NULL, 0) == -1, "get_worker_cpu with NULL engine returns -1");
+    ASSERT(openjtalk_native_engine_create_with_flags(NULL, 2, OPENJTALK_NATIVE_ENGINE_PIN_WORKERS) == NULL,
+        "engine_create_with_flags with NULL path returns NULL");
+    ASSERT(openjtalk_native_engine_render_metrics(NULL, NULL, 0) == 0, "engine_render_metrics with NULL engine returns 0");
+    ASSERT(openjtalk_native_engine_phonemize_document_with_priority(NULL, "テスト", OPENJTALK_NATIVE_PRIORITY_BULK) == NULL,
+        "phonemize_document_with_priority with NULL engine returns NULL");
+    ASSERT(openjtalk_native_engine_set_option(NULL, "reserved_workers", "1") != OPENJTALK_NATIVE_SUCCESS,
+        "engine_set_option with NULL engine fails");
+
+    openjtalk_native_engine_destroy(NULL);
+    openjtalk_native_free_document_result(NULL);
+    ASSERT(1, "engine_destroy and free_document_result with NULL do not crash");
+}
+
+void test_client_null(void) {
+    printf("\n--- test_client_null ---\n");
+
+    void* client = openjtalk_native_client_connect(NULL);
+    ASSERT(client == NULL, "client_connect with NULL path returns NULL");
+
+    client = openjtalk_native_client_connect("/nonexistent/openjtalk_native.sock");
+    ASSERT(client == NULL, "client_connect without a server returns NULL");
+
+    ASSERT(openjtalk_native_client_phonemize(NULL, "テスト") == NULL, "client_phonemize with NULL client returns NULL");
+    ASSERT(openjtalk_native_client_phonemize_with_prosody(NULL, "テスト") == NULL,
+           "client_phonemize_with_prosody with NULL client returns NULL");
+    ASSERT(openjtalk_native_client_get_last_error(NULL) == OPENJTALK_NATIVE_ERROR_INVALID_HANDLE,
+           "client_get_last_error with NULL client returns INVALID_HANDLE");
+
+    openjtalk_native_client_close(NULL);
+    ASSERT(1, "client_close with NULL does not crash");
+}
+
+void test_serialize_null(void) {
+    printf("\n--- test_serialize_null ---\n");
+
+    ASSERT(openjtalk_native_serialize_result(NULL, NULL, 0) == 0, "serialize_result with NULL returns 0");
+    ASSERT(openjtalk_native_serialize_prosody_result(NULL, NULL, 0) == 0, "serialize_prosody_result with NULL returns 0");
+    ASSERT(openjtalk_native_find_section(NULL, 0, OPENJTALK_NATIVE_SECTION_A1, NULL, NULL) == NULL,
+           "find_section with NULL buffer returns NULL");
+
+    unsigned char garbage[64] = {0};
+    ASSERT(openjtalk_native_find_section(garbage, sizeof(garbage), OPENJTALK_NATIVE_SECTION_A1, NULL, NULL) == NULL,
+           "find_section rejects a buffer without the magic");
+}
+
+void test_memory_stats_null(void) {
+    printf("\n--- test_memory_stats_null ---\n");
+
+    int ret = openjtalk_native_get_memory_stats(NULL, NULL);
+    ASSERT(ret == OPENJTALK_NATIVE_ERROR_INVALID_INPUT, "get_memory_stats with NULL stats returns error");
+
+    OpenJTalkNativeMemoryStats stats;
+    ret = openjtalk_native_get_memory_stats(NULL, &stats);
+    ASSERT(ret == OPENJTALK_NATIVE_SUCCESS, "global get_memory_stats succeeds");
+    ASSERT(stats.context_bytes == 0 && stats.peak_call_bytes == 0, "global stats have no context bytes");
 }
 
 void test_version_format(void) {
@@ -174,6 +296,11 @@ int main(void) {
     test_error_codes();
     test_error_string_coverage();
     test_invalid_dict();
+    test_label_metadata();
+    test_memory_stats_null();
+    test_engine_null();
+    test_client_null();
+    test_serialize_null();
     test_option_handling();
     test_legacy_api();
 
@@ -0,0 +1,362 @@
+/*
+ * Golden-output regression harness.
+ *
+ * Phonemizes every line of a corpus and compares phonemes, phoneme IDs,
+ * A1/A2/A3 and prosody symbols byte for byte against a checked-in golden
+ * file, through each path that must give the same output:
+ *
+ *   default        openjtalk_native_phonemize() and _phonemize_with_prosody()
+ *   word_cache     the same with word_cache on
+ *   reuse          _phonemize_into() and _phonemize_with_prosody_into() on
+ *                  one pair of results for the whole corpus
+ *
+ * With -r or -b it then times the default path: -r records the measured
+ * throughput as a baseline, -b fails when throughput falls more than the
+ * allowed slowdown (-s) below a recorded one. Baselines only compare runs
+ * on the same machine and build type.
+ *
+ * Golden file: one line per non-empty corpus line,
+ *   phonemes <TAB> ids <TAB> a1 <TAB> a2 <TAB> a3 <TAB> prosody_symbols
+ * with comma-separated integers, or "error <code>" for a failed call.
+ * After an intended output change, regenerate it with -u against the
+ * dictionary the tests use and review the diff. A missing golden file is a
+ * failure; only a missing dictionary skips.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "openjtalk_native.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#define MAX_REPORTED_MISMATCHES 5
+
+static int tests_run = 0;
+static int tests_passed = 0;
+
+#define ASSERT(cond, msg) do { \
+    tests_run++; \
+    if (cond) { \
+        tests_passed++; \
+        printf("  PASS: %s\n", msg); \
+    } else { \
+        printf("  FAIL: %s\n", msg); \
+    } \
+} while(0)
+
+typedef struct {
+    char* data;
+    size_t len;
+    size_t capacity;
+} Buffer;
+
+static double now_seconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#endif
+}
+
+static void append(Buffer* b, const char* s, size_t n) {
+    if (b->len + n + 1 > b->capacity) {
+        size_t capacity = b->capacity ? b->capacity : 256;
+        while (b->len + n + 1 > capacity) capacity *= 2;
+        char* data = (char*)realloc(b->data, capacity);
+        if (!data) {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+        b->data = data;
+        b->capacity = capacity;
+    }
+    memcpy(b->data + b->len, s, n);
+    b->len += n;
+    b->data[b->len] = '\0';
+}
+
+static void append_str(Buffer* b, const char* s) {
+    append(b, s, strlen(s));
+}
+
+static void append_ints(Buffer* b, const int* values, int count) {
+    char number[16];
+    append(b, "\t", 1);
+    for (int i = 0; i < count; i++) {
+        int n = snprintf(number, sizeof(number), i ? ",%d" : "%d", values[i]);
+        append(b, number, (size_t)n);
+    }
+}
+
+/* Load one entry per non-empty line; returns the count, or -1 if the file cannot be read */
+static int load_lines(const char* path, char*** lines) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return -1;
+    int count = 0, capacity = 0;
+    Buffer line = { NULL, 0, 0 };
+    int c;
+    do {
+        c = fgetc(f);
+        if (c != '\n' && c != EOF) {
+            if (c != '\r') {
+                char ch = (char)c;
+                append(&line, &ch, 1);
+            }
+            continue;
+        }
+        if (line.len == 0) continue;
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 256;
+            *lines = (char**)realloc(*lines, (size_t)capacity * sizeof(char*));
+        }
+        (*lines)[count++] = line.data;
+        line.data = NULL;
+        line.len = line.capacity = 0;
+    } while (c != EOF);
+    fclose(f);
+    return count;
+}
+
+static void free_lines(char** lines, int count) {
+    for (int i = 0; i < count; i++) free(lines[i]);
+    free(lines);
+}
+
+/* Golden record of one text; error is the first failed call's code */
+static void format_record(Buffer* b, const OpenJTalkNativePhonemeResult* plain, const OpenJTalkNativeProsodyResult* prosody,
+                          int error) {
+    b->len = 0;
+    if (error != OPENJTALK_NATIVE_SUCCESS) {
+        char text[32];
+        snprintf(text, sizeof(text), "error %d", error);
+        append_str(b, text);
+        return;
+    }
+    append_str(b, plain->phonemes);
+    append_ints(b, plain->phoneme_ids, plain->phoneme_count);
+    append_ints(b, prosody->prosody_a1, prosody->phoneme_count);
+    append_ints(b, prosody->prosody_a2, prosody->phoneme_count);
+    append_ints(b, prosody->prosody_a3, prosody->phoneme_count);
+    append(b, "\t", 1);
+    append_str(b, prosody->prosody_symbols);
+}
+
+static void record_fresh(void* handle, const char* text, Buffer* b) {
+    OpenJTalkNativePhonemeResult* plain = openjtalk_native_phonemize(handle, text);
+    int error = plain ? OPENJTALK_NATIVE_SUCCESS : openjtalk_native_get_last_error(handle);
+    OpenJTalkNativeProsodyResult* prosody = NULL;
+    if (!error) {
+        prosody = openjtalk_native_phonemize_with_prosody(handle, text);
+        error = prosody ? OPENJTALK_NATIVE_SUCCESS : openjtalk_native_get_last_error(handle);
+    }
+    format_record(b, plain, prosody, error);
+    openjtalk_native_free_result(plain);
+    openjtalk_native_free_prosody_result(prosody);
+}
+
+static void record_reused(void* handle, const char* text, Buffer* b, OpenJTalkNativePhonemeResult* plain,
+                          OpenJTalkNativeProsodyResult* prosody) {
+    int error = openjtalk_native_phonemize_into(handle, text, plain);
+    if (!error) error = openjtalk_native_phonemize_with_prosody_into(handle, text, prosody);
+    format_record(b, plain, prosody, error);
+}
+
+static int write_golden(void* handle, char** texts, int count, const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+    Buffer record = { NULL, 0, 0 };
+    for (int i = 0; i < count; i++) {
+        record_fresh(handle, texts[i], &record);
+        fwrite(record.data, 1, record.len, f);
+        fputc('\n', f);
+    }
+    fclose(f);
+    free(record.data);
+    printf("Wrote %d records to %s\n", count, path);
+    return 0;
+}
+
+/* Run one path over the corpus; returns the number of mismatching records */
+static int check_path(void* handle, const char* name, int reuse, char** texts, char** golden, int count) {
+    printf("\n--- %s ---\n", name);
+
+    OpenJTalkNativePhonemeResult plain;
+    OpenJTalkNativeProsodyResult prosody;
+    memset(&plain, 0, sizeof(plain));
+    memset(&prosody, 0, sizeof(prosody));
+    Buffer record = { NULL, 0, 0 };
+    int mismatches = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (reuse) record_reused(handle, texts[i], &record, &plain, &prosody);
+        else record_fresh(handle, texts[i], &record);
+        if (strcmp(record.data, golden[i]) == 0) continue;
+
+        if (++mismatches <= MAX_REPORTED_MISMATCHES) {
+            printf("  text %d: %s\n    expected: %s\n    actual:   %s\n", i + 1, texts[i], golden[i], record.data);
+        }
+    }
+
+    openjtalk_native_clear_result(&plain);
+    openjtalk_native_clear_prosody_result(&prosody);
+    free(record.data);
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%s: %d/%d records match", name, count - mismatches, count);
+    ASSERT(mismatches == 0, msg);
+    return mismatches;
+}
+
+/* Texts per second over the default path */
+static double measure_throughput(void* handle, char** texts, int count, int iterations) {
+    double start = now_seconds();
+    for (int n = 0; n < iterations; n++) {
+        for (int i = 0; i < count; i++) {
+            openjtalk_native_free_result(openjtalk_native_phonemize(handle, texts[i]));
+            openjtalk_native_free_prosody_result(openjtalk_native_phonemize_with_prosody(handle, texts[i]));
+        }
+    }
+    return (double)count * iterations / (now_seconds() - start);
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+        "Usage: %s -c CORPUS -g GOLDEN [-u] [-n ITERATIONS] [-b BASELINE] [-s MAX_SLOWDOWN] [-r RECORD]\n"
+        "  -c CORPUS       one text per line\n"
+        "  -g GOLDEN       golden records to compare against\n"
+        "  -u              write GOLDEN from the current output instead of comparing\n"
+        "  -n ITERATIONS   timed passes over the corpus (default: 3)\n"
+        "  -b BASELINE     file holding a previous texts/sec figure\n"
+        "  -s MAX_SLOWDOWN allowed throughput drop below BASELINE, as a fraction (default: 0.10)\n"
+        "  -r RECORD       write the measured texts/sec to RECORD\n"
+        "The dictionary is taken from OPENJTALK_DICT.\n",
+        argv0);
+}
+
+int main(int argc, char** argv) {
+    const char* corpus_path = NULL;
+    const char* golden_path = NULL;
+    const char* baseline_path = NULL;
+    const char* record_path = NULL;
+    int update = 0;
+    int iterations = 3;
+    double max_slowdown = 0.10;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "-c") == 0) corpus_path = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "-g") == 0) golden_path = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "-n") == 0) iterations = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-b") == 0) baseline_path = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "-s") == 0) max_slowdown = atof(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-r") == 0) record_path = argv[++i];
+        else if (strcmp(argv[i], "-u") == 0) update = 1;
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!corpus_path || !golden_path || iterations <= 0 || max_slowdown < 0.0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    printf("=== openjtalk_native Golden Output Tests ===\n");
+    printf("Version: %s\n", openjtalk_native_get_version());
+
+    const char* dict_path = getenv("OPENJTALK_DICT");
+    if (!dict_path) {
+        dict_path = "../external/open_jtalk_dic_utf_8-1.11";
+    }
+    printf("Dictionary path: %s\n", dict_path);
+
+    char** texts = NULL;
+    int count = load_lines(corpus_path, &texts);
+    if (count <= 0) {
+        fprintf(stderr, "no texts in %s\n", corpus_path);
+        return 1;
+    }
+
+    void* handle = openjtalk_native_create(dict_path);
+    if (!handle) {
+        printf("SKIP: Could not create OpenJTalk instance (dictionary not found)\n");
+        printf("Set OPENJTALK_DICT environment variable to the dictionary path\n");
+        free_lines(texts, count);
+        return 0;  /* Skip gracefully if no dictionary */
+    }
+
+    if (update) {
+        int failed = write_golden(handle, texts, count, golden_path);
+        openjtalk_native_destroy(handle);
+        free_lines(texts, count);
+        return failed;
+    }
+
+    char** golden = NULL;
+    int golden_count = load_lines(golden_path, &golden);
+    char msg[256];
+    snprintf(msg, sizeof(msg), "golden file %s present", golden_path);
+    ASSERT(golden_count >= 0, msg);
+    if (golden_count < 0) printf("  Create it with -u against the pinned dictionary, review it and check it in\n");
+    if (golden_count >= 0) {
+        snprintf(msg, sizeof(msg), "golden file has one record per text (%d/%d)", golden_count, count);
+        ASSERT(golden_count == count, msg);
+    }
+
+    if (golden_count == count) {
+        printf("Corpus: %s (%d texts)\n", corpus_path, count);
+        check_path(handle, "default", 0, texts, golden, count);
+
+        openjtalk_native_set_option(handle, "word_cache", "1");
+        check_path(handle, "word_cache", 0, texts, golden, count);
+        openjtalk_native_set_option(handle, "word_cache", "0");
+
+        check_path(handle, "reuse", 1, texts, golden, count);
+    }
+
+    if (golden_count == count && (record_path || baseline_path)) {
+        printf("\n--- throughput ---\n");
+        double rate = measure_throughput(handle, texts, count, iterations);
+        printf("  texts/sec=%.0f iterations=%d\n", rate, iterations);
+
+        if (record_path) {
+            FILE* f = fopen(record_path, "wb");
+            ASSERT(f != NULL, "throughput recorded");
+            if (f) {
+                fprintf(f, "%.0f\n", rate);
+                fclose(f);
+            }
+        }
+        if (baseline_path) {
+            FILE* f = fopen(baseline_path, "rb");
+            double baseline = 0.0;
+            ASSERT(f && fscanf(f, "%lf", &baseline) == 1 && baseline > 0.0, "baseline readable");
+            if (f) fclose(f);
+            if (baseline > 0.0) {
+                double slowdown = 1.0 - rate / baseline;
+                snprintf(msg, sizeof(msg), "throughput %.0f vs baseline %.0f texts/sec (%+.1f%%, limit -%.1f%%)",
+                         rate, baseline, -slowdown * 100.0, max_slowdown * 100.0);
+                ASSERT(slowdown <= max_slowdown, msg);
+            }
+        }
+    }
+
+    openjtalk_native_destroy(handle);
+    free_lines(golden, golden_count);
+    free_lines(texts, count);
+
+    printf("\n=== Results: %d/%d passed ===\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
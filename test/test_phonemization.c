@@ -29,6 +29,17 @@ static void test_phonemize(void* handle, const char* text, const char* test_name
         ASSERT(result->durations != NULL, "durations is not NULL");
         ASSERT(result->total_duration > 0.0f, "total_duration > 0");
 
+        if (result->phonemes && result->phoneme_ids) {
+            /* IDs index the phoneme inventory and spell out the phoneme string */
+            char rebuilt[8192] = {0};
+            for (int i = 0; i < result->phoneme_count; i++) {
+                const char* symbol = openjtalk_native_get_phoneme_symbol(result->phoneme_ids[i]);
+                if (i > 0) strcat(rebuilt, " ");
+                strcat(rebuilt, symbol ? symbol : "?");
+            }
+            ASSERT(strcmp(rebuilt, result->phonemes) == 0, "phoneme_ids spell the phoneme string");
+        }
+
         if (result->phonemes) {
             printf("  Phonemes: %s\n", result->phonemes);
             printf("  Count: %d\n", result->phoneme_count);
@@ -38,6 +49,68 @@ static void test_phonemize(void* handle, const char* text, const char* test_name
     }
 }
 
+static void test_phoneme_ids(void* handle) {
+    printf("\n--- test_phoneme_ids ---\n");
+
+    const char* text = "きゃっかんてきにみて、ぎゅうにゅうはおいしい";
+    OpenJTalkNativePhonemeResult* result = openjtalk_native_phonemize(handle, text);
+    ASSERT(result != NULL, "result is not NULL");
+    if (!result) return;
+
+    /* Every phoneme of plain kana text is in the inventory, and each ID
+       names exactly the symbol at its position */
+    int known = 1, match = 1;
+    const char* p = result->phonemes;
+    for (int i = 0; i < result->phoneme_count; i++) {
+        const char* symbol = openjtalk_native_get_phoneme_symbol(result->phoneme_ids[i]);
+        size_t len = strcspn(p, " ");
+        if (!symbol) known = 0;
+        else if (strlen(symbol) != len || strncmp(symbol, p, len) != 0) match = 0;
+        p += len;
+        if (*p == ' ') p++;
+    }
+    ASSERT(known, "no phoneme ID is -1 for kana text");
+    ASSERT(match, "each phoneme ID maps to the symbol at its position");
+
+    int pau_id = -1, a_id = -1;
+    for (int id = 0; openjtalk_native_get_phoneme_symbol(id); id++) {
+        if (strcmp(openjtalk_native_get_phoneme_symbol(id), "pau") == 0) pau_id = id;
+        if (strcmp(openjtalk_native_get_phoneme_symbol(id), "a") == 0) a_id = id;
+    }
+    int saw_a = 0, same_a = 1;
+    for (int i = 0; i < result->phoneme_count; i++) {
+        const char* symbol = openjtalk_native_get_phoneme_symbol(result->phoneme_ids[i]);
+        if (symbol && strcmp(symbol, "a") == 0) {
+            saw_a = 1;
+            if (result->phoneme_ids[i] != a_id) same_a = 0;
+        }
+    }
+    ASSERT(saw_a && same_a, "every 'a' carries the inventory ID of 'a'");
+    ASSERT(result->phoneme_count > 0 && result->phoneme_ids[0] == pau_id &&
+           result->phoneme_ids[result->phoneme_count - 1] == pau_id, "utterance edges carry the 'pau' ID");
+
+    /* The serialized PHONEME_IDS section is derived from the string on its
+       own and must agree with the result array */
+    OpenJTalkNativeProsodyResult* prosody = openjtalk_native_phonemize_with_prosody(handle, text);
+    if (prosody) {
+        size_t size = openjtalk_native_serialize_prosody_result(prosody, NULL, 0);
+        unsigned char* buffer = (unsigned char*)malloc(size);
+        openjtalk_native_serialize_prosody_result(prosody, buffer, size);
+        int count = 0;
+        const unsigned char* ids = (const unsigned char*)openjtalk_native_find_section(
+            buffer, size, OPENJTALK_NATIVE_SECTION_PHONEME_IDS, NULL, &count);
+        int agree = ids != NULL && count == result->phoneme_count;
+        for (int i = 0; agree && i < count; i++) {
+            if (ids[i] != result->phoneme_ids[i]) agree = 0;
+        }
+        ASSERT(agree, "phoneme_ids match the serialized phoneme ID section");
+        free(buffer);
+        openjtalk_native_free_prosody_result(prosody);
+    }
+
+    openjtalk_native_free_result(result);
+}
+
 static void test_prosody(void* handle, const char* text, const char* test_name) {
     printf("\n--- %s (prosody): \"%s\" ---\n", test_name, text);
 
@@ -50,6 +123,34 @@ static void test_prosody(void* handle, const char* text, const char* test_name)
         ASSERT(result->prosody_a1 != NULL, "prosody_a1 is not NULL");
         ASSERT(result->prosody_a2 != NULL, "prosody_a2 is not NULL");
         ASSERT(result->prosody_a3 != NULL, "prosody_a3 is not NULL");
+        ASSERT(result->prosody_symbols != NULL, "prosody_symbols is not NULL");
+        ASSERT(result->prosody_marks != NULL, "prosody_marks is not NULL");
+        ASSERT(result->accent_phrase_index != NULL, "accent_phrase_index is not NULL");
+        ASSERT(result->mora_index != NULL, "mora_index is not NULL");
+
+        if (result->prosody_symbols && result->prosody_marks && result->accent_phrase_index && result->mora_index) {
+            size_t len = strlen(result->prosody_symbols);
+            ASSERT(len > 0 && result->prosody_symbols[0] == '^', "prosody symbols start with '^'");
+            ASSERT(len > 0 && (result->prosody_symbols[len - 1] == '$' || result->prosody_symbols[len - 1] == '?'),
+                "prosody symbols end with '$' or '?'");
+
+            /* Symbol count is one per phoneme plus one per mark */
+            int marks = 0;
+            int ordered = 1;
+            int prev_phrase = -1, prev_mora = -1;
+            for (int i = 0; i < result->phoneme_count; i++) {
+                if (result->prosody_marks[i]) marks++;
+                if (result->accent_phrase_index[i] >= 0) {
+                    if (result->accent_phrase_index[i] < prev_phrase || result->mora_index[i] < prev_mora) ordered = 0;
+                    prev_phrase = result->accent_phrase_index[i];
+                    prev_mora = result->mora_index[i];
+                }
+            }
+            ASSERT(result->prosody_symbol_count == result->phoneme_count + marks, "symbol count = phonemes + marks");
+            ASSERT(ordered, "accent phrase and mora indices are non-decreasing");
+            ASSERT(result->accent_phrase_index[0] == -1 && result->mora_index[0] == -1, "leading pau has no phrase/mora");
+            printf("  Symbols: %s\n", result->prosody_symbols);
+        }
 
         if (result->phonemes) {
             printf("  Phonemes: %s\n", result->phonemes);
@@ -60,6 +161,51 @@ static void test_prosody(void* handle, const char* text, const char* test_name)
     }
 }
 
+static void test_labels(void* handle, const char* text) {
+    printf("\n--- test_labels: \"%s\" ---\n", text);
+
+    OpenJTalkNativeLabelResult* labels = openjtalk_native_extract_labels(handle, text);
+    OpenJTalkNativeProsodyResult* prosody = openjtalk_native_phonemize_with_prosody(handle, text);
+    ASSERT(labels != NULL, "label result is not NULL");
+    ASSERT(prosody != NULL, "prosody result is not NULL");
+
+    if (labels && prosody) {
+        ASSERT(labels->field_count == OPENJTALK_NATIVE_LABEL_FIELD_COUNT, "field_count matches FIELD_COUNT");
+        ASSERT(labels->row_count == prosody->phoneme_count, "one row per phoneme");
+
+        const int16_t* p3 = labels->values + OPENJTALK_NATIVE_LABEL_P3 * labels->row_count;
+        const int16_t* a1 = labels->values + OPENJTALK_NATIVE_LABEL_A1 * labels->row_count;
+        const int16_t* a2 = labels->values + OPENJTALK_NATIVE_LABEL_A2 * labels->row_count;
+        const int16_t* a3 = labels->values + OPENJTALK_NATIVE_LABEL_A3 * labels->row_count;
+
+        /* Rebuild the phoneme string from P3 (edge "sil" is reported as "pau") */
+        char rebuilt[8192] = {0};
+        int accents_match = 1;
+        for (int i = 0; i < labels->row_count; i++) {
+            const char* symbol = openjtalk_native_get_phoneme_symbol(p3[i]);
+            if (!symbol) symbol = "?";
+            if (strcmp(symbol, "sil") == 0) symbol = "pau";
+            if (i > 0) strcat(rebuilt, " ");
+            strcat(rebuilt, symbol);
+
+            int v1 = a1[i] == OPENJTALK_NATIVE_LABEL_UNDEFINED ? 0 : a1[i];
+            int v2 = a2[i] == OPENJTALK_NATIVE_LABEL_UNDEFINED ? 0 : a2[i];
+            int v3 = a3[i] == OPENJTALK_NATIVE_LABEL_UNDEFINED ? 0 : a3[i];
+            if (v1 != prosody->prosody_a1[i] || v2 != prosody->prosody_a2[i] || v3 != prosody->prosody_a3[i]) {
+                accents_match = 0;
+            }
+        }
+        ASSERT(strcmp(rebuilt, prosody->phonemes) == 0, "P3 column matches phoneme string");
+        ASSERT(accents_match, "A1/A2/A3 columns match prosody result");
+
+        const int16_t* k3 = labels->values + OPENJTALK_NATIVE_LABEL_K3 * labels->row_count;
+        ASSERT(k3[0] > 0, "K3 (utterance size) is defined on the first row");
+    }
+
+    openjtalk_native_free_label_result(labels);
+    openjtalk_native_free_prosody_result(prosody);
+}
+
 static void test_analyze(void* handle) {
     printf("\n--- test_analyze ---\n");
 
@@ -104,6 +250,1054 @@ static void test_options(void* handle) {
     ASSERT(ret != OPENJTALK_NATIVE_SUCCESS, "set unknown key returns error");
 }
 
+static void test_durations(void* handle, const char* text) {
+    printf("\n--- test_durations: \"%s\" ---\n", text);
+
+    openjtalk_native_set_option(handle, "speech_rate", "1.0");
+    OpenJTalkNativePhonemeResult* normal = openjtalk_native_phonemize(handle, text);
+    openjtalk_native_set_option(handle, "speech_rate", "2.0");
+    OpenJTalkNativePhonemeResult* fast = openjtalk_native_phonemize(handle, text);
+    openjtalk_native_set_option(handle, "speech_rate", "1.0");
+
+    ASSERT(normal != NULL && fast != NULL, "results are not NULL");
+    if (normal && fast) {
+        int positive = 1, distinct = 0;
+        float sum = 0.0f;
+        for (int i = 0; i < normal->phoneme_count; i++) {
+            if (normal->durations[i] <= 0.0f) positive = 0;
+            if (normal->durations[i] != normal->durations[0]) distinct = 1;
+            sum += normal->durations[i];
+        }
+        ASSERT(positive, "every duration > 0");
+        ASSERT(distinct, "durations depend on the phoneme");
+        ASSERT(sum > normal->total_duration - 1e-4f && sum < normal->total_duration + 1e-4f,
+               "total_duration is the sum of durations");
+        ASSERT(fast->phoneme_count == normal->phoneme_count, "speech_rate keeps phoneme count");
+        ASSERT(fast->total_duration > normal->total_duration * 0.5f - 1e-4f &&
+               fast->total_duration < normal->total_duration * 0.5f + 1e-4f,
+               "speech_rate=2.0 halves total_duration");
+        printf("  total_duration: %.3f s (rate 1.0), %.3f s (rate 2.0)\n",
+               normal->total_duration, fast->total_duration);
+    }
+    openjtalk_native_free_result(normal);
+    openjtalk_native_free_result(fast);
+}
+
+/* Normalized input must phonemize exactly like the equivalent written-out text */
+static void test_normalize_numbers(void* handle) {
+    printf("\n--- test_normalize_numbers ---\n");
+
+    static const char* const cases[][2] = {
+        { "2024/01/05に会いましょう", "2024年1月5日に会いましょう" },
+        { "開始は12:30です", "開始は12時30分です" },
+        { "1,234,567円", "1234567円" },
+        { "$12の本", "12ドルの本" },
+        { "あと5kmです", "あと5キロメートルです" },
+        { "湿度は30%", "湿度は30パーセント" },
+        { "090-1234-5678", "ゼロキューゼロのイチニーサンヨンのゴーロクナナハチ" }
+    };
+
+    const char* val = openjtalk_native_get_option(handle, "normalize_numbers");
+    ASSERT(val != NULL && strcmp(val, "0") == 0, "normalize_numbers defaults to '0'");
+
+    /* Off by default, text with digits reads as it did before the option:
+       the default output is the unrewritten text's output */
+    OpenJTalkNativePhonemeResult* before[sizeof(cases) / sizeof(cases[0])];
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        before[i] = openjtalk_native_phonemize(handle, cases[i][0]);
+    }
+    ASSERT(openjtalk_native_set_option(handle, "normalize_numbers", "0") == OPENJTALK_NATIVE_SUCCESS,
+           "set normalize_numbers=0");
+    int unchanged = 1;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        OpenJTalkNativePhonemeResult* off = openjtalk_native_phonemize(handle, cases[i][0]);
+        if (!before[i] || !off || strcmp(before[i]->phonemes, off->phonemes) != 0) unchanged = 0;
+        openjtalk_native_free_result(off);
+    }
+    ASSERT(unchanged, "default output equals normalize_numbers=0 output");
+
+    ASSERT(openjtalk_native_set_option(handle, "normalize_numbers", "1") == OPENJTALK_NATIVE_SUCCESS,
+           "set normalize_numbers=1");
+    int changed = 0;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        OpenJTalkNativePhonemeResult* a = openjtalk_native_phonemize(handle, cases[i][0]);
+        if (a && before[i] && strcmp(a->phonemes, before[i]->phonemes) != 0) changed++;
+        printf("  %s\n    off: %s\n    on:  %s\n", cases[i][0], before[i] ? before[i]->phonemes : "(null)",
+               a ? a->phonemes : "(null)");
+        openjtalk_native_free_result(a);
+        openjtalk_native_free_result(before[i]);
+    }
+    ASSERT(changed > 0, "normalize_numbers=1 changes the reading of digit text");
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        OpenJTalkNativePhonemeResult* a = openjtalk_native_phonemize(handle, cases[i][0]);
+        OpenJTalkNativePhonemeResult* b = openjtalk_native_phonemize(handle, cases[i][1]);
+        char msg[256];
+        snprintf(msg, sizeof(msg), "\"%s\" matches \"%s\"", cases[i][0], cases[i][1]);
+        ASSERT(a && b && strcmp(a->phonemes, b->phonemes) == 0, msg);
+        openjtalk_native_free_result(a);
+        openjtalk_native_free_result(b);
+    }
+
+    /* Text without numbers is untouched either way */
+    const char* text = "今日はいい天気ですね";
+    OpenJTalkNativePhonemeResult* on = openjtalk_native_phonemize(handle, text);
+    ASSERT(openjtalk_native_set_option(handle, "normalize_numbers", "0") == OPENJTALK_NATIVE_SUCCESS,
+           "set normalize_numbers=0");
+    OpenJTalkNativePhonemeResult* off = openjtalk_native_phonemize(handle, text);
+    ASSERT(on && off && strcmp(on->phonemes, off->phonemes) == 0, "no-digit text identical with normalization off");
+    openjtalk_native_free_result(on);
+    openjtalk_native_free_result(off);
+
+    ASSERT(openjtalk_native_set_option(handle, "normalize_numbers", "2") != OPENJTALK_NATIVE_SUCCESS,
+           "normalize_numbers=2 rejected");
+}
+
+static void test_latin_mode(void* handle) {
+    printf("\n--- test_latin_mode ---\n");
+
+    static const char* const spell_cases[][2] = {
+        { "今日はhelloです", "今日はハローです" },
+        { "ＯＫです", "オーケーです" },
+        { "APIを使う", "エーピーアイを使う" },
+        { "getUserNameを呼ぶ", "ゲットユーザーネームを呼ぶ" },
+        { "詳しくはhttps://example.com/docs。", "詳しくはユーアールエル。" },
+        { "ありがとう😀👍🏽", "ありがとう" },
+        { "あと5kmです", "あと5キロメートルです" }
+    };
+    static const char* const skip_cases[][2] = {
+        { "今日はhelloです", "今日はです" },
+        { "見てhttps://example.com/docsね", "見てね" },
+        { "ありがとう❤️", "ありがとう" }
+    };
+
+    const char* val = openjtalk_native_get_option(handle, "latin_mode");
+    ASSERT(val != NULL && strcmp(val, "keep") == 0, "latin_mode defaults to 'keep'");
+
+    /* Units after numbers are read by normalize_numbers, not spelled */
+    openjtalk_native_set_option(handle, "normalize_numbers", "1");
+    ASSERT(openjtalk_native_set_option(handle, "latin_mode", "spell") == OPENJTALK_NATIVE_SUCCESS, "set latin_mode=spell");
+    for (size_t i = 0; i < sizeof(spell_cases) / sizeof(spell_cases[0]); i++) {
+        OpenJTalkNativePhonemeResult* a = openjtalk_native_phonemize(handle, spell_cases[i][0]);
+        OpenJTalkNativePhonemeResult* b = openjtalk_native_phonemize(handle, spell_cases[i][1]);
+        char msg[256];
+        snprintf(msg, sizeof(msg), "spell: \"%s\" matches \"%s\"", spell_cases[i][0], spell_cases[i][1]);
+        ASSERT(a && b && strcmp(a->phonemes, b->phonemes) == 0, msg);
+        openjtalk_native_free_result(a);
+        openjtalk_native_free_result(b);
+    }
+    openjtalk_native_set_option(handle, "normalize_numbers", "0");
+
+    /* Offsets of a spelled word cover the Latin run it replaced */
+    openjtalk_native_set_option(handle, "alignment", "1");
+    const char* text = "今日はhelloです";
+    OpenJTalkNativeProsodyResult* aligned = openjtalk_native_phonemize_with_prosody(handle, text);
+    ASSERT(aligned && aligned->source_start, "spelled text has offsets");
+    if (aligned && aligned->source_start) {
+        int ok = 1;
+        for (int i = 0; i < aligned->phoneme_count; i++) {
+            if (aligned->source_start[i] < 0 || aligned->source_end[i] > (int)strlen(text)) ok = 0;
+        }
+        ASSERT(ok, "offsets stay inside the input");
+    }
+    openjtalk_native_free_prosody_result(aligned);
+    openjtalk_native_set_option(handle, "alignment", "0");
+
+    ASSERT(openjtalk_native_set_option(handle, "latin_mode", "skip") == OPENJTALK_NATIVE_SUCCESS, "set latin_mode=skip");
+    for (size_t i = 0; i < sizeof(skip_cases) / sizeof(skip_cases[0]); i++) {
+        OpenJTalkNativePhonemeResult* a = openjtalk_native_phonemize(handle, skip_cases[i][0]);
+        OpenJTalkNativePhonemeResult* b = openjtalk_native_phonemize(handle, skip_cases[i][1]);
+        char msg[256];
+        snprintf(msg, sizeof(msg), "skip: \"%s\" matches \"%s\"", skip_cases[i][0], skip_cases[i][1]);
+        ASSERT(a && b && strcmp(a->phonemes, b->phonemes) == 0, msg);
+        openjtalk_native_free_result(a);
+        openjtalk_native_free_result(b);
+    }
+
+    /* Nothing left to read is an empty input */
+    OpenJTalkNativePhonemeResult* empty = openjtalk_native_phonemize(handle, "hello😀");
+    ASSERT(empty == NULL && openjtalk_native_get_last_error(handle) == OPENJTALK_NATIVE_ERROR_INVALID_INPUT,
+           "fully skipped text returns INVALID_INPUT");
+    openjtalk_native_free_result(empty);
+
+    /* Near the input limit number readings no longer fit; the numbers stay
+       as written but Latin runs, URLs and emoji are still skipped */
+    char long_text[4096 + 1] = {0};
+    strcat(long_text, "https://example.com ");
+    while (strlen(long_text) + 20 < 4096) strcat(long_text, "5km hello😀 ");
+    openjtalk_native_set_option(handle, "normalize_numbers", "1");
+    OpenJTalkNativePhonemeResult* crowded = openjtalk_native_phonemize(handle, long_text);
+    openjtalk_native_set_option(handle, "normalize_numbers", "0");
+    OpenJTalkNativePhonemeResult* plain_numbers = openjtalk_native_phonemize(handle, long_text);
+    ASSERT(crowded && plain_numbers && strcmp(crowded->phonemes, plain_numbers->phonemes) == 0,
+           "skip still applies when number readings overflow");
+    openjtalk_native_free_result(crowded);
+    openjtalk_native_free_result(plain_numbers);
+
+    /* A spelled-out form past the limit fails instead of reaching MeCab raw */
+    char acronyms[4096 + 1] = {0};
+    while (strlen(acronyms) + 8 < 4096) strcat(acronyms, "APIとSDK");
+    openjtalk_native_set_option(handle, "latin_mode", "spell");
+    OpenJTalkNativePhonemeResult* overflow = openjtalk_native_phonemize(handle, acronyms);
+    ASSERT(overflow == NULL && openjtalk_native_get_last_error(handle) == OPENJTALK_NATIVE_ERROR_INVALID_INPUT,
+           "spelled text past the input limit returns INVALID_INPUT");
+    openjtalk_native_free_result(overflow);
+
+    ASSERT(openjtalk_native_set_option(handle, "latin_mode", "drop") != OPENJTALK_NATIVE_SUCCESS, "latin_mode=drop rejected");
+    openjtalk_native_set_option(handle, "latin_mode", "keep");
+}
+
+/* True if the phoneme string has a devoiced (uppercase) vowel */
+static int has_devoiced_vowel(const char* phonemes) {
+    for (const char* p = phonemes; *p; p++) {
+        if (strchr("AIUEO", *p) && (p == phonemes || p[-1] == ' ') && (p[1] == ' ' || p[1] == '\0')) return 1;
+    }
+    return 0;
+}
+
+static void test_njd_stages(void* handle) {
+    printf("\n--- test_njd_stages ---\n");
+    const char* text = "今日はいい天気ですね、明日は雨でしょうか";
+
+    const char* val = openjtalk_native_get_option(handle, "njd_stages");
+    ASSERT(val != NULL && strcmp(val, "63") == 0, "njd_stages defaults to 63 (full)");
+
+    ASSERT(openjtalk_native_set_option(handle, "njd_stages", "phonemes") == OPENJTALK_NATIVE_SUCCESS,
+           "set njd_stages=phonemes");
+    val = openjtalk_native_get_option(handle, "njd_stages");
+    ASSERT(val != NULL && atoi(val) == OPENJTALK_NATIVE_STAGES_PHONEMES, "phonemes profile mask readback");
+
+    OpenJTalkNativePhonemeResult* plain = openjtalk_native_phonemize(handle, text);
+    ASSERT(plain != NULL && plain->phoneme_count > 0, "phonemize with phonemes profile");
+    if (plain) {
+        ASSERT(!has_devoiced_vowel(plain->phonemes), "phonemes profile has no devoiced vowels");
+        printf("  Phonemes: %s\n", plain->phonemes);
+    }
+    openjtalk_native_free_result(plain);
+
+    ASSERT(openjtalk_native_set_option(handle, "njd_stages", "reading") == OPENJTALK_NATIVE_SUCCESS,
+           "set njd_stages=reading");
+    char* reading = openjtalk_native_get_reading(handle, text);
+    ASSERT(reading != NULL && reading[0] != '\0', "get_reading returns a non-empty reading");
+    if (reading) printf("  Reading: %s\n", reading);
+    openjtalk_native_free_string(reading);
+
+    ASSERT(openjtalk_native_set_option(handle, "njd_stages", "64") != OPENJTALK_NATIVE_SUCCESS,
+           "njd_stages=64 rejected");
+    ASSERT(openjtalk_native_set_option(handle, "njd_stages", "fast") != OPENJTALK_NATIVE_SUCCESS,
+           "njd_stages=fast rejected");
+
+    /* Full pipeline again: get_reading is unaffected by the label stages */
+    ASSERT(openjtalk_native_set_option(handle, "njd_stages", "full") == OPENJTALK_NATIVE_SUCCESS,
+           "set njd_stages=full");
+    reading = openjtalk_native_get_reading(handle, "こんにちは");
+    ASSERT(reading != NULL && reading[0] != '\0', "get_reading with full stages");
+    openjtalk_native_free_string(reading);
+
+    OpenJTalkNativeMemoryStats stats;
+    openjtalk_native_get_memory_stats(NULL, &stats);
+    ASSERT(stats.result_bytes_outstanding == 0, "reading strings are accounted and released");
+}
+
+/* One analysis rendered several times must match the direct calls */
+static void test_analysis_reuse(void* handle, const char* text) {
+    printf("\n--- test_analysis_reuse: \"%s\" ---\n", text);
+
+    OpenJTalkNativeMemoryStats before;
+    openjtalk_native_get_memory_stats(NULL, &before);
+
+    void* analysis = openjtalk_native_analyze_text(handle, text);
+    ASSERT(analysis != NULL, "analyze_text returns an analysis");
+    if (!analysis) return;
+
+    OpenJTalkNativePhonemeResult* direct = openjtalk_native_phonemize(handle, text);
+    OpenJTalkNativePhonemeResult* rendered = openjtalk_native_render_phonemes(handle, analysis);
+    ASSERT(direct && rendered && strcmp(direct->phonemes, rendered->phonemes) == 0,
+           "rendered phonemes match phonemize");
+    ASSERT(direct && rendered && direct->total_duration == rendered->total_duration,
+           "rendered durations match phonemize");
+
+    openjtalk_native_set_option(handle, "speech_rate", "2.0");
+    OpenJTalkNativePhonemeResult* fast = openjtalk_native_render_phonemes(handle, analysis);
+    openjtalk_native_set_option(handle, "speech_rate", "1.0");
+    ASSERT(rendered && fast && strcmp(rendered->phonemes, fast->phonemes) == 0, "speech_rate render keeps phonemes");
+    ASSERT(rendered && fast && fast->total_duration < rendered->total_duration, "speech_rate render shortens durations");
+
+    OpenJTalkNativeProsodyResult* direct_prosody = openjtalk_native_phonemize_with_prosody(handle, text);
+    OpenJTalkNativeProsodyResult* rendered_prosody = openjtalk_native_render_prosody(handle, analysis);
+    ASSERT(direct_prosody && rendered_prosody &&
+           strcmp(direct_prosody->prosody_symbols, rendered_prosody->prosody_symbols) == 0,
+           "rendered prosody matches phonemize_with_prosody");
+
+    OpenJTalkNativeLabelResult* direct_labels = openjtalk_native_extract_labels(handle, text);
+    OpenJTalkNativeLabelResult* rendered_labels = openjtalk_native_render_labels(handle, analysis);
+    ASSERT(direct_labels && rendered_labels && direct_labels->row_count == rendered_labels->row_count &&
+           memcmp(direct_labels->values, rendered_labels->values,
+                  (size_t)direct_labels->row_count * direct_labels->field_count * sizeof(int16_t)) == 0,
+           "rendered labels match extract_labels");
+
+    /* Changing njd_stages rebuilds labels from the snapshot */
+    openjtalk_native_set_option(handle, "njd_stages", "phonemes");
+    OpenJTalkNativePhonemeResult* plain_direct = openjtalk_native_phonemize(handle, text);
+    OpenJTalkNativePhonemeResult* plain_rendered = openjtalk_native_render_phonemes(handle, analysis);
+    openjtalk_native_set_option(handle, "njd_stages", "full");
+    OpenJTalkNativePhonemeResult* full_again = openjtalk_native_render_phonemes(handle, analysis);
+    ASSERT(plain_direct && plain_rendered && strcmp(plain_direct->phonemes, plain_rendered->phonemes) == 0,
+           "render with phonemes profile matches phonemize");
+    ASSERT(direct && full_again && strcmp(direct->phonemes, full_again->phonemes) == 0,
+           "render after switching back to full matches phonemize");
+
+    /* Stage sets that share a prefix resume from it; every switch still
+       renders exactly what phonemize gives for that set */
+    static const char* const profiles[] = { "phonemes", "full", "reading", "full", "62", "phonemes", "full", "63" };
+    int resumed_ok = 1;
+    for (size_t i = 0; i < sizeof(profiles) / sizeof(profiles[0]); i++) {
+        openjtalk_native_set_option(handle, "njd_stages", profiles[i]);
+        OpenJTalkNativeLabelResult* want = openjtalk_native_extract_labels(handle, text);
+        OpenJTalkNativeLabelResult* got = openjtalk_native_render_labels(handle, analysis);
+        if (!want || !got || want->row_count != got->row_count ||
+            memcmp(want->values, got->values, (size_t)want->row_count * want->field_count * sizeof(int16_t)) != 0) {
+            printf("  njd_stages=%s differs\n", profiles[i]);
+            resumed_ok = 0;
+        }
+        openjtalk_native_free_label_result(want);
+        openjtalk_native_free_label_result(got);
+    }
+    openjtalk_native_set_option(handle, "njd_stages", "full");
+    ASSERT(resumed_ok, "renders across stage switches match extract_labels");
+
+    openjtalk_native_free_result(direct);
+    openjtalk_native_free_result(rendered);
+    openjtalk_native_free_result(fast);
+    openjtalk_native_free_result(plain_direct);
+    openjtalk_native_free_result(plain_rendered);
+    openjtalk_native_free_result(full_again);
+    openjtalk_native_free_prosody_result(direct_prosody);
+    openjtalk_native_free_prosody_result(rendered_prosody);
+    openjtalk_native_free_label_result(direct_labels);
+    openjtalk_native_free_label_result(rendered_labels);
+    openjtalk_native_free_analysis(analysis);
+
+    OpenJTalkNativeMemoryStats after;
+    openjtalk_native_get_memory_stats(NULL, &after);
+    ASSERT(after.result_bytes_outstanding == before.result_bytes_outstanding, "analysis bytes released on free");
+}
+
+static void test_word_cache(void* handle, const char* dict_path) {
+    printf("\n--- test_word_cache ---\n");
+
+    const char* text = "今日はいい天気ですね。明日もいい天気でしょう";
+
+    int ret = openjtalk_native_set_option(handle, "word_cache", "0");
+    ASSERT(ret == OPENJTALK_NATIVE_SUCCESS, "disable word_cache");
+    OpenJTalkNativePhonemeResult* uncached = openjtalk_native_phonemize(handle, text);
+
+    ret = openjtalk_native_set_option(handle, "word_cache", "1");
+    ASSERT(ret == OPENJTALK_NATIVE_SUCCESS, "enable word_cache");
+    const char* val = openjtalk_native_get_option(handle, "word_cache");
+    ASSERT(val != NULL && strcmp(val, "1") == 0, "word_cache readback is '1'");
+
+    OpenJTalkNativePhonemeResult* cold = openjtalk_native_phonemize(handle, text);
+    OpenJTalkNativePhonemeResult* warm = openjtalk_native_phonemize(handle, text);
+
+    /* A second handle on the same dictionary hits the shared cache */
+    void* other = openjtalk_native_create(dict_path);
+    val = other ? openjtalk_native_get_option(other, "word_cache") : NULL;
+    ASSERT(val != NULL && strcmp(val, "0") == 0, "word_cache is off by default");
+    if (other) openjtalk_native_set_option(other, "word_cache", "1");
+    OpenJTalkNativePhonemeResult* shared = other ? openjtalk_native_phonemize(other, text) : NULL;
+
+    ASSERT(uncached && cold && warm && shared, "cached and uncached results are not NULL");
+    if (uncached && cold && warm && shared) {
+        ASSERT(strcmp(uncached->phonemes, cold->phonemes) == 0, "cold cache matches uncached output");
+        ASSERT(strcmp(uncached->phonemes, warm->phonemes) == 0, "warm cache matches uncached output");
+        ASSERT(strcmp(uncached->phonemes, shared->phonemes) == 0, "shared cache matches uncached output");
+    }
+
+    ret = openjtalk_native_set_option(handle, "word_cache", "yes");
+    ASSERT(ret != OPENJTALK_NATIVE_SUCCESS, "word_cache=yes rejected");
+
+    openjtalk_native_free_result(uncached);
+    openjtalk_native_free_result(cold);
+    openjtalk_native_free_result(warm);
+    openjtalk_native_free_result(shared);
+    openjtalk_native_destroy(other);
+}
+
+static void test_memory_stats(void* handle) {
+    printf("\n--- test_memory_stats ---\n");
+
+    OpenJTalkNativeMemoryStats before, during, after;
+    ASSERT(openjtalk_native_get_memory_stats(handle, &before) == OPENJTALK_NATIVE_SUCCESS, "get_memory_stats succeeds");
+    ASSERT(before.dictionary_shared_bytes > 0, "dictionary_shared_bytes > 0");
+    ASSERT(before.context_bytes > 0, "context_bytes > 0");
+
+    OpenJTalkNativeProsodyResult* result = openjtalk_native_phonemize_with_prosody(handle, "今日はいい天気ですね");
+    ASSERT(result != NULL, "prosody result is not NULL");
+    openjtalk_native_get_memory_stats(handle, &during);
+    ASSERT(during.result_bytes_outstanding > before.result_bytes_outstanding, "outstanding result bytes grow");
+    ASSERT(during.peak_call_bytes > 0, "peak_call_bytes > 0");
+
+    openjtalk_native_free_prosody_result(result);
+    openjtalk_native_get_memory_stats(handle, &after);
+    ASSERT(after.result_bytes_outstanding == before.result_bytes_outstanding, "outstanding result bytes return after free");
+    printf("  shared=%llu private=%llu context=%llu peak=%llu\n",
+        (unsigned long long)after.dictionary_shared_bytes, (unsigned long long)after.dictionary_private_bytes,
+        (unsigned long long)after.context_bytes, (unsigned long long)after.peak_call_bytes);
+
+    /* The alignment block holds per-byte spans of the MeCab input, which can
+       be three times the 4096-byte input limit, plus node and row spans */
+    OpenJTalkNativeMemoryStats aligned, unaligned;
+    openjtalk_native_set_option(handle, "alignment", "1");
+    result = openjtalk_native_phonemize_with_prosody(handle, "今日はいい天気ですね");
+    openjtalk_native_free_prosody_result(result);
+    openjtalk_native_get_memory_stats(handle, &aligned);
+    openjtalk_native_set_option(handle, "alignment", "0");
+    openjtalk_native_get_memory_stats(handle, &unaligned);
+    printf("  context with alignment=%llu without=%llu\n",
+        (unsigned long long)aligned.context_bytes, (unsigned long long)unaligned.context_bytes);
+    ASSERT(aligned.context_bytes >= after.context_bytes + 3 * 4096 * (1 + 2 * sizeof(int)),
+           "context_bytes includes the alignment block");
+    ASSERT(unaligned.context_bytes == after.context_bytes, "context_bytes drops back with alignment off");
+}
+
+static void test_lattice_trim(void* handle) {
+    printf("\n--- test_lattice_trim ---\n");
+
+    const char* val = openjtalk_native_get_option(handle, "lattice_trim_bytes");
+    ASSERT(val && strcmp(val, "4096") == 0, "lattice_trim_bytes defaults to 4096");
+    ASSERT(openjtalk_native_set_option(handle, "lattice_trim_bytes", "-1") != OPENJTALK_NATIVE_SUCCESS, "negative lattice_trim_bytes rejected");
+    ASSERT(openjtalk_native_set_option(handle, "lattice_trim_bytes", "65537") != OPENJTALK_NATIVE_SUCCESS, "oversized lattice_trim_bytes rejected");
+    ASSERT(openjtalk_native_set_option(handle, "lattice_trim_bytes", "64") == OPENJTALK_NATIVE_SUCCESS, "set lattice_trim_bytes");
+
+    OpenJTalkNativeMemoryStats before, after;
+    openjtalk_native_get_memory_stats(handle, &before);
+
+    OpenJTalkNativePhonemeResult* result = openjtalk_native_phonemize(handle,
+        "東京駅から新幹線に乗って大阪へ向かい、週末は家族と一緒に公園を散歩しました");
+    ASSERT(result != NULL, "long input phonemized");
+    openjtalk_native_free_result(result);
+    for (int i = 0; i < 40; i++) {
+        result = openjtalk_native_phonemize(handle, "はい");
+        openjtalk_native_free_result(result);
+    }
+
+    openjtalk_native_get_memory_stats(handle, &after);
+    ASSERT(after.lattice_trim_count > before.lattice_trim_count, "lattice trimmed after outlier");
+    ASSERT(after.lattice_peak_input_bytes > 64, "peak keeps the outlier");
+    ASSERT(after.lattice_retained_input_bytes <= 64, "retained input drops after trim");
+
+    result = openjtalk_native_phonemize(handle, "今日はいい天気ですね");
+    ASSERT(result != NULL && result->phoneme_count > 0, "phonemize works after trim");
+    openjtalk_native_free_result(result);
+
+    openjtalk_native_set_option(handle, "lattice_trim_bytes", "4096");
+}
+
+/* Offsets stay inside the text and never move backwards */
+static int offsets_ordered(const OpenJTalkNativeProsodyResult* r, int text_len) {
+    for (int i = 0; i < r->phoneme_count; i++) {
+        if (r->source_start[i] < 0 || r->source_start[i] > r->source_end[i] || r->source_end[i] > text_len) return 0;
+        if (i > 0 && r->source_start[i] < r->source_start[i - 1]) return 0;
+    }
+    return 1;
+}
+
+/* True if some phoneme maps to exactly [start, end) */
+static int has_span(const OpenJTalkNativeProsodyResult* r, int start, int end) {
+    for (int i = 0; i < r->phoneme_count; i++) {
+        if (r->source_start[i] == start && r->source_end[i] == end) return 1;
+    }
+    return 0;
+}
+
+static void test_alignment(void* handle) {
+    printf("\n--- test_alignment ---\n");
+
+    const char* val = openjtalk_native_get_option(handle, "alignment");
+    ASSERT(val && strcmp(val, "0") == 0, "alignment defaults to 0");
+    ASSERT(openjtalk_native_set_option(handle, "alignment", "2") == OPENJTALK_NATIVE_ERROR_INVALID_INPUT, "invalid alignment rejected");
+
+    OpenJTalkNativeProsodyResult* r = openjtalk_native_phonemize_with_prosody(handle, "今日はいい天気ですね");
+    ASSERT(r && !r->source_start && !r->accent_phrase_start, "no offsets without alignment");
+    ASSERT(r && r->accent_phrase_count > 0, "accent_phrase_count set without alignment");
+    openjtalk_native_free_prosody_result(r);
+
+    ASSERT(openjtalk_native_set_option(handle, "alignment", "1") == OPENJTALK_NATIVE_SUCCESS, "enable alignment");
+
+    const char* text = "今日はいい天気ですね";
+    int len = (int)strlen(text);
+    r = openjtalk_native_phonemize_with_prosody(handle, text);
+    ASSERT(r && r->source_start && r->source_end, "per-phoneme offsets present");
+    if (r && r->source_start) {
+        ASSERT(offsets_ordered(r, len), "phoneme offsets ordered and inside the text");
+        ASSERT(r->source_start[0] == 0, "leading pau starts at 0");
+        ASSERT(r->source_end[r->phoneme_count - 1] == len, "trailing pau ends at the text end");
+        int covered = 1;
+        for (int i = 0; i < r->phoneme_count; i++) {
+            if (r->accent_phrase_index[i] >= 0 && r->source_end[i] <= r->source_start[i]) covered = 0;
+        }
+        ASSERT(covered, "spoken phonemes cover input characters");
+
+        int phrases_ok = r->accent_phrase_count > 0 && r->accent_phrase_start && r->accent_phrase_end;
+        for (int p = 0; phrases_ok && p < r->accent_phrase_count; p++) {
+            if (r->accent_phrase_start[p] > r->accent_phrase_end[p] || r->accent_phrase_end[p] > len) phrases_ok = 0;
+            if (p > 0 && r->accent_phrase_start[p] < r->accent_phrase_end[p - 1]) phrases_ok = 0;
+        }
+        ASSERT(phrases_ok, "accent phrase offsets ordered and inside the text");
+    }
+    openjtalk_native_free_prosody_result(r);
+
+    /* Half-width letters are widened by text2mecab; offsets stay on the input */
+    r = openjtalk_native_phonemize_with_prosody(handle, "あA");
+    ASSERT(r && r->source_start && has_span(r, 3, 4), "ASCII letter maps to its input byte");
+    openjtalk_native_free_prosody_result(r);
+
+    /* Half-width ｶﾞ becomes one full-width character */
+    r = openjtalk_native_phonemize_with_prosody(handle, "\xEF\xBD\xB6\xEF\xBE\x9E" "あ");
+    ASSERT(r && r->source_start && has_span(r, 0, 6), "half-width kana with sound mark maps to both characters");
+    openjtalk_native_free_prosody_result(r);
+
+    /* The date is rewritten before MeCab; its reading maps to the digits */
+    text = "2024/03/15です";
+    len = (int)strlen(text);
+    openjtalk_native_set_option(handle, "normalize_numbers", "1");
+    r = openjtalk_native_phonemize_with_prosody(handle, text);
+    openjtalk_native_set_option(handle, "normalize_numbers", "0");
+    ASSERT(r && r->source_start && offsets_ordered(r, len), "normalized text offsets ordered");
+    if (r && r->source_start) {
+        int date = 1, tail = 0;
+        for (int i = 0; i < r->phoneme_count; i++) {
+            if (r->accent_phrase_index[i] < 0) continue;
+            if (r->source_start[i] < 10 && r->source_end[i] > 10) date = 0;
+            if (r->source_start[i] >= 10) tail = 1;
+        }
+        ASSERT(date && tail, "date reading stays on the date, です after it");
+    }
+    openjtalk_native_free_prosody_result(r);
+
+    /* Renders from a snapshot carry no offsets */
+    void* analysis = openjtalk_native_analyze_text(handle, "こんにちは");
+    r = openjtalk_native_render_prosody(handle, analysis);
+    ASSERT(r && !r->source_start, "render_prosody leaves offsets NULL");
+    openjtalk_native_free_prosody_result(r);
+    openjtalk_native_free_analysis(analysis);
+
+    OpenJTalkNativePhonemeResult* plain = openjtalk_native_phonemize(handle, "今日はいい天気ですね");
+    ASSERT(plain && plain->phoneme_count > 0, "phonemize works with alignment on");
+    openjtalk_native_free_result(plain);
+
+    ASSERT(openjtalk_native_set_option(handle, "alignment", "0") == OPENJTALK_NATIVE_SUCCESS, "disable alignment");
+    r = openjtalk_native_phonemize_with_prosody(handle, "こんにちは");
+    ASSERT(r && !r->source_start, "offsets gone after disabling");
+    openjtalk_native_free_prosody_result(r);
+}
+
+static void test_reuse(void* handle) {
+    printf("\n--- test_reuse ---\n");
+
+    OpenJTalkNativeMemoryStats before, after;
+    openjtalk_native_get_memory_stats(handle, &before);
+
+    const char* long_text = "今日はいい天気ですね、明日は雨でしょうか";
+    const char* short_text = "こんにちは";
+
+    OpenJTalkNativePhonemeResult result = {0};
+    ASSERT(openjtalk_native_phonemize_into(handle, long_text, &result) == OPENJTALK_NATIVE_SUCCESS, "phonemize_into succeeds");
+    OpenJTalkNativePhonemeResult* fresh = openjtalk_native_phonemize(handle, long_text);
+    ASSERT(fresh && result.phonemes && strcmp(fresh->phonemes, result.phonemes) == 0 &&
+           fresh->phoneme_count == result.phoneme_count, "phonemize_into matches phonemize");
+    ASSERT(fresh && result.durations && result.durations[0] == fresh->durations[0] &&
+           result.total_duration == fresh->total_duration, "durations match phonemize");
+    openjtalk_native_free_result(fresh);
+
+    char* phonemes = result.phonemes;
+    int* ids = result.phoneme_ids;
+    int capacity = result.phoneme_capacity;
+    ASSERT(openjtalk_native_phonemize_into(handle, short_text, &result) == OPENJTALK_NATIVE_SUCCESS, "shorter text reuses result");
+    ASSERT(result.phonemes == phonemes && result.phoneme_ids == ids && result.phoneme_capacity == capacity,
+           "shorter text keeps the buffers");
+    fresh = openjtalk_native_phonemize(handle, short_text);
+    ASSERT(fresh && strcmp(fresh->phonemes, result.phonemes) == 0, "reused result holds the new text");
+    openjtalk_native_free_result(fresh);
+
+    ASSERT(openjtalk_native_phonemize_into(handle, "", &result) == OPENJTALK_NATIVE_ERROR_INVALID_INPUT, "empty text fails");
+    ASSERT(result.phoneme_count == 0 && result.phonemes == phonemes, "failed call empties the result and keeps buffers");
+    openjtalk_native_clear_result(&result);
+    ASSERT(result.phonemes == NULL && result.phoneme_capacity == 0, "clear_result resets the result");
+
+    /* A library-allocated result can be reused and freed as usual */
+    fresh = openjtalk_native_phonemize(handle, short_text);
+    ASSERT(fresh && openjtalk_native_phonemize_into(handle, long_text, fresh) == OPENJTALK_NATIVE_SUCCESS,
+           "phonemize result can be reused");
+    openjtalk_native_free_result(fresh);
+
+    OpenJTalkNativeProsodyResult prosody = {0};
+    ASSERT(openjtalk_native_phonemize_with_prosody_into(handle, long_text, &prosody) == OPENJTALK_NATIVE_SUCCESS,
+           "phonemize_with_prosody_into succeeds");
+    ASSERT(openjtalk_native_phonemize_with_prosody_into(handle, short_text, &prosody) == OPENJTALK_NATIVE_SUCCESS,
+           "prosody result reused");
+    OpenJTalkNativeProsodyResult* expected = openjtalk_native_phonemize_with_prosody(handle, short_text);
+    int same = expected && expected->phoneme_count == prosody.phoneme_count &&
+        strcmp(expected->phonemes, prosody.phonemes) == 0 && strcmp(expected->prosody_symbols, prosody.prosody_symbols) == 0 &&
+        expected->accent_phrase_count == prosody.accent_phrase_count;
+    for (int i = 0; same && i < prosody.phoneme_count; i++) {
+        if (expected->prosody_a1[i] != prosody.prosody_a1[i] || expected->prosody_marks[i] != prosody.prosody_marks[i] ||
+            expected->accent_phrase_index[i] != prosody.accent_phrase_index[i] || expected->mora_index[i] != prosody.mora_index[i]) {
+            same = 0;
+        }
+    }
+    ASSERT(same, "reused prosody result matches phonemize_with_prosody");
+    openjtalk_native_free_prosody_result(expected);
+
+    ASSERT(openjtalk_native_set_option(handle, "alignment", "1") == OPENJTALK_NATIVE_SUCCESS, "enable alignment");
+    openjtalk_native_phonemize_with_prosody_into(handle, long_text, &prosody);
+    ASSERT(prosody.source_start && prosody.accent_phrase_start, "offsets filled with alignment on");
+    openjtalk_native_set_option(handle, "alignment", "0");
+    openjtalk_native_phonemize_with_prosody_into(handle, short_text, &prosody);
+    ASSERT(!prosody.source_start && !prosody.accent_phrase_start, "offsets NULL with alignment off");
+    openjtalk_native_clear_prosody_result(&prosody);
+
+    /* A maximum-length run of letters and digits reads as far more phoneme
+       text than input; the string is sized from the labels */
+    static const char alnum[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    char ascii[4096 + 1];
+    for (int i = 0; i < 4096; i++) ascii[i] = alnum[i % (int)(sizeof(alnum) - 1)];
+    ascii[4096] = '\0';
+    ASSERT(openjtalk_native_phonemize_into(handle, ascii, &result) == OPENJTALK_NATIVE_SUCCESS,
+           "maximum-length ASCII input succeeds");
+    if (result.phonemes) {
+        int words = 1;
+        for (const char* p = result.phonemes; *p; p++) {
+            if (*p == ' ') words++;
+        }
+        printf("  %d phonemes, %d bytes\n", result.phoneme_count, (int)strlen(result.phonemes));
+        ASSERT(words == result.phoneme_count && (int)strlen(result.phonemes) < result.string_capacity,
+               "phoneme string holds every phoneme within its capacity");
+        fresh = openjtalk_native_phonemize(handle, ascii);
+        ASSERT(fresh && strcmp(fresh->phonemes, result.phonemes) == 0, "maximum-length input matches phonemize");
+        openjtalk_native_free_result(fresh);
+    }
+    openjtalk_native_clear_result(&result);
+
+    openjtalk_native_get_memory_stats(handle, &after);
+    ASSERT(after.result_bytes_outstanding == before.result_bytes_outstanding, "reused buffers are accounted and released");
+}
+
+/* Romaji of r with the spaces between words removed */
+static int romaji_equals(const OpenJTalkNativeReadingResult* r, const char* expected) {
+    const char* p = r->romaji;
+    for (; *expected; expected++, p++) {
+        while (*p == ' ') p++;
+        if (*p != *expected) return 0;
+    }
+    while (*p == ' ') p++;
+    return *p == '\0';
+}
+
+static void test_reading(void* handle) {
+    printf("\n--- test_reading ---\n");
+
+    OpenJTalkNativeMemoryStats before, after;
+    openjtalk_native_get_memory_stats(handle, &before);
+
+    const char* text = "今日はいい天気ですね";
+    OpenJTalkNativeReadingResult* r = openjtalk_native_phonemize_with_reading(handle, text);
+    ASSERT(r != NULL, "phonemize_with_reading returns a result");
+    if (r) {
+        OpenJTalkNativePhonemeResult* plain = openjtalk_native_phonemize(handle, text);
+        ASSERT(plain && strcmp(plain->phonemes, r->phonemes) == 0, "phonemes match phonemize");
+        ASSERT(plain && plain->phoneme_count == r->phoneme_count, "phoneme_count matches phonemize");
+        openjtalk_native_free_result(plain);
+
+        ASSERT(r->word_count > 0, "words present");
+        int words_ok = 1;
+        size_t reading_length = 0;
+        for (int i = 0; i < r->word_count; i++) {
+            if (!r->word_surfaces[i][0] || !r->word_readings[i][0] || !r->word_romaji[i][0]) words_ok = 0;
+            if (strstr(r->word_readings[i], "\xE2\x80\x99")) words_ok = 0;
+            reading_length += strlen(r->word_readings[i]);
+        }
+        ASSERT(words_ok, "every word has a surface, reading and romaji without devoicing marks");
+        ASSERT(strlen(r->reading) == reading_length, "reading is the word readings concatenated");
+
+        int ascii = 1;
+        for (const char* p = r->romaji; *p; p++) {
+            if ((unsigned char)*p >= 0x80) ascii = 0;
+        }
+        ASSERT(ascii && r->romaji[0], "romaji is ASCII");
+
+        openjtalk_native_get_memory_stats(handle, &after);
+        ASSERT(after.result_bytes_outstanding > before.result_bytes_outstanding, "reading result is accounted");
+        openjtalk_native_free_reading_result(r);
+    }
+
+    r = openjtalk_native_phonemize_with_reading(handle, "カタカナ");
+    ASSERT(r && strcmp(r->reading, "カタカナ") == 0, "katakana reads as itself");
+    ASSERT(r && romaji_equals(r, "katakana"), "katakana romaji");
+    openjtalk_native_free_reading_result(r);
+
+    openjtalk_native_get_memory_stats(handle, &after);
+    ASSERT(after.result_bytes_outstanding == before.result_bytes_outstanding, "reading bytes released on free");
+
+    openjtalk_native_free_reading_result(NULL);
+    ASSERT(openjtalk_native_phonemize_with_reading(handle, NULL) == NULL, "NULL text returns NULL");
+}
+
+static void test_warmup(void* handle) {
+    printf("\n--- test_warmup ---\n");
+
+    ASSERT(openjtalk_native_warmup(handle, -1, NULL, 0) == OPENJTALK_NATIVE_ERROR_INVALID_INPUT, "negative level rejected");
+    ASSERT(openjtalk_native_warmup(handle, OPENJTALK_NATIVE_WARMUP_PIPELINE + 1, NULL, 0) == OPENJTALK_NATIVE_ERROR_INVALID_INPUT,
+        "unknown level rejected");
+    ASSERT(openjtalk_native_warmup(handle, OPENJTALK_NATIVE_WARMUP_NONE, NULL, 1) == OPENJTALK_NATIVE_ERROR_INVALID_INPUT,
+        "NULL texts with a count rejected");
+
+    OpenJTalkNativeMemoryStats before, after;
+    openjtalk_native_get_memory_stats(handle, &before);
+
+    const char* texts[] = { "紫陽花の咲く季節になりました", "駅前の喫茶店で待ち合わせましょう" };
+    ASSERT(openjtalk_native_warmup(handle, OPENJTALK_NATIVE_WARMUP_PIPELINE, texts, 2) == OPENJTALK_NATIVE_SUCCESS,
+        "pipeline warm-up with texts succeeds");
+    ASSERT(openjtalk_native_get_last_error(handle) == OPENJTALK_NATIVE_SUCCESS, "last_error is SUCCESS after warm-up");
+    ASSERT(openjtalk_native_warmup(handle, OPENJTALK_NATIVE_WARMUP_DICTIONARY, NULL, 0) == OPENJTALK_NATIVE_SUCCESS,
+        "repeated dictionary warm-up succeeds");
+
+    openjtalk_native_get_memory_stats(handle, &after);
+    ASSERT(after.result_bytes_outstanding == before.result_bytes_outstanding, "warm-up leaves no outstanding results");
+    ASSERT(after.dictionary_private_bytes >= before.dictionary_private_bytes, "word cache kept warm-up entries");
+
+    const char* mixed[] = { "今日はいい天気ですね", NULL, "" };
+    ASSERT(openjtalk_native_warmup(handle, OPENJTALK_NATIVE_WARMUP_NONE, mixed, 3) != OPENJTALK_NATIVE_SUCCESS,
+        "failing caller texts are reported");
+
+    OpenJTalkNativePhonemeResult* result = openjtalk_native_phonemize(handle, "今日はいい天気ですね");
+    ASSERT(result != NULL && result->phoneme_count > 0, "phonemize works after warm-up");
+    openjtalk_native_free_result(result);
+}
+
+/* Value of the first sample line starting with name, or -1 */
+static long long metric_value(const char* text, const char* name) {
+    size_t len = strlen(name);
+    for (const char* line = text; line && *line; line = strchr(line, '\n'), line = line ? line + 1 : NULL) {
+        if (strncmp(line, name, len) == 0 && line[len] == ' ') return atoll(line + len + 1);
+    }
+    return -1;
+}
+
+static void test_metrics(void* handle, const char* dict_path) {
+    printf("\n--- test_metrics ---\n");
+
+    size_t required = openjtalk_native_render_metrics(handle, NULL, 0);
+    ASSERT(required > 1, "size query returns the required bytes");
+
+    char* text = (char*)malloc(required + 4096);
+    memset(text, 'x', 8);
+    ASSERT(openjtalk_native_render_metrics(handle, text, 8) == required && text[0] == 'x', "short buffer is left untouched");
+    ASSERT(openjtalk_native_render_metrics(handle, text, required + 4096) == required, "render into a large buffer");
+    ASSERT(strlen(text) + 1 == required, "rendered text fills the reported size");
+    ASSERT(strstr(text, "openjtalk_native_errors_total{code=\"invalid_utf8\"}") != NULL &&
+           strstr(text, "openjtalk_native_errors_total{code=\"connection\"}") != NULL, "every error code has a counter");
+    ASSERT(strstr(text, "# TYPE openjtalk_native_call_duration_seconds histogram") != NULL, "latency histogram present");
+    ASSERT(strstr(text, "openjtalk_native_call_duration_seconds_bucket{le=\"+Inf\"}") != NULL, "+Inf bucket present");
+    long long calls = metric_value(text, "openjtalk_native_call_duration_seconds_count");
+    long long invalid = metric_value(text, "openjtalk_native_errors_total{code=\"invalid_input\"}");
+    long long phonemes = metric_value(text, "openjtalk_native_phonemes_sum");
+    ASSERT(calls > 0 && invalid >= 0 && phonemes > 0, "counters parse");
+
+    OpenJTalkNativePhonemeResult* result = openjtalk_native_phonemize(handle, "今日はいい天気ですね");
+    int phoneme_count = result ? result->phoneme_count : 0;
+    openjtalk_native_free_result(result);
+    ASSERT(openjtalk_native_phonemize(handle, "") == NULL, "empty input fails");
+
+    openjtalk_native_render_metrics(handle, text, required + 4096);
+    ASSERT(metric_value(text, "openjtalk_native_call_duration_seconds_count") == calls + 2, "both calls counted");
+    ASSERT(metric_value(text, "openjtalk_native_errors_total{code=\"invalid_input\"}") == invalid + 1, "invalid input counted");
+    ASSERT(metric_value(text, "openjtalk_native_phonemes_sum") == phonemes + phoneme_count, "phonemes summed");
+    ASSERT(metric_value(text, "openjtalk_native_word_cache_hits_total") > 0, "word cache hits reported");
+    free(text);
+
+    void* engine = openjtalk_native_engine_create(dict_path, 2);
+    ASSERT(engine != NULL, "engine created");
+    if (engine) {
+        OpenJTalkNativeDocumentResult* doc = openjtalk_native_engine_phonemize_document(engine, "今日は晴れです。明日は雨です。");
+        openjtalk_native_free_document_result(doc);
+        size_t size = openjtalk_native_engine_render_metrics(engine, NULL, 0);
+        char* engine_text = (char*)malloc(size);
+        openjtalk_native_engine_render_metrics(engine, engine_text, size);
+        ASSERT(metric_value(engine_text, "openjtalk_native_call_duration_seconds_count") == 2, "engine sums sentences over workers");
+        free(engine_text);
+        openjtalk_native_engine_destroy(engine);
+    }
+}
+
+static void test_serialize(void* handle, const char* text) {
+    printf("\n--- test_serialize: \"%s\" ---\n", text);
+
+    OpenJTalkNativeProsodyResult* result = openjtalk_native_phonemize_with_prosody(handle, text);
+    ASSERT(result != NULL, "prosody result is not NULL");
+    if (!result) return;
+
+    size_t size = openjtalk_native_serialize_prosody_result(result, NULL, 0);
+    ASSERT(size > 0 && size % 8 == 0, "serialized size is a positive multiple of 8");
+    unsigned char* buffer = (unsigned char*)malloc(size);
+    ASSERT(openjtalk_native_serialize_prosody_result(result, buffer, size - 1) == size, "short buffer reports required size");
+    ASSERT(openjtalk_native_serialize_prosody_result(result, buffer, size) == size, "serialize writes required size");
+
+    int type = 0, count = 0;
+    const unsigned char* ids = (const unsigned char*)openjtalk_native_find_section(
+        buffer, size, OPENJTALK_NATIVE_SECTION_PHONEME_IDS, &type, &count);
+    ASSERT(ids != NULL && type == OPENJTALK_NATIVE_ELEMENT_U8 && count == result->phoneme_count, "phoneme ID section");
+    if (ids) {
+        /* Rebuild the phoneme string from IDs */
+        char rebuilt[8192] = {0};
+        for (int i = 0; i < count; i++) {
+            const char* symbol = openjtalk_native_get_phoneme_symbol(ids[i]);
+            if (i > 0) strcat(rebuilt, " ");
+            strcat(rebuilt, symbol ? symbol : "?");
+        }
+        ASSERT(strcmp(rebuilt, result->phonemes) == 0, "phoneme IDs round-trip to the phoneme string");
+    }
+
+    const int16_t* a1 = (const int16_t*)openjtalk_native_find_section(buffer, size, OPENJTALK_NATIVE_SECTION_A1, &type, &count);
+    ASSERT(a1 != NULL && type == OPENJTALK_NATIVE_ELEMENT_I16 && ((size_t)((const unsigned char*)a1 - buffer) % 8) == 0,
+           "A1 section is int16 and 8-byte aligned");
+    const int32_t* mora = (const int32_t*)openjtalk_native_find_section(buffer, size, OPENJTALK_NATIVE_SECTION_MORA_INDEX, &type, &count);
+    if (a1 && mora) {
+        int match = 1;
+        for (int i = 0; i < result->phoneme_count; i++) {
+            if (a1[i] != result->prosody_a1[i] || mora[i] != result->mora_index[i]) match = 0;
+        }
+        ASSERT(match, "A1 and mora_index columns match the result");
+    }
+    const char* symbols = (const char*)openjtalk_native_find_section(buffer, size, OPENJTALK_NATIVE_SECTION_PROSODY_SYMBOLS, &type, &count);
+    ASSERT(symbols != NULL && count == (int)strlen(result->prosody_symbols) &&
+           strncmp(symbols, result->prosody_symbols, count) == 0, "prosody symbols section matches");
+    ASSERT(openjtalk_native_find_section(buffer, size, OPENJTALK_NATIVE_SECTION_DURATIONS, NULL, NULL) == NULL,
+           "prosody result has no duration section");
+
+    ASSERT(openjtalk_native_find_section(buffer, size, OPENJTALK_NATIVE_SECTION_SOURCE_START, NULL, NULL) == NULL,
+           "no offset sections without alignment");
+
+    buffer[4] = 99;
+    ASSERT(openjtalk_native_find_section(buffer, size, OPENJTALK_NATIVE_SECTION_A1, NULL, NULL) == NULL,
+           "unknown version is rejected");
+
+    free(buffer);
+    openjtalk_native_free_prosody_result(result);
+
+    /* With alignment on, the offsets travel in the buffer too */
+    openjtalk_native_set_option(handle, "alignment", "1");
+    result = openjtalk_native_phonemize_with_prosody(handle, text);
+    openjtalk_native_set_option(handle, "alignment", "0");
+    ASSERT(result != NULL && result->source_start != NULL, "aligned prosody result");
+    if (!result || !result->source_start) {
+        openjtalk_native_free_prosody_result(result);
+        return;
+    }
+
+    size = openjtalk_native_serialize_prosody_result(result, NULL, 0);
+    buffer = (unsigned char*)malloc(size);
+    openjtalk_native_serialize_prosody_result(result, buffer, size);
+
+    const int32_t* start = (const int32_t*)openjtalk_native_find_section(
+        buffer, size, OPENJTALK_NATIVE_SECTION_SOURCE_START, &type, &count);
+    ASSERT(start != NULL && type == OPENJTALK_NATIVE_ELEMENT_I32 && count == result->phoneme_count, "source start section");
+    const int32_t* end = (const int32_t*)openjtalk_native_find_section(
+        buffer, size, OPENJTALK_NATIVE_SECTION_SOURCE_END, &type, &count);
+    ASSERT(end != NULL && count == result->phoneme_count, "source end section");
+    if (start && end) {
+        int match = 1;
+        for (int i = 0; i < result->phoneme_count; i++) {
+            if (start[i] != result->source_start[i] || end[i] != result->source_end[i]) match = 0;
+        }
+        ASSERT(match, "source offsets match the result");
+    }
+
+    const int32_t* phrase_start = (const int32_t*)openjtalk_native_find_section(
+        buffer, size, OPENJTALK_NATIVE_SECTION_ACCENT_PHRASE_START, &type, &count);
+    ASSERT(phrase_start != NULL && count == result->accent_phrase_count, "accent phrase start section");
+    const int32_t* phrase_end = (const int32_t*)openjtalk_native_find_section(
+        buffer, size, OPENJTALK_NATIVE_SECTION_ACCENT_PHRASE_END, &type, &count);
+    ASSERT(phrase_end != NULL && count == result->accent_phrase_count, "accent phrase end section");
+    if (phrase_start && phrase_end) {
+        int match = 1;
+        for (int i = 0; i < result->accent_phrase_count; i++) {
+            if (phrase_start[i] != result->accent_phrase_start[i] || phrase_end[i] != result->accent_phrase_end[i]) match = 0;
+        }
+        ASSERT(match, "accent phrase offsets match the result");
+    }
+
+    free(buffer);
+    openjtalk_native_free_prosody_result(result);
+}
+
+static void test_document(void* handle, const char* dict_path) {
+    printf("\n--- test_document ---\n");
+
+    const char* text = "今日はいい天気ですね。  明日は雨でしょうか？\n「日本語の音声合成」！テスト";
+    const char* sentences[] = { "今日はいい天気ですね。", "明日は雨でしょうか？", "「日本語の音声合成」！", "テスト" };
+    const int expected = 4;
+
+    void* engine = openjtalk_native_engine_create(dict_path, 3);
+    ASSERT(engine != NULL, "engine_create succeeds");
+    if (!engine) return;
+    ASSERT(openjtalk_native_engine_get_worker_count(engine) == 3, "engine has 3 workers");
+
+    OpenJTalkNativeDocumentResult* doc = openjtalk_native_engine_phonemize_document(engine, text);
+    ASSERT(doc != NULL, "document result is not NULL");
+    if (doc) {
+        ASSERT(doc->sentence_count == expected, "document splits into 4 sentences");
+        ASSERT(doc->prosody != NULL, "stitched prosody is not NULL");
+
+        int total = 0;
+        for (int i = 0; i < doc->sentence_count && i < expected; i++) {
+            int len = (int)strlen(sentences[i]);
+            ASSERT(doc->sentence_lengths[i] == len &&
+                   strncmp(text + doc->sentence_offsets[i], sentences[i], len) == 0, "sentence offsets map to input text");
+            ASSERT(doc->sentence_errors[i] == OPENJTALK_NATIVE_SUCCESS, "sentence phonemized");
+            ASSERT(doc->sentence_phoneme_offsets[i] == total, "sentence phoneme offsets are contiguous");
+
+            /* Each sentence must match a direct single-handle call */
+            OpenJTalkNativeProsodyResult* single = openjtalk_native_phonemize_with_prosody(handle, sentences[i]);
+            if (single) {
+                int match = doc->sentence_phoneme_counts[i] == single->phoneme_count;
+                for (int j = 0; match && j < single->phoneme_count; j++) {
+                    match = doc->prosody->prosody_a1[total + j] == single->prosody_a1[j] &&
+                            doc->prosody->prosody_a3[total + j] == single->prosody_a3[j];
+                }
+                ASSERT(match, "stitched sentence matches single-handle result");
+                openjtalk_native_free_prosody_result(single);
+            }
+            total += doc->sentence_phoneme_counts[i];
+        }
+        if (doc->prosody) {
+            ASSERT(doc->prosody->phoneme_count == total, "phoneme count is the sum of sentences");
+            int monotonic = 1;
+            for (int j = 1; j < doc->prosody->phoneme_count; j++) {
+                if (doc->prosody->mora_index[j] >= 0 && doc->prosody->mora_index[j - 1] > doc->prosody->mora_index[j]) monotonic = 0;
+            }
+            ASSERT(monotonic, "mora indices increase across sentences");
+            printf("  Phonemes: %s\n", doc->prosody->phonemes);
+        }
+        openjtalk_native_free_document_result(doc);
+    }
+
+    /* Documents beyond the per-call limit are split, not rejected */
+    size_t unit = strlen("今日はいい天気ですね、");
+    size_t repeat = 1000;
+    char* long_text = (char*)malloc(unit * repeat + 1);
+    if (long_text) {
+        for (size_t i = 0; i < repeat; i++) memcpy(long_text + i * unit, "今日はいい天気ですね、", unit);
+        long_text[unit * repeat] = '\0';
+
+        doc = openjtalk_native_engine_phonemize_document(engine, long_text);
+        ASSERT(doc != NULL && doc->sentence_count > 1, "oversized sentence is split");
+        if (doc) {
+            int ok = 1;
+            for (int i = 0; i < doc->sentence_count; i++) {
+                if (doc->sentence_lengths[i] > 4096 || doc->sentence_errors[i] != OPENJTALK_NATIVE_SUCCESS) ok = 0;
+            }
+            ASSERT(ok, "every piece fits the per-call limit and succeeds");
+            openjtalk_native_free_document_result(doc);
+        }
+        free(long_text);
+    }
+
+    doc = openjtalk_native_engine_phonemize_document(engine, "");
+    ASSERT(doc == NULL, "empty document returns NULL");
+
+    openjtalk_native_engine_destroy(engine);
+}
+
+static void test_priority_lanes(const char* dict_path) {
+    printf("\n--- test_priority_lanes ---\n");
+
+    const char* text = "今日はいい天気ですね。明日は雨でしょうか？日本語の音声合成。テスト";
+
+    void* engine = openjtalk_native_engine_create(dict_path, 2);
+    ASSERT(engine != NULL, "engine_create succeeds");
+    if (!engine) return;
+
+    ASSERT(openjtalk_native_engine_set_option(engine, "reserved_workers", "2") != OPENJTALK_NATIVE_SUCCESS,
+        "reserving every worker is rejected");
+    ASSERT(openjtalk_native_engine_set_option(engine, "bulk_queue_limit", "0") != OPENJTALK_NATIVE_SUCCESS, "zero queue limit rejected");
+    ASSERT(openjtalk_native_engine_set_option(engine, "unknown", "1") != OPENJTALK_NATIVE_SUCCESS, "unknown engine option rejected");
+    ASSERT(openjtalk_native_engine_set_option(engine, "reserved_workers", "1") == OPENJTALK_NATIVE_SUCCESS, "reserve one worker");
+    /* A one-slot bulk lane makes the submitter block per sentence */
+    ASSERT(openjtalk_native_engine_set_option(engine, "bulk_queue_limit", "1") == OPENJTALK_NATIVE_SUCCESS, "set bulk_queue_limit");
+
+    ASSERT(openjtalk_native_engine_phonemize_document_with_priority(engine, text, 2) == NULL, "unknown priority rejected");
+
+    OpenJTalkNativeDocumentResult* interactive = openjtalk_native_engine_phonemize_document(engine, text);
+    OpenJTalkNativeDocumentResult* bulk =
+        openjtalk_native_engine_phonemize_document_with_priority(engine, text, OPENJTALK_NATIVE_PRIORITY_BULK);
+    ASSERT(interactive != NULL && bulk != NULL, "both lanes return documents");
+    if (interactive && bulk) {
+        ASSERT(bulk->sentence_count == 4 && bulk->prosody && interactive->prosody &&
+               strcmp(bulk->prosody->phonemes, interactive->prosody->phonemes) == 0, "bulk lane output matches interactive");
+        ASSERT(bulk->processing_seconds > 0.0 && bulk->queue_wait_seconds >= 0.0, "document reports wait and processing time");
+    }
+    openjtalk_native_free_document_result(interactive);
+    openjtalk_native_free_document_result(bulk);
+
+    size_t size = openjtalk_native_engine_render_metrics(engine, NULL, 0);
+    char* metrics = (char*)malloc(size);
+    openjtalk_native_engine_render_metrics(engine, metrics, size);
+    ASSERT(metric_value(metrics, "openjtalk_native_engine_queue_wait_seconds_count{lane=\"bulk\"}") == 4, "bulk lane waits counted");
+    ASSERT(metric_value(metrics, "openjtalk_native_engine_processing_seconds_count{lane=\"interactive\"}") == 4,
+        "interactive lane processing counted");
+    free(metrics);
+
+    openjtalk_native_engine_destroy(engine);
+}
+
+static void test_engine_pinning(const char* dict_path) {
+    printf("\n--- test_engine_pinning ---\n");
+
+    const char* text = "今日はいい天気ですね。明日は雨でしょうか？日本語の音声合成。テスト";
+
+    OpenJTalkNativeMemoryStats before, after;
+    openjtalk_native_get_memory_stats(NULL, &before);
+
+    void* unpinned = openjtalk_native_engine_create(dict_path, 2);
+    void* pinned = openjtalk_native_engine_create_with_flags(dict_path, 2, OPENJTALK_NATIVE_ENGINE_PIN_WORKERS);
+    ASSERT(unpinned != NULL && pinned != NULL, "pinned and unpinned engines created");
+    if (!unpinned || !pinned) {
+        openjtalk_native_engine_destroy(unpinned);
+        openjtalk_native_engine_destroy(pinned);
+        return;
+    }
+
+    ASSERT(openjtalk_native_engine_get_worker_cpu(unpinned, 0) == -1, "unpinned worker reports no CPU");
+    ASSERT(openjtalk_native_engine_get_worker_cpu(pinned, 2) == -1, "out-of-range worker reports no CPU");
+#ifdef __linux__
+    int cpu0 = openjtalk_native_engine_get_worker_cpu(pinned, 0);
+    int cpu1 = openjtalk_native_engine_get_worker_cpu(pinned, 1);
+    ASSERT(cpu0 >= 0 && cpu1 >= 0, "pinned workers report their CPU");
+#endif
+
+    /* Repeated documents reuse the workers' result buffers */
+    int same = 1;
+    OpenJTalkNativeDocumentResult* expected = openjtalk_native_engine_phonemize_document(unpinned, text);
+    for (int i = 0; i < 5; i++) {
+        OpenJTalkNativeDocumentResult* doc = openjtalk_native_engine_phonemize_document(pinned, text);
+        if (!doc || !expected || doc->sentence_count != expected->sentence_count ||
+            strcmp(doc->prosody->phonemes, expected->prosody->phonemes) != 0 ||
+            memcmp(doc->prosody->prosody_a1, expected->prosody->prosody_a1, (size_t)doc->prosody->phoneme_count * sizeof(int)) != 0) {
+            same = 0;
+        }
+        openjtalk_native_free_document_result(doc);
+    }
+    ASSERT(same, "pinned engine output matches unpinned across reused buffers");
+    openjtalk_native_free_document_result(expected);
+
+    openjtalk_native_engine_destroy(unpinned);
+    openjtalk_native_engine_destroy(pinned);
+    openjtalk_native_get_memory_stats(NULL, &after);
+    ASSERT(after.result_bytes_outstanding == before.result_bytes_outstanding, "engine result buffers released on destroy");
+}
+
 int main(void) {
     printf("=== openjtalk_native Phonemization Tests ===\n");
     printf("Version: %s\n", openjtalk_native_get_version());
@@ -127,10 +1321,32 @@ int main(void) {
     test_phonemize(handle, "日本語の音声合成", "compound");
     test_phonemize(handle, "123", "numbers");
     test_phonemize(handle, "テスト", "katakana");
+    test_phoneme_ids(handle);
 
     /* Prosody tests */
     test_prosody(handle, "こんにちは", "greeting_prosody");
     test_prosody(handle, "日本語の音声合成", "compound_prosody");
+    test_prosody(handle, "今日はいい天気ですね、明日は雨でしょうか", "phrases_prosody");
+
+    /* Label export tests */
+    test_labels(handle, "今日はいい天気ですね");
+    test_labels(handle, "日本語の音声合成、テスト");
+
+    /* Serialization tests */
+    test_serialize(handle, "今日はいい天気ですね、明日は雨でしょうか");
+
+    /* Duration estimate tests */
+    test_durations(handle, "今日はいい天気ですね、明日は雨でしょうか");
+
+    /* Number normalization tests */
+    test_normalize_numbers(handle);
+    test_latin_mode(handle);
+
+    /* NJD stage selection tests */
+    test_njd_stages(handle);
+
+    /* Analysis reuse tests */
+    test_analysis_reuse(handle, "今日はいい天気ですね、明日は雨でしょうか");
 
     /* Legacy API tests */
     test_analyze(handle);
@@ -138,6 +1354,19 @@ int main(void) {
 
     /* Options tests */
     test_options(handle);
+    test_word_cache(handle, dict_path);
+    test_memory_stats(handle);
+    test_lattice_trim(handle);
+    test_alignment(handle);
+    test_reading(handle);
+    test_reuse(handle);
+    test_warmup(handle);
+    test_metrics(handle, dict_path);
+
+    /* Parallel document tests */
+    test_document(handle, dict_path);
+    test_priority_lanes(dict_path);
+    test_engine_pinning(dict_path);
 
     /* Edge case: empty string should return NULL */
     printf("\n--- test_empty_string ---\n");
@@ -0,0 +1,290 @@
+/*
+ * openjtalk_native_bench - single-handle throughput benchmark.
+ *
+ * A suite is a text set plus a list of configurations (option settings).
+ * Every configuration phonemizes the whole text set once to warm up and
+ * then for the requested number of iterations; throughput is reported per
+ * configuration together with the speedup over the first one.
+ *
+ * Suites:
+ *   numeric   prices, dates, times, phone numbers and measurements with
+ *             normalize_numbers off and on
+ *   profiles  everyday sentences through each njd_stages profile, plus
+ *             openjtalk_native_get_reading() which skips label generation
+ *   mixed     chat-style text mixing Japanese with English words, URLs,
+ *             emoji and code identifiers through each latin_mode
+ *   news      news-style sentences with word_cache off and on; the warm-up
+ *             pass fills the cache, so "on" is steady-state hit cost
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "openjtalk_native.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#define MAX_CONFIG_OPTIONS 4
+
+typedef struct {
+    const char* name;
+    const char* options[MAX_CONFIG_OPTIONS][2];   /* key/value pairs, NULL-terminated */
+    int reading;                                  /* Call get_reading instead of phonemize */
+} BenchConfig;
+
+typedef struct {
+    const char* name;
+    const char* const* texts;
+    int text_count;
+    const BenchConfig* configs;
+    int config_count;
+} BenchSuite;
+
+static const char* const numeric_texts[] = {
+    "会議は2024/03/15の10:30からです",
+    "合計金額は1,234,567円になります",
+    "お問い合わせは03-1234-5678までお願いします",
+    "本日の最高気温は32℃、湿度は78%でした",
+    "残りの距離は12.5kmです",
+    "価格は$1,299から€999に値下げされました",
+    "2023-12-31 23:59:59に締め切ります",
+    "容量は256GBで、転送速度は1.5GHzです",
+    "携帯電話は090-9876-5432です",
+    "体重は65kg、身長は172cmです"
+};
+
+#define COUNT(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+static const BenchConfig numeric_configs[] = {
+    { "normalize_off", { { "normalize_numbers", "0" } }, 0 },
+    { "normalize_on",  { { "normalize_numbers", "1" } }, 0 }
+};
+
+static const char* const sentence_texts[] = {
+    "今日はいい天気ですね",
+    "日本語の音声合成システムを開発しています",
+    "明日の会議は午後から始まる予定です",
+    "東京駅から新幹線に乗って大阪へ向かいました",
+    "このアプリケーションは音声でも操作できます",
+    "図書館で借りた本を返すのを忘れていました",
+    "週末は家族と一緒に公園を散歩しました",
+    "新しい機能についてご意見をお聞かせください"
+};
+
+static const BenchConfig profile_configs[] = {
+    { "full",         { { "njd_stages", "full" } },     0 },
+    { "phonemes",     { { "njd_stages", "phonemes" } }, 0 },
+    { "reading",      { { "njd_stages", "reading" } },  0 },
+    { "get_reading",  { { "njd_stages", "reading" } },  1 }
+};
+
+static const char* const mixed_texts[] = {
+    "今日のmeetingはZoomでやります😀",
+    "詳細はhttps://example.com/docs/getting-startedを見てください",
+    "getUserNameがnullを返すbugを直しました",
+    "新しいiPhoneのcameraはすごいですね👍🏽",
+    "PythonとJavaScriptのどちらがいいですか？",
+    "Wi-Fiのpasswordを教えてください🙏",
+    "READMEにAPIの使い方を書きました",
+    "www.example.jpからdownloadできます✨",
+    "HTTPServerのtimeoutを30秒にしました",
+    "ありがとうございます!! See you tomorrow❤️"
+};
+
+static const BenchConfig mixed_configs[] = {
+    { "keep",  { { "latin_mode", "keep" },  { "njd_stages", "full" } }, 0 },
+    { "spell", { { "latin_mode", "spell" }, { "njd_stages", "full" } }, 0 },
+    { "skip",  { { "latin_mode", "skip" },  { "njd_stages", "full" } }, 0 }
+};
+
+static const char* const news_texts[] = {
+    "政府は今年度の補正予算案を閣議決定し、国会に提出する方針です",
+    "気象庁によりますと、関東地方は午後から雷を伴った激しい雨が降るおそれがあります",
+    "日銀は金融政策決定会合で、現在の大規模な金融緩和策を維持することを決めました",
+    "警察は防犯カメラの映像を分析するなどして、逃げた男の行方を捜査しています",
+    "新型ロケットの打ち上げは、天候不良のため来週以降に延期されました",
+    "東京株式市場では、取引開始直後から幅広い銘柄に買い注文が広がりました",
+    "文部科学省は、小学校での英語教育の充実に向けた新たな指針をまとめました",
+    "厚生労働省によりますと、全国の医療機関から報告された患者数は前の週より減少しました",
+    "地元の商店街では、伝統の夏祭りに向けて準備が進められています",
+    "首相は記者団に対し、経済対策を早急に取りまとめるよう指示したと述べました",
+    "高速道路では、帰省ラッシュによる渋滞が各地で発生しています",
+    "国際会議には各国の首脳が集まり、気候変動対策について議論が交わされました"
+};
+
+static const BenchConfig news_configs[] = {
+    { "cache_off", { { "word_cache", "0" }, { "njd_stages", "full" }, { "latin_mode", "keep" } }, 0 },
+    { "cache_on",  { { "word_cache", "1" }, { "njd_stages", "full" }, { "latin_mode", "keep" } }, 0 }
+};
+
+static const BenchSuite suites[] = {
+    { "numeric",  numeric_texts,  COUNT(numeric_texts),  numeric_configs, COUNT(numeric_configs) },
+    { "profiles", sentence_texts, COUNT(sentence_texts), profile_configs, COUNT(profile_configs) },
+    { "mixed",    mixed_texts,    COUNT(mixed_texts),    mixed_configs,   COUNT(mixed_configs) },
+    { "news",     news_texts,     COUNT(news_texts),     news_configs,    COUNT(news_configs) }
+};
+
+static double now_seconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#endif
+}
+
+/* Load one text per non-empty line */
+static int load_texts(const char* path, char*** texts) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return -1;
+    int count = 0, capacity = 0;
+    char line[4200];
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (!line[0]) continue;
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            *texts = (char**)realloc(*texts, (size_t)capacity * sizeof(char*));
+        }
+        (*texts)[count++] = strdup(line);
+    }
+    fclose(f);
+    return count;
+}
+
+/* One pass over the text set; returns the number of failed calls.
+   phonemes counts phonemes, or reading bytes in reading mode. */
+static int run_pass(void* handle, const char* const* texts, int text_count, int reading, long* phonemes) {
+    int errors = 0;
+    for (int i = 0; i < text_count; i++) {
+        if (reading) {
+            char* r = openjtalk_native_get_reading(handle, texts[i]);
+            if (!r) {
+                errors++;
+                continue;
+            }
+            if (phonemes) *phonemes += (long)strlen(r);
+            openjtalk_native_free_string(r);
+            continue;
+        }
+        OpenJTalkNativePhonemeResult* r = openjtalk_native_phonemize(handle, texts[i]);
+        if (!r) {
+            errors++;
+            continue;
+        }
+        if (phonemes) *phonemes += r->phoneme_count;
+        openjtalk_native_free_result(r);
+    }
+    return errors;
+}
+
+static int run_suite(void* handle, const BenchSuite* suite, const char* const* texts, int text_count, int iterations) {
+    double baseline = 0.0;
+    int failed = 0;
+
+    printf("suite=%s texts=%d iterations=%d\n", suite->name, text_count, iterations);
+    for (int c = 0; c < suite->config_count; c++) {
+        const BenchConfig* config = &suite->configs[c];
+        for (int o = 0; o < MAX_CONFIG_OPTIONS && config->options[o][0]; o++) {
+            if (openjtalk_native_set_option(handle, config->options[o][0], config->options[o][1]) != OPENJTALK_NATIVE_SUCCESS) {
+                fprintf(stderr, "%s: cannot set %s=%s\n", config->name, config->options[o][0], config->options[o][1]);
+                return 1;
+            }
+        }
+
+        run_pass(handle, texts, text_count, config->reading, NULL);
+
+        long phonemes = 0;
+        int errors = 0;
+        double start = now_seconds();
+        for (int i = 0; i < iterations; i++) {
+            errors += run_pass(handle, texts, text_count, config->reading, &phonemes);
+        }
+        double elapsed = now_seconds() - start;
+        double rate = (double)text_count * iterations / elapsed;
+        if (c == 0) baseline = rate;
+
+        printf("  %-16s texts/sec=%.0f us/text=%.1f %s=%ld errors=%d speedup=%.2fx\n",
+            config->name, rate, 1e6 / rate, config->reading ? "reading_bytes" : "phonemes",
+            phonemes / iterations, errors, rate / baseline);
+        failed |= errors != 0;
+    }
+    return failed;
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+        "Usage: %s -d DICT [-s SUITE] [-i TEXTS] [-n ITERATIONS]\n"
+        "  -d DICT        dictionary directory\n"
+        "  -s SUITE       suite to run (default: all)\n"
+        "  -i TEXTS       file with one text per line, replaces the suite's texts\n"
+        "  -n ITERATIONS  passes over the text set per configuration (default: 200)\n"
+        "Suites:",
+        argv0);
+    for (int i = 0; i < COUNT(suites); i++) fprintf(stderr, " %s", suites[i].name);
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char** argv) {
+    const char* dict_path = NULL;
+    const char* suite_name = NULL;
+    const char* texts_path = NULL;
+    int iterations = 200;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "-d") == 0) dict_path = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "-s") == 0) suite_name = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "-i") == 0) texts_path = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "-n") == 0) iterations = atoi(argv[++i]);
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!dict_path || iterations <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    char** file_texts = NULL;
+    int file_text_count = 0;
+    if (texts_path) {
+        file_text_count = load_texts(texts_path, &file_texts);
+        if (file_text_count <= 0) {
+            fprintf(stderr, "no texts in %s\n", texts_path);
+            return 1;
+        }
+    }
+
+    void* handle = openjtalk_native_create(dict_path);
+    if (!handle) {
+        fprintf(stderr, "cannot load dictionary %s\n", dict_path);
+        return 1;
+    }
+
+    int ran = 0, failed = 0;
+    for (int i = 0; i < COUNT(suites); i++) {
+        if (suite_name && strcmp(suite_name, suites[i].name) != 0) continue;
+        const char* const* texts = file_texts ? (const char* const*)file_texts : suites[i].texts;
+        int text_count = file_texts ? file_text_count : suites[i].text_count;
+        failed |= run_suite(handle, &suites[i], texts, text_count, iterations);
+        ran++;
+    }
+    if (!ran) {
+        usage(argv[0]);
+        failed = 2;
+    }
+
+    openjtalk_native_destroy(handle);
+    for (int i = 0; i < file_text_count; i++) free(file_texts[i]);
+    free(file_texts);
+    return failed;
+}
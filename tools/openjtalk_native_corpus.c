@@ -0,0 +1,566 @@
+/*
+ * openjtalk_native_corpus - phonemize a text/TSV corpus line by line.
+ *
+ * The input file is memory-mapped and cut into chunks of lines. Worker
+ * threads, each with its own handle on a shared dictionary, phonemize
+ * whole chunks and format them into private buffers; chunks are written
+ * in input order as soon as they are complete, so output streams with
+ * bounded memory regardless of corpus size.
+ *
+ * Output formats:
+ *   jsonl   {"line":N,"phonemes":"...","prosody":"...","error":E} per line
+ *           ("prosody" only with --prosody, "error" only when non-zero)
+ *   binary  little-endian records after an 8-byte "OJTNCORP" magic,
+ *           uint32 version (1) and uint32 flags (1 = prosody):
+ *             uint64 line, int32 error, uint32 count,
+ *             uint8  phoneme_id[count]  (openjtalk_native_get_phoneme_symbol)
+ *             int8   a1[count], a2[count], a3[count]  (flags & 1 only)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "openjtalk_native.h"
+#include "openjtalk_native_thread.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#define CHUNK_LINES 256
+#define MAX_LINE_BYTES 4096
+#define BINARY_VERSION 1u
+#define BINARY_FLAG_PROSODY 1u
+
+typedef enum { FORMAT_JSONL, FORMAT_BINARY } OutputFormat;
+
+typedef struct {
+    const char* dict_path;
+    const char* input_path;
+    const char* output_path;
+    OutputFormat format;
+    int threads;
+    int column;              /* TSV column holding the text, -1 for the whole line */
+    int prosody;
+} Options;
+
+/* Growable output buffer owned by one chunk */
+typedef struct {
+    char* data;
+    size_t size;
+    size_t capacity;
+} Buffer;
+
+typedef struct {
+    Buffer out;
+    uint64_t lines;
+    uint64_t errors;
+    int ready;
+} Slot;
+
+typedef struct {
+    const Options* options;
+    const char* data;        /* Mapped input */
+    size_t size;
+    FILE* output;
+
+    ojtn_mutex_t lock;
+    ojtn_cond_t slot_free;
+    size_t cursor;           /* Next unread byte */
+    uint64_t next_line;      /* Line number of the byte at cursor, 1-based */
+    uint64_t next_chunk;     /* Sequence number handed out next */
+    uint64_t next_write;     /* Sequence number to be written next */
+    int slot_count;          /* Bounds how far workers may run ahead of the writer */
+    Slot* slots;
+    uint64_t lines;
+    uint64_t errors;
+    int write_failed;
+} Corpus;
+
+typedef struct {
+    Corpus* corpus;
+    void* handle;
+    OpenJTalkNativePhonemeResult plain;     /* Reused for every line */
+    OpenJTalkNativeProsodyResult prosody;
+    ojtn_thread_t thread;
+} Worker;
+
+/* Symbol -> ID lookup built from the library's phoneme inventory */
+static const char* phoneme_symbols[256];
+static int phoneme_symbol_count = 0;
+
+static void init_phoneme_symbols(void) {
+    const char* symbol;
+    while (phoneme_symbol_count < 256 &&
+           (symbol = openjtalk_native_get_phoneme_symbol(phoneme_symbol_count)) != NULL) {
+        phoneme_symbols[phoneme_symbol_count++] = symbol;
+    }
+}
+
+static int lookup_phoneme_id(const char* symbol, size_t len) {
+    for (int i = 0; i < phoneme_symbol_count; i++) {
+        if (strlen(phoneme_symbols[i]) == len && strncmp(phoneme_symbols[i], symbol, len) == 0) return i;
+    }
+    return 255;
+}
+
+static double now_seconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#endif
+}
+
+/* Buffer helpers; allocation failure aborts, there is no way to continue */
+
+static void buffer_reserve(Buffer* b, size_t extra) {
+    if (b->size + extra <= b->capacity) return;
+    size_t capacity = b->capacity ? b->capacity : 65536;
+    while (capacity < b->size + extra) capacity *= 2;
+    char* data = (char*)realloc(b->data, capacity);
+    if (!data) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    b->data = data;
+    b->capacity = capacity;
+}
+
+static void buffer_append(Buffer* b, const void* data, size_t len) {
+    buffer_reserve(b, len);
+    memcpy(b->data + b->size, data, len);
+    b->size += len;
+}
+
+static void buffer_printf_u64(Buffer* b, const char* prefix, uint64_t value) {
+    char tmp[64];
+    int n = snprintf(tmp, sizeof(tmp), "%s%llu", prefix, (unsigned long long)value);
+    buffer_append(b, tmp, (size_t)n);
+}
+
+static void buffer_put_u32(Buffer* b, uint32_t v) {
+    unsigned char bytes[4] = { (unsigned char)v, (unsigned char)(v >> 8), (unsigned char)(v >> 16), (unsigned char)(v >> 24) };
+    buffer_append(b, bytes, 4);
+}
+
+static void buffer_put_u64(Buffer* b, uint64_t v) {
+    buffer_put_u32(b, (uint32_t)v);
+    buffer_put_u32(b, (uint32_t)(v >> 32));
+}
+
+/* Phoneme strings are ASCII, but keep JSON valid whatever they contain */
+static void buffer_append_json_string(Buffer* b, const char* s) {
+    buffer_append(b, "\"", 1);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            char esc[2] = { '\\', (char)c };
+            buffer_append(b, esc, 2);
+        } else if (c < 0x20) {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+            buffer_append(b, esc, 6);
+        } else {
+            buffer_append(b, s, 1);
+        }
+    }
+    buffer_append(b, "\"", 1);
+}
+
+static void write_json_record(Buffer* b, uint64_t line, int error, const char* phonemes, const char* prosody) {
+    buffer_printf_u64(b, "{\"line\":", line);
+    buffer_append(b, ",\"phonemes\":", 12);
+    buffer_append_json_string(b, phonemes ? phonemes : "");
+    if (prosody) {
+        buffer_append(b, ",\"prosody\":", 11);
+        buffer_append_json_string(b, prosody);
+    }
+    if (error != OPENJTALK_NATIVE_SUCCESS) {
+        char tmp[32];
+        int n = snprintf(tmp, sizeof(tmp), ",\"error\":%d", error);
+        buffer_append(b, tmp, (size_t)n);
+    }
+    buffer_append(b, "}\n", 2);
+}
+
+static signed char clamp_int8(int v) {
+    return (signed char)(v < -128 ? -128 : v > 127 ? 127 : v);
+}
+
+static void write_binary_record(Buffer* b, uint64_t line, int error, const char* phonemes, int count,
+                                const OpenJTalkNativeProsodyResult* prosody, int with_prosody) {
+    buffer_put_u64(b, line);
+    buffer_put_u32(b, (uint32_t)error);
+    buffer_put_u32(b, (uint32_t)count);
+
+    buffer_reserve(b, (size_t)count * (with_prosody ? 4 : 1));
+    const char* p = phonemes;
+    for (int i = 0; i < count; i++) {
+        while (*p == ' ') p++;
+        const char* end = p;
+        while (*end && *end != ' ') end++;
+        b->data[b->size++] = (char)lookup_phoneme_id(p, (size_t)(end - p));
+        p = end;
+    }
+    if (with_prosody) {
+        for (int i = 0; i < count; i++) b->data[b->size++] = (char)clamp_int8(prosody->prosody_a1[i]);
+        for (int i = 0; i < count; i++) b->data[b->size++] = (char)clamp_int8(prosody->prosody_a2[i]);
+        for (int i = 0; i < count; i++) b->data[b->size++] = (char)clamp_int8(prosody->prosody_a3[i]);
+    }
+}
+
+/* Phonemize one line into the chunk buffer; returns non-zero on error */
+static int process_line(Worker* worker, Buffer* out, uint64_t line, const char* start, size_t len) {
+    const Options* options = worker->corpus->options;
+    char text[MAX_LINE_BYTES + 1];
+
+    if (len > 0 && start[len - 1] == '\r') len--;
+    if (options->column >= 0) {
+        /* Narrow [start, start + len) to the requested TSV column */
+        const char* end = start + len;
+        for (int c = 0; c < options->column && start < end; c++) {
+            const char* tab = (const char*)memchr(start, '\t', (size_t)(end - start));
+            start = tab ? tab + 1 : end;
+        }
+        const char* tab = (const char*)memchr(start, '\t', (size_t)(end - start));
+        len = (size_t)((tab ? tab : end) - start);
+    }
+
+    int error = OPENJTALK_NATIVE_ERROR_INVALID_INPUT;
+    const OpenJTalkNativePhonemeResult* plain = NULL;
+    const OpenJTalkNativeProsodyResult* prosody = NULL;
+
+    if (len > 0 && len <= MAX_LINE_BYTES) {
+        memcpy(text, start, len);
+        text[len] = '\0';
+        if (options->prosody) {
+            error = openjtalk_native_phonemize_with_prosody_into(worker->handle, text, &worker->prosody);
+            if (error == OPENJTALK_NATIVE_SUCCESS) prosody = &worker->prosody;
+        } else {
+            error = openjtalk_native_phonemize_into(worker->handle, text, &worker->plain);
+            if (error == OPENJTALK_NATIVE_SUCCESS) plain = &worker->plain;
+        }
+    }
+
+    const char* phonemes = plain ? plain->phonemes : prosody ? prosody->phonemes : NULL;
+    int count = plain ? plain->phoneme_count : prosody ? prosody->phoneme_count : 0;
+
+    if (options->format == FORMAT_JSONL) {
+        write_json_record(out, line, error, phonemes,
+                          options->prosody ? (prosody ? prosody->prosody_symbols : "") : NULL);
+    } else {
+        write_binary_record(out, line, error, phonemes, count, prosody, options->prosody);
+    }
+    return error != OPENJTALK_NATIVE_SUCCESS;
+}
+
+/* Write every consecutive completed chunk; caller holds the lock */
+static void flush_ready(Corpus* corpus) {
+    for (;;) {
+        Slot* slot = &corpus->slots[corpus->next_write % corpus->slot_count];
+        if (!slot->ready) break;
+        if (!corpus->write_failed && slot->out.size > 0 &&
+            fwrite(slot->out.data, 1, slot->out.size, corpus->output) != slot->out.size) {
+            corpus->write_failed = 1;
+        }
+        corpus->lines += slot->lines;
+        corpus->errors += slot->errors;
+        slot->out.size = 0;
+        slot->ready = 0;
+        corpus->next_write++;
+        ojtn_cond_broadcast(&corpus->slot_free);
+    }
+}
+
+static void worker_main(void* arg) {
+    Worker* worker = (Worker*)arg;
+    Corpus* corpus = worker->corpus;
+
+    for (;;) {
+        ojtn_mutex_lock(&corpus->lock);
+        while (corpus->cursor < corpus->size && corpus->next_chunk - corpus->next_write >= (uint64_t)corpus->slot_count) {
+            ojtn_cond_wait(&corpus->slot_free, &corpus->lock);
+        }
+        if (corpus->cursor >= corpus->size) {
+            ojtn_mutex_unlock(&corpus->lock);
+            break;
+        }
+
+        /* Claim the next CHUNK_LINES lines */
+        uint64_t seq = corpus->next_chunk++;
+        uint64_t first_line = corpus->next_line;
+        size_t begin = corpus->cursor;
+        size_t end = begin;
+        int lines = 0;
+        while (end < corpus->size && lines < CHUNK_LINES) {
+            const char* nl = (const char*)memchr(corpus->data + end, '\n', corpus->size - end);
+            end = nl ? (size_t)(nl - corpus->data) + 1 : corpus->size;
+            lines++;
+        }
+        corpus->cursor = end;
+        corpus->next_line += (uint64_t)lines;
+        Slot* slot = &corpus->slots[seq % corpus->slot_count];
+        Buffer out = slot->out;
+        slot->out.data = NULL;
+        slot->out.capacity = 0;
+        ojtn_mutex_unlock(&corpus->lock);
+
+        /* Format outside the lock into the slot's recycled buffer */
+        uint64_t errors = 0;
+        size_t pos = begin;
+        for (int i = 0; i < lines; i++) {
+            const char* nl = (const char*)memchr(corpus->data + pos, '\n', end - pos);
+            size_t line_end = nl ? (size_t)(nl - corpus->data) : end;
+            errors += (uint64_t)process_line(worker, &out, first_line + (uint64_t)i, corpus->data + pos, line_end - pos);
+            pos = line_end + 1;
+        }
+
+        ojtn_mutex_lock(&corpus->lock);
+        slot->out = out;
+        slot->lines = (uint64_t)lines;
+        slot->errors = errors;
+        slot->ready = 1;
+        flush_ready(corpus);
+        ojtn_mutex_unlock(&corpus->lock);
+    }
+}
+
+/* Input mapping */
+
+typedef struct {
+    const char* data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+} MappedFile;
+
+static int map_file(const char* path, MappedFile* m) {
+    memset(m, 0, sizeof(*m));
+#ifdef _WIN32
+    m->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                          FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (m->file == INVALID_HANDLE_VALUE) return -1;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m->file, &size)) {
+        CloseHandle(m->file);
+        return -1;
+    }
+    m->size = (size_t)size.QuadPart;
+    if (m->size == 0) return 0;
+    m->mapping = CreateFileMappingA(m->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!m->mapping) {
+        CloseHandle(m->file);
+        return -1;
+    }
+    m->data = (const char*)MapViewOfFile(m->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!m->data) {
+        CloseHandle(m->mapping);
+        CloseHandle(m->file);
+        return -1;
+    }
+    return 0;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    m->size = (size_t)st.st_size;
+    if (m->size > 0) {
+        void* data = mmap(NULL, m->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+        madvise(data, m->size, MADV_SEQUENTIAL);
+        m->data = (const char*)data;
+    }
+    close(fd);
+    return 0;
+#endif
+}
+
+static void unmap_file(MappedFile* m) {
+#ifdef _WIN32
+    if (m->data) UnmapViewOfFile(m->data);
+    if (m->mapping) CloseHandle(m->mapping);
+    if (m->file && m->file != INVALID_HANDLE_VALUE) CloseHandle(m->file);
+#else
+    if (m->data) munmap((void*)m->data, m->size);
+#endif
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+        "Usage: %s -d DICT -i INPUT [-o OUTPUT] [-f jsonl|binary] [-j THREADS] [-c COLUMN] [--prosody]\n"
+        "  -d DICT      dictionary directory\n"
+        "  -i INPUT     UTF-8 text or TSV file, one utterance per line\n"
+        "  -o OUTPUT    output file (default: stdout)\n"
+        "  -f FORMAT    jsonl (default) or binary\n"
+        "  -j THREADS   worker threads (default: number of CPUs)\n"
+        "  -c COLUMN    0-based TSV column holding the text (default: whole line)\n"
+        "  --prosody    include prosody symbols (jsonl) or A1-A3 (binary)\n",
+        argv0);
+}
+
+static int parse_options(int argc, char** argv, Options* options) {
+    memset(options, 0, sizeof(*options));
+    options->format = FORMAT_JSONL;
+    options->column = -1;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--prosody") == 0) {
+            options->prosody = 1;
+            continue;
+        }
+        if (arg[0] != '-' || !arg[1] || arg[2] || !value) return -1;
+        switch (arg[1]) {
+            case 'd': options->dict_path = value; break;
+            case 'i': options->input_path = value; break;
+            case 'o': options->output_path = value; break;
+            case 'j': options->threads = atoi(value); break;
+            case 'c': options->column = atoi(value); break;
+            case 'f':
+                if (strcmp(value, "jsonl") == 0) options->format = FORMAT_JSONL;
+                else if (strcmp(value, "binary") == 0) options->format = FORMAT_BINARY;
+                else return -1;
+                break;
+            default: return -1;
+        }
+        i++;
+    }
+    if (!options->dict_path || !options->input_path) return -1;
+    if (options->threads <= 0) options->threads = ojtn_cpu_count();
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (parse_options(argc, argv, &options) != 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    MappedFile input;
+    if (map_file(options.input_path, &input) != 0) {
+        fprintf(stderr, "cannot open input: %s\n", options.input_path);
+        return 1;
+    }
+
+    FILE* output = stdout;
+    if (options.output_path) {
+        output = fopen(options.output_path, "wb");
+        if (!output) {
+            fprintf(stderr, "cannot open output: %s\n", options.output_path);
+            unmap_file(&input);
+            return 1;
+        }
+    }
+#ifdef _WIN32
+    else {
+        _setmode(_fileno(stdout), _O_BINARY);
+    }
+#endif
+
+    init_phoneme_symbols();
+
+    Corpus corpus;
+    memset(&corpus, 0, sizeof(corpus));
+    corpus.options = &options;
+    corpus.data = input.data;
+    corpus.size = input.size;
+    corpus.output = output;
+    corpus.next_line = 1;
+    corpus.slot_count = options.threads * 4;
+    corpus.slots = (Slot*)calloc((size_t)corpus.slot_count, sizeof(Slot));
+    Worker* workers = (Worker*)calloc((size_t)options.threads, sizeof(Worker));
+    if (!corpus.slots || !workers) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    ojtn_mutex_init(&corpus.lock);
+    ojtn_cond_init(&corpus.slot_free);
+
+    if (options.format == FORMAT_BINARY) {
+        Buffer header = { NULL, 0, 0 };
+        buffer_append(&header, "OJTNCORP", 8);
+        buffer_put_u32(&header, BINARY_VERSION);
+        buffer_put_u32(&header, options.prosody ? BINARY_FLAG_PROSODY : 0);
+        fwrite(header.data, 1, header.size, output);
+        free(header.data);
+    }
+
+    /* Every handle maps the same dictionary files and shares its word cache */
+    int started = 0;
+    int status = 0;
+    for (int i = 0; i < options.threads; i++) {
+        workers[i].corpus = &corpus;
+        workers[i].handle = openjtalk_native_create(options.dict_path);
+        if (!workers[i].handle) {
+            fprintf(stderr, "cannot load dictionary: %s\n", options.dict_path);
+            status = 1;
+            break;
+        }
+    }
+
+    double start_time = now_seconds();
+    if (status == 0) {
+        for (int i = 0; i < options.threads; i++) {
+            if (ojtn_thread_create(&workers[i].thread, worker_main, &workers[i]) != 0) break;
+            started++;
+        }
+        if (started == 0) worker_main(&workers[0]);
+    }
+    for (int i = 0; i < started; i++) {
+        ojtn_thread_join(workers[i].thread);
+    }
+    double elapsed = now_seconds() - start_time;
+
+    for (int i = 0; i < options.threads; i++) {
+        openjtalk_native_clear_result(&workers[i].plain);
+        openjtalk_native_clear_prosody_result(&workers[i].prosody);
+        openjtalk_native_destroy(workers[i].handle);
+    }
+    for (int i = 0; i < corpus.slot_count; i++) {
+        free(corpus.slots[i].out.data);
+    }
+
+    if (fflush(output) != 0 || corpus.write_failed) {
+        fprintf(stderr, "write error\n");
+        status = 1;
+    }
+    if (output != stdout) fclose(output);
+
+    if (status == 0) {
+        fprintf(stderr, "lines=%llu errors=%llu threads=%d seconds=%.3f lines/sec=%.0f\n",
+            (unsigned long long)corpus.lines, (unsigned long long)corpus.errors, options.threads,
+            elapsed, elapsed > 0.0 ? (double)corpus.lines / elapsed : 0.0);
+    }
+
+    ojtn_cond_destroy(&corpus.slot_free);
+    ojtn_mutex_destroy(&corpus.lock);
+    free(workers);
+    free(corpus.slots);
+    unmap_file(&input);
+    return status;
+}
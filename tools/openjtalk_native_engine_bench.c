@@ -0,0 +1,272 @@
+/*
+ * openjtalk_native_engine_bench - interactive latency under bulk load.
+ *
+ * One thread sends short interactive documents at a fixed interval while
+ * bulk threads keep the engine saturated with long documents. Each
+ * scenario reports interactive latency percentiles, the queue-wait part of
+ * it, and bulk throughput:
+ *
+ *   idle   interactive requests only
+ *   fifo   bulk documents share the interactive lane, no reserved workers
+ *          (the behaviour of a single FIFO queue)
+ *   lanes  bulk documents in the bulk lane with reserved_workers workers
+ *          kept for interactive requests
+ *
+ * -p both runs every scenario on an unpinned engine and then on one created
+ * with OPENJTALK_NATIVE_ENGINE_PIN_WORKERS, for comparing throughput and
+ * tail latency with and without CPU pinning.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "openjtalk_native.h"
+#include "openjtalk_native_thread.h"
+
+static const char* const interactive_texts[] = {
+    "こんにちは",
+    "今日はいい天気ですね",
+    "ご注文をどうぞ",
+    "明日は雨でしょうか",
+    "少々お待ちください"
+};
+
+static const char* const bulk_sentences[] = {
+    "日本語の音声合成システムを開発しています。",
+    "東京駅から新幹線に乗って大阪へ向かいました。",
+    "図書館で借りた本を返すのを忘れていました。",
+    "週末は家族と一緒に公園を散歩しました。",
+    "新しい機能についてご意見をお聞かせください。"
+};
+
+#define BULK_REPEAT 40      /* Sentences per bulk document: 5 * BULK_REPEAT */
+
+typedef struct {
+    const char* name;
+    int bulk_priority;       /* -1: no bulk load */
+    int reserved_workers;
+} Scenario;
+
+static const Scenario scenarios[] = {
+    { "idle",  -1,                                    0 },
+    { "fifo",  OPENJTALK_NATIVE_PRIORITY_INTERACTIVE, 0 },
+    { "lanes", OPENJTALK_NATIVE_PRIORITY_BULK,        1 }
+};
+
+typedef struct {
+    void* engine;
+    const char* document;
+    int priority;
+    volatile int64_t* stop;
+    long sentences;
+    ojtn_thread_t thread;
+} BulkThread;
+
+static double now_seconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#endif
+}
+
+static void sleep_seconds(double seconds) {
+    if (seconds <= 0.0) return;
+#ifdef _WIN32
+    Sleep((DWORD)(seconds * 1e3));
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)seconds;
+    ts.tv_nsec = (long)((seconds - (double)ts.tv_sec) * 1e9);
+    nanosleep(&ts, NULL);
+#endif
+}
+
+static void bulk_main(void* arg) {
+    BulkThread* b = (BulkThread*)arg;
+    while (!ojtn_atomic_load(b->stop)) {
+        OpenJTalkNativeDocumentResult* doc =
+            openjtalk_native_engine_phonemize_document_with_priority(b->engine, b->document, b->priority);
+        if (doc) b->sentences += doc->sentence_count;
+        openjtalk_native_free_document_result(doc);
+    }
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double* sorted, int count, int p) {
+    int i = count * p / 100;
+    return sorted[i < count ? i : count - 1];
+}
+
+static int run_scenario(void* engine, const Scenario* scenario, const char* bulk_document,
+                        int bulk_threads, int requests, double interval) {
+    char value[16];
+    snprintf(value, sizeof(value), "%d", scenario->reserved_workers);
+    if (openjtalk_native_engine_set_option(engine, "reserved_workers", value) != OPENJTALK_NATIVE_SUCCESS) {
+        fprintf(stderr, "%s: cannot reserve %s workers\n", scenario->name, value);
+        return 1;
+    }
+
+    volatile int64_t stop = 0;
+    int bulk_count = scenario->bulk_priority < 0 ? 0 : bulk_threads;
+    BulkThread* bulk = (BulkThread*)calloc((size_t)(bulk_count > 0 ? bulk_count : 1), sizeof(BulkThread));
+    double* latency = (double*)malloc((size_t)requests * sizeof(double));
+    double* wait = (double*)malloc((size_t)requests * sizeof(double));
+    if (!bulk || !latency || !wait) return 1;
+
+    int started = 0;
+    for (int i = 0; i < bulk_count; i++) {
+        bulk[i].engine = engine;
+        bulk[i].document = bulk_document;
+        bulk[i].priority = scenario->bulk_priority;
+        bulk[i].stop = &stop;
+        if (ojtn_thread_create(&bulk[i].thread, bulk_main, &bulk[i]) != 0) break;
+        started++;
+    }
+    /* Let the bulk load fill the queues before measuring */
+    if (started) sleep_seconds(0.2);
+
+    int errors = 0;
+    double start = now_seconds();
+    for (int i = 0; i < requests; i++) {
+        double t0 = now_seconds();
+        OpenJTalkNativeDocumentResult* doc = openjtalk_native_engine_phonemize_document(
+            engine, interactive_texts[i % (int)(sizeof(interactive_texts) / sizeof(interactive_texts[0]))]);
+        latency[i] = now_seconds() - t0;
+        wait[i] = doc ? doc->queue_wait_seconds : 0.0;
+        if (!doc || doc->sentence_errors[0] != OPENJTALK_NATIVE_SUCCESS) errors++;
+        openjtalk_native_free_document_result(doc);
+        sleep_seconds(interval - latency[i]);
+    }
+    double elapsed = now_seconds() - start;
+
+    ojtn_atomic_add(&stop, 1);
+    long bulk_sentences = 0;
+    for (int i = 0; i < started; i++) {
+        ojtn_thread_join(bulk[i].thread);
+        bulk_sentences += bulk[i].sentences;
+    }
+
+    qsort(latency, (size_t)requests, sizeof(double), compare_double);
+    qsort(wait, (size_t)requests, sizeof(double), compare_double);
+    printf("  %-6s latency_ms p50=%.3f p99=%.3f max=%.3f  wait_ms p50=%.3f p99=%.3f  bulk_sentences/sec=%.0f errors=%d\n",
+        scenario->name, percentile(latency, requests, 50) * 1e3, percentile(latency, requests, 99) * 1e3,
+        latency[requests - 1] * 1e3, percentile(wait, requests, 50) * 1e3, percentile(wait, requests, 99) * 1e3,
+        (double)bulk_sentences / elapsed, errors);
+
+    free(bulk);
+    free(latency);
+    free(wait);
+    return errors != 0;
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+        "Usage: %s -d DICT [-w WORKERS] [-b BULK] [-n REQUESTS] [-t INTERVAL_US] [-s SCENARIO]\n"
+        "  -d DICT         dictionary directory\n"
+        "  -w WORKERS      engine workers (default: number of CPUs)\n"
+        "  -b BULK         bulk submitter threads (default: 2)\n"
+        "  -n REQUESTS     interactive requests per scenario (default: 500)\n"
+        "  -t INTERVAL_US  interval between interactive requests (default: 2000)\n"
+        "  -s SCENARIO     idle, fifo or lanes (default: all)\n"
+        "  -p PINNING      off, on or both (default: off)\n",
+        argv0);
+}
+
+int main(int argc, char** argv) {
+    const char* dict_path = NULL;
+    const char* scenario_name = NULL;
+    const char* pinning = "off";
+    int workers = 0, bulk_threads = 2, requests = 500, interval_us = 2000;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 < argc && strcmp(argv[i], "-d") == 0) dict_path = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "-w") == 0) workers = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-b") == 0) bulk_threads = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-n") == 0) requests = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-t") == 0) interval_us = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-s") == 0) scenario_name = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "-p") == 0) pinning = argv[++i];
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    int pin_first = strcmp(pinning, "on") == 0;
+    int pin_last = strcmp(pinning, "off") != 0;
+    if (!dict_path || requests <= 0 || bulk_threads < 0 || interval_us < 0 ||
+        (strcmp(pinning, "off") != 0 && strcmp(pinning, "on") != 0 && strcmp(pinning, "both") != 0)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    /* One long bulk document, sentences repeated BULK_REPEAT times */
+    size_t unit = 0;
+    int sentence_count = (int)(sizeof(bulk_sentences) / sizeof(bulk_sentences[0]));
+    for (int i = 0; i < sentence_count; i++) unit += strlen(bulk_sentences[i]);
+    char* document = (char*)malloc(unit * BULK_REPEAT + 1);
+    if (!document) return 1;
+    char* p = document;
+    for (int r = 0; r < BULK_REPEAT; r++) {
+        for (int i = 0; i < sentence_count; i++) {
+            size_t n = strlen(bulk_sentences[i]);
+            memcpy(p, bulk_sentences[i], n);
+            p += n;
+        }
+    }
+    *p = '\0';
+
+    int failed = 0;
+    for (int pin = pin_first; pin <= pin_last && !failed; pin++) {
+        void* engine = openjtalk_native_engine_create_with_flags(dict_path, workers,
+                                                                 pin ? OPENJTALK_NATIVE_ENGINE_PIN_WORKERS : 0);
+        if (!engine) {
+            fprintf(stderr, "cannot create engine on %s\n", dict_path);
+            failed = 1;
+            break;
+        }
+        int worker_count = openjtalk_native_engine_get_worker_count(engine);
+        if (worker_count < 2) {
+            fprintf(stderr, "need at least 2 workers to reserve one\n");
+            openjtalk_native_engine_destroy(engine);
+            failed = 2;
+            break;
+        }
+
+        printf("workers=%d bulk_threads=%d requests=%d interval_us=%d pinned=%s", worker_count, bulk_threads,
+            requests, interval_us, pin ? "yes" : "no");
+        if (pin) {
+            printf(" cpus=");
+            for (int i = 0; i < worker_count; i++) {
+                printf("%s%d", i ? "," : "", openjtalk_native_engine_get_worker_cpu(engine, i));
+            }
+        }
+        printf("\n");
+
+        int ran = 0;
+        for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+            if (scenario_name && strcmp(scenario_name, scenarios[i].name) != 0) continue;
+            failed |= run_scenario(engine, &scenarios[i], document, bulk_threads, requests, interval_us / 1e6);
+            ran++;
+        }
+        if (!ran) {
+            usage(argv[0]);
+            failed = 2;
+        }
+        openjtalk_native_engine_destroy(engine);
+    }
+
+    free(document);
+    return failed;
+}
@@ -0,0 +1,685 @@
+/*
+ * openjtalk_native_server - local phonemization daemon.
+ *
+ * Serves phonemize / prosody requests over a Unix domain socket using the
+ * binary protocol in src/openjtalk_native_protocol.h. One dictionary is
+ * loaded for the whole host: every worker owns a handle on it and they all
+ * share its word cache.
+ *
+ * A single I/O thread polls the listening socket and all connections and
+ * turns complete request frames into jobs. Identical in-flight requests
+ * (same type and text) are coalesced into one job; when a worker finishes
+ * it answers every waiting request from the same encoded payload.
+ * Responses are tagged with the request ID, so clients may pipeline.
+ *
+ * Sockets are nonblocking and nothing ever waits on a slow reader: a
+ * response goes straight to the socket when it fits and is otherwise queued
+ * on the connection for the I/O thread to flush on POLLOUT. The I/O thread
+ * stops reading from a connection while its queue or its unanswered
+ * requests are over a limit, and drops it if the queue still grows past
+ * OUTPUT_LIMIT.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "openjtalk_native.h"
+#include "openjtalk_native_protocol.h"
+#include "openjtalk_native_thread.h"
+
+#define MAX_TEXT_BYTES 4096
+#define INFLIGHT_BUCKETS 1024
+#define OUTPUT_HIGH_WATER (256 * 1024)      /* Stop reading requests above this much queued output */
+#define OUTPUT_LIMIT (16 * 1024 * 1024)     /* Drop a connection whose queued output exceeds this */
+#define MAX_PENDING_REQUESTS 256            /* Stop reading requests while this many are unanswered */
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0   /* SIGPIPE is ignored process-wide instead */
+#endif
+
+typedef struct Connection {
+    int fd;
+    ojtn_mutex_t write_lock; /* Guards the output queue, pending, throttled and failed */
+    volatile int64_t refs;   /* I/O thread + one per pending request */
+    unsigned char* rx;       /* Partially received frame */
+    size_t rx_size;
+    size_t rx_capacity;
+    size_t discard;          /* Payload bytes still to skip for a rejected request */
+    unsigned char* tx;       /* Output the socket has not taken yet: tx[tx_start..tx_size) */
+    size_t tx_start;
+    size_t tx_size;
+    size_t tx_capacity;
+    int pending;             /* Requests submitted but not yet answered */
+    int throttled;           /* The I/O thread stopped reading; wake it when a request completes */
+    int failed;              /* Send error or output limit; the I/O thread drops the connection */
+} Connection;
+
+typedef struct Waiter {
+    Connection* conn;
+    uint32_t request_id;
+    struct Waiter* next;
+} Waiter;
+
+typedef struct Job {
+    uint32_t hash;
+    uint8_t type;
+    char* text;
+    Waiter* waiters;
+    struct Job* bucket_next; /* In-flight table chain */
+    struct Job* queue_next;  /* Work queue link */
+} Job;
+
+typedef struct {
+    ojtn_mutex_t lock;       /* Guards the queue, the in-flight table and counters */
+    ojtn_cond_t work_available;
+    Job* head;
+    Job* tail;
+    Job* inflight[INFLIGHT_BUCKETS];
+    int stopping;
+    uint64_t requests;
+    uint64_t coalesced;
+} Server;
+
+typedef struct {
+    Server* server;
+    void* handle;
+    ojtn_thread_t thread;
+} Worker;
+
+static volatile sig_atomic_t shutdown_requested = 0;
+static int wake_pipe[2] = { -1, -1 };
+
+static void wake_io_thread(void) {
+    if (wake_pipe[1] >= 0) {
+        ssize_t n = write(wake_pipe[1], "x", 1);
+        (void)n;
+    }
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    shutdown_requested = 1;
+    wake_io_thread();
+}
+
+static uint32_t hash_request(uint8_t type, const char* text) {
+    uint32_t h = 2166136261u ^ type;
+    while (*text) {
+        h ^= (unsigned char)*text++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void connection_release(Connection* conn) {
+    if (ojtn_ref_release(&conn->refs) != 0) return;
+    close(conn->fd);
+    ojtn_mutex_destroy(&conn->write_lock);
+    free(conn->rx);
+    free(conn->tx);
+    free(conn);
+}
+
+/* Nonblocking send; returns the bytes the socket took (possibly 0), or -1 */
+static ssize_t send_some(int fd, const unsigned char* data, size_t len) {
+    for (;;) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n >= 0) return n;
+        if (errno == EINTR) continue;
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+}
+
+/* Caller holds write_lock */
+static void fail_connection(Connection* conn) {
+    conn->failed = 1;
+    conn->tx_start = conn->tx_size = 0;
+    shutdown(conn->fd, SHUT_RDWR);
+}
+
+/* Send what the socket takes now and queue the rest. Caller holds
+   write_lock; returns 1 when the I/O thread has to act on the connection. */
+static int queue_output(Connection* conn, const unsigned char* data, size_t len) {
+    if (conn->failed) return 0;
+    if (conn->tx_start == conn->tx_size) {
+        conn->tx_start = conn->tx_size = 0;
+        ssize_t n = send_some(conn->fd, data, len);
+        if (n < 0) {
+            fail_connection(conn);
+            return 1;
+        }
+        data += n;
+        len -= (size_t)n;
+        if (len == 0) return 0;
+    }
+    if (conn->tx_size - conn->tx_start + len > OUTPUT_LIMIT) {
+        fail_connection(conn);
+        return 1;
+    }
+    if (conn->tx_capacity - conn->tx_size < len && conn->tx_start > 0) {
+        memmove(conn->tx, conn->tx + conn->tx_start, conn->tx_size - conn->tx_start);
+        conn->tx_size -= conn->tx_start;
+        conn->tx_start = 0;
+    }
+    if (conn->tx_capacity - conn->tx_size < len) {
+        size_t capacity = conn->tx_capacity ? conn->tx_capacity : 16384;
+        while (capacity - conn->tx_size < len) capacity *= 2;
+        unsigned char* tx = (unsigned char*)realloc(conn->tx, capacity);
+        if (!tx) {
+            fail_connection(conn);
+            return 1;
+        }
+        conn->tx = tx;
+        conn->tx_capacity = capacity;
+    }
+    memcpy(conn->tx + conn->tx_size, data, len);
+    conn->tx_size += len;
+    return 1;
+}
+
+/* frame holds OJTN_HEADER_SIZE header bytes followed by the payload.
+   completes_request is set when this answers a request counted in pending. */
+static void send_response(Connection* conn, unsigned char* frame, uint8_t type, uint32_t request_id,
+                          int status, uint32_t payload_len, int completes_request) {
+    ojtn_frame_header_t h;
+    h.type = type;
+    h.request_id = request_id;
+    h.status = status;
+    h.payload_len = payload_len;
+    ojtn_pack_header(frame, &h);
+
+    ojtn_mutex_lock(&conn->write_lock);
+    int wake = queue_output(conn, frame, OJTN_HEADER_SIZE + payload_len);
+    if (completes_request) {
+        conn->pending--;
+        wake |= conn->throttled;
+    }
+    ojtn_mutex_unlock(&conn->write_lock);
+    if (wake) wake_io_thread();
+}
+
+static void send_error(Connection* conn, uint8_t type, uint32_t request_id, int status, int completes_request) {
+    unsigned char frame[OJTN_HEADER_SIZE];
+    send_response(conn, frame, type, request_id, status, 0, completes_request);
+}
+
+/* Push queued output on POLLOUT; returns -1 once the connection has failed */
+static int flush_output(Connection* conn) {
+    ojtn_mutex_lock(&conn->write_lock);
+    if (!conn->failed && conn->tx_start < conn->tx_size) {
+        ssize_t n = send_some(conn->fd, conn->tx + conn->tx_start, conn->tx_size - conn->tx_start);
+        if (n < 0) {
+            fail_connection(conn);
+        } else {
+            conn->tx_start += (size_t)n;
+        }
+    }
+    int failed = conn->failed;
+    ojtn_mutex_unlock(&conn->write_lock);
+    return failed ? -1 : 0;
+}
+
+/* Choose the poll events for a connection; returns -1 once it has failed */
+static int update_events(Connection* conn, struct pollfd* pfd) {
+    ojtn_mutex_lock(&conn->write_lock);
+    size_t queued = conn->tx_size - conn->tx_start;
+    conn->throttled = queued > OUTPUT_HIGH_WATER || conn->pending >= MAX_PENDING_REQUESTS;
+    pfd->events = (short)((conn->throttled ? 0 : POLLIN) | (queued > 0 ? POLLOUT : 0));
+    int failed = conn->failed;
+    ojtn_mutex_unlock(&conn->write_lock);
+    return failed ? -1 : 0;
+}
+
+/* Payload encoding (layouts documented in openjtalk_native_protocol.h) */
+
+static unsigned char* put_i32_array(unsigned char* p, const int* values, int n) {
+    for (int i = 0; i < n; i++, p += 4) ojtn_put_u32(p, (uint32_t)values[i]);
+    return p;
+}
+
+static unsigned char* put_string(unsigned char* p, const char* s, size_t len) {
+    ojtn_put_u32(p, (uint32_t)len);
+    memcpy(p + 4, s, len);
+    return p + 4 + len;
+}
+
+static unsigned char* encode_phonemes(const OpenJTalkNativePhonemeResult* r, uint32_t* payload_len) {
+    size_t n = (size_t)r->phoneme_count;
+    size_t phonemes_len = strlen(r->phonemes);
+    size_t size = 8 + n * 8 + 4 + phonemes_len;
+    unsigned char* frame = (unsigned char*)malloc(OJTN_HEADER_SIZE + size);
+    if (!frame) return NULL;
+
+    unsigned char* p = frame + OJTN_HEADER_SIZE;
+    ojtn_put_u32(p, (uint32_t)n);
+    ojtn_put_f32(p + 4, r->total_duration);
+    p = put_i32_array(p + 8, r->phoneme_ids, r->phoneme_count);
+    for (size_t i = 0; i < n; i++, p += 4) ojtn_put_f32(p, r->durations[i]);
+    put_string(p, r->phonemes, phonemes_len);
+
+    *payload_len = (uint32_t)size;
+    return frame;
+}
+
+static unsigned char* encode_prosody(const OpenJTalkNativeProsodyResult* r, uint32_t* payload_len) {
+    size_t n = (size_t)r->phoneme_count;
+    size_t phonemes_len = strlen(r->phonemes);
+    size_t symbols_len = strlen(r->prosody_symbols);
+    size_t size = 8 + n * 24 + 4 + phonemes_len + 4 + symbols_len;
+    unsigned char* frame = (unsigned char*)malloc(OJTN_HEADER_SIZE + size);
+    if (!frame) return NULL;
+
+    unsigned char* p = frame + OJTN_HEADER_SIZE;
+    ojtn_put_u32(p, (uint32_t)n);
+    ojtn_put_u32(p + 4, (uint32_t)r->prosody_symbol_count);
+    p = put_i32_array(p + 8, r->prosody_a1, r->phoneme_count);
+    p = put_i32_array(p, r->prosody_a2, r->phoneme_count);
+    p = put_i32_array(p, r->prosody_a3, r->phoneme_count);
+    p = put_i32_array(p, r->prosody_marks, r->phoneme_count);
+    p = put_i32_array(p, r->accent_phrase_index, r->phoneme_count);
+    p = put_i32_array(p, r->mora_index, r->phoneme_count);
+    p = put_string(p, r->phonemes, phonemes_len);
+    put_string(p, r->prosody_symbols, symbols_len);
+
+    *payload_len = (uint32_t)size;
+    return frame;
+}
+
+static void worker_main(void* arg) {
+    Worker* worker = (Worker*)arg;
+    Server* server = worker->server;
+
+    for (;;) {
+        ojtn_mutex_lock(&server->lock);
+        while (!server->head && !server->stopping) {
+            ojtn_cond_wait(&server->work_available, &server->lock);
+        }
+        Job* job = server->head;
+        if (!job) {
+            ojtn_mutex_unlock(&server->lock);
+            break;
+        }
+        server->head = job->queue_next;
+        if (!server->head) server->tail = NULL;
+        ojtn_mutex_unlock(&server->lock);
+
+        int status = OPENJTALK_NATIVE_SUCCESS;
+        uint32_t payload_len = 0;
+        unsigned char* frame = NULL;
+        if (job->type == OJTN_MSG_PHONEMIZE) {
+            OpenJTalkNativePhonemeResult* r = openjtalk_native_phonemize(worker->handle, job->text);
+            if (r) frame = encode_phonemes(r, &payload_len);
+            openjtalk_native_free_result(r);
+        } else {
+            OpenJTalkNativeProsodyResult* r = openjtalk_native_phonemize_with_prosody(worker->handle, job->text);
+            if (r) frame = encode_prosody(r, &payload_len);
+            openjtalk_native_free_prosody_result(r);
+        }
+        if (!frame) {
+            status = openjtalk_native_get_last_error(worker->handle);
+            if (status == OPENJTALK_NATIVE_SUCCESS) status = OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION;
+        }
+
+        /* Unpublish the job so later identical requests start fresh, then
+           answer everyone who joined it while it ran */
+        ojtn_mutex_lock(&server->lock);
+        Job** link = &server->inflight[job->hash % INFLIGHT_BUCKETS];
+        while (*link != job) link = &(*link)->bucket_next;
+        *link = job->bucket_next;
+        Waiter* waiters = job->waiters;
+        ojtn_mutex_unlock(&server->lock);
+
+        while (waiters) {
+            Waiter* next = waiters->next;
+            if (frame) {
+                send_response(waiters->conn, frame, job->type, waiters->request_id, status, payload_len, 1);
+            } else {
+                send_error(waiters->conn, job->type, waiters->request_id, status, 1);
+            }
+            connection_release(waiters->conn);
+            free(waiters);
+            waiters = next;
+        }
+        free(frame);
+        free(job->text);
+        free(job);
+    }
+}
+
+/* Queue a request, joining an identical in-flight job when there is one */
+static void submit_request(Server* server, Connection* conn, uint8_t type, uint32_t request_id, const char* text) {
+    Waiter* waiter = (Waiter*)malloc(sizeof(Waiter));
+    if (!waiter) {
+        send_error(conn, type, request_id, OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION, 0);
+        return;
+    }
+    waiter->conn = conn;
+    waiter->request_id = request_id;
+    ojtn_atomic_add(&conn->refs, 1);
+    ojtn_mutex_lock(&conn->write_lock);
+    conn->pending++;
+    ojtn_mutex_unlock(&conn->write_lock);
+
+    uint32_t hash = hash_request(type, text);
+
+    ojtn_mutex_lock(&server->lock);
+    server->requests++;
+    Job* job = server->inflight[hash % INFLIGHT_BUCKETS];
+    while (job && !(job->hash == hash && job->type == type && strcmp(job->text, text) == 0)) {
+        job = job->bucket_next;
+    }
+    if (job) {
+        waiter->next = job->waiters;
+        job->waiters = waiter;
+        server->coalesced++;
+        ojtn_mutex_unlock(&server->lock);
+        return;
+    }
+    ojtn_mutex_unlock(&server->lock);
+
+    job = (Job*)calloc(1, sizeof(Job));
+    char* copy = job ? strdup(text) : NULL;
+    if (!copy) {
+        free(job);
+        free(waiter);
+        send_error(conn, type, request_id, OPENJTALK_NATIVE_ERROR_MEMORY_ALLOCATION, 1);
+        connection_release(conn);
+        return;
+    }
+    job->hash = hash;
+    job->type = type;
+    job->text = copy;
+    waiter->next = NULL;
+    job->waiters = waiter;
+
+    /* Only the I/O thread creates jobs, so nothing identical appeared meanwhile */
+    ojtn_mutex_lock(&server->lock);
+    job->bucket_next = server->inflight[hash % INFLIGHT_BUCKETS];
+    server->inflight[hash % INFLIGHT_BUCKETS] = job;
+    if (server->tail) {
+        server->tail->queue_next = job;
+    } else {
+        server->head = job;
+    }
+    server->tail = job;
+    ojtn_cond_signal(&server->work_available);
+    ojtn_mutex_unlock(&server->lock);
+}
+
+/* Consume complete frames from the connection's receive buffer */
+static void process_frames(Server* server, Connection* conn) {
+    size_t pos = 0;
+
+    for (;;) {
+        if (conn->discard > 0) {
+            size_t skip = conn->rx_size - pos < conn->discard ? conn->rx_size - pos : conn->discard;
+            pos += skip;
+            conn->discard -= skip;
+            if (conn->discard > 0) break;
+        }
+        if (conn->rx_size - pos < OJTN_HEADER_SIZE) break;
+
+        ojtn_frame_header_t h;
+        unsigned char* frame = conn->rx + pos;
+        if (ojtn_unpack_header(frame, &h) != 0 || h.payload_len > OJTN_MAX_REQUEST_PAYLOAD) {
+            /* Unrecoverable framing error: drop the connection */
+            shutdown(conn->fd, SHUT_RDWR);
+            conn->rx_size = 0;
+            return;
+        }
+        if (h.type != OJTN_MSG_PHONEMIZE && h.type != OJTN_MSG_PROSODY) {
+            send_error(conn, h.type, h.request_id, OPENJTALK_NATIVE_ERROR_INVALID_INPUT, 0);
+            pos += OJTN_HEADER_SIZE;
+            conn->discard = h.payload_len;
+            continue;
+        }
+        if (h.payload_len == 0 || h.payload_len > MAX_TEXT_BYTES) {
+            send_error(conn, h.type, h.request_id, OPENJTALK_NATIVE_ERROR_INVALID_INPUT, 0);
+            pos += OJTN_HEADER_SIZE;
+            conn->discard = h.payload_len;
+            continue;
+        }
+        if (conn->rx_size - pos < OJTN_HEADER_SIZE + h.payload_len) break;
+
+        char text[MAX_TEXT_BYTES + 1];
+        memcpy(text, frame + OJTN_HEADER_SIZE, h.payload_len);
+        text[h.payload_len] = '\0';
+        pos += OJTN_HEADER_SIZE + h.payload_len;
+
+        if (strlen(text) != h.payload_len) {
+            send_error(conn, h.type, h.request_id, OPENJTALK_NATIVE_ERROR_INVALID_INPUT, 0);
+        } else {
+            submit_request(server, conn, h.type, h.request_id, text);
+        }
+    }
+
+    memmove(conn->rx, conn->rx + pos, conn->rx_size - pos);
+    conn->rx_size -= pos;
+}
+
+/* Returns 0 while the connection stays open */
+static int read_connection(Server* server, Connection* conn) {
+    if (conn->rx_capacity - conn->rx_size < 4096) {
+        size_t capacity = conn->rx_capacity ? conn->rx_capacity * 2 : 16384;
+        unsigned char* rx = (unsigned char*)realloc(conn->rx, capacity);
+        if (!rx) return -1;
+        conn->rx = rx;
+        conn->rx_capacity = capacity;
+    }
+    ssize_t n = recv(conn->fd, conn->rx + conn->rx_size, conn->rx_capacity - conn->rx_size, 0);
+    if (n == 0) return -1;
+    if (n < 0) return (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    conn->rx_size += (size_t)n;
+    process_frames(server, conn);
+    return 0;
+}
+
+static int open_listener(const char* path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    unlink(path);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 128) != 0) {
+        perror("bind/listen");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+        "Usage: %s -d DICT -s SOCKET [-j THREADS]\n"
+        "  -d DICT     dictionary directory\n"
+        "  -s SOCKET   Unix domain socket path to listen on\n"
+        "  -j THREADS  worker threads (default: number of CPUs)\n",
+        argv0);
+}
+
+int main(int argc, char** argv) {
+    const char* dict_path = NULL;
+    const char* socket_path = NULL;
+    int threads = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-d") == 0) dict_path = argv[i + 1];
+        else if (strcmp(argv[i], "-s") == 0) socket_path = argv[i + 1];
+        else if (strcmp(argv[i], "-j") == 0) threads = atoi(argv[i + 1]);
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!dict_path || !socket_path || argc % 2 == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (threads <= 0) threads = ojtn_cpu_count();
+
+    Server server;
+    memset(&server, 0, sizeof(server));
+    ojtn_mutex_init(&server.lock);
+    ojtn_cond_init(&server.work_available);
+
+    Worker* workers = (Worker*)calloc((size_t)threads, sizeof(Worker));
+    if (!workers) return 1;
+    for (int i = 0; i < threads; i++) {
+        workers[i].server = &server;
+        workers[i].handle = openjtalk_native_create(dict_path);
+        if (!workers[i].handle) {
+            fprintf(stderr, "cannot load dictionary: %s\n", dict_path);
+            return 1;
+        }
+    }
+
+    int listen_fd = open_listener(socket_path);
+    if (listen_fd < 0 || pipe(wake_pipe) != 0) return 1;
+    /* Workers must never block on a full wake pipe; one pending byte is enough */
+    fcntl(wake_pipe[0], F_SETFL, fcntl(wake_pipe[0], F_GETFL) | O_NONBLOCK);
+    fcntl(wake_pipe[1], F_SETFL, fcntl(wake_pipe[1], F_GETFL) | O_NONBLOCK);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    int started = 0;
+    for (int i = 0; i < threads; i++) {
+        if (ojtn_thread_create(&workers[i].thread, worker_main, &workers[i]) != 0) break;
+        started++;
+    }
+    if (started == 0) {
+        fprintf(stderr, "cannot start worker threads\n");
+        return 1;
+    }
+    fprintf(stderr, "listening on %s with %d workers\n", socket_path, started);
+
+    /* poll set: [0] wake pipe, [1] listener, [2..] connections */
+    size_t capacity = 64, count = 2;
+    struct pollfd* fds = (struct pollfd*)calloc(capacity, sizeof(struct pollfd));
+    Connection** conns = (Connection**)calloc(capacity, sizeof(Connection*));
+    if (!fds || !conns) return 1;
+    fds[0].fd = wake_pipe[0];
+    fds[0].events = POLLIN;
+    fds[1].fd = listen_fd;
+    fds[1].events = POLLIN;
+
+    while (!shutdown_requested) {
+        /* Drop failed connections and decide what to wait for on the rest */
+        for (size_t i = 2; i < count; i++) {
+            if (update_events(conns[i], &fds[i]) != 0) {
+                connection_release(conns[i]);
+                count--;
+                fds[i] = fds[count];
+                conns[i] = conns[count];
+                i--;
+            }
+        }
+
+        if (poll(fds, (nfds_t)count, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+        if (fds[0].revents) {
+            char drain[64];
+            while (read(wake_pipe[0], drain, sizeof(drain)) > 0) {}
+            if (shutdown_requested) break;
+        }
+
+        for (size_t i = 2; i < count; i++) {
+            short revents = fds[i].revents;
+            if (!revents) continue;
+            int open = 1;
+            if (revents & POLLOUT) open = flush_output(conns[i]) == 0;
+            if (open && (revents & ~POLLOUT)) open = read_connection(&server, conns[i]) == 0;
+            if (!open) {
+                connection_release(conns[i]);
+                count--;
+                fds[i] = fds[count];
+                conns[i] = conns[count];
+                i--;
+            }
+        }
+
+        if (fds[1].revents & POLLIN) {
+            int fd = accept(listen_fd, NULL, NULL);
+            if (fd >= 0) {
+                Connection* conn = (Connection*)calloc(1, sizeof(Connection));
+                if (count == capacity) {
+                    capacity *= 2;
+                    struct pollfd* new_fds = (struct pollfd*)realloc(fds, capacity * sizeof(struct pollfd));
+                    if (new_fds) fds = new_fds;
+                    Connection** new_conns = (Connection**)realloc(conns, capacity * sizeof(Connection*));
+                    if (new_conns) conns = new_conns;
+                    if (!new_fds || !new_conns) {
+                        capacity /= 2;
+                        free(conn);
+                        conn = NULL;
+                    }
+                }
+                if (!conn) {
+                    close(fd);
+                    continue;
+                }
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                conn->fd = fd;
+                conn->refs = 1;
+                ojtn_mutex_init(&conn->write_lock);
+                fds[count].fd = fd;
+                fds[count].events = POLLIN;
+                fds[count].revents = 0;
+                conns[count] = conn;
+                count++;
+            }
+        }
+    }
+
+    /* Stop accepting, let workers drain the queue, then drop connections */
+    close(listen_fd);
+    unlink(socket_path);
+
+    ojtn_mutex_lock(&server.lock);
+    server.stopping = 1;
+    ojtn_cond_broadcast(&server.work_available);
+    ojtn_mutex_unlock(&server.lock);
+    for (int i = 0; i < started; i++) {
+        ojtn_thread_join(workers[i].thread);
+    }
+    for (size_t i = 2; i < count; i++) {
+        connection_release(conns[i]);
+    }
+    for (int i = 0; i < threads; i++) {
+        openjtalk_native_destroy(workers[i].handle);
+    }
+
+    fprintf(stderr, "requests=%llu coalesced=%llu\n",
+        (unsigned long long)server.requests, (unsigned long long)server.coalesced);
+
+    free(fds);
+    free(conns);
+    free(workers);
+    close(wake_pipe[0]);
+    close(wake_pipe[1]);
+    ojtn_cond_destroy(&server.work_available);
+    ojtn_mutex_destroy(&server.lock);
+    return 0;
+}
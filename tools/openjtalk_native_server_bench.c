@@ -0,0 +1,205 @@
+/*
+ * openjtalk_native_server_bench - load generator for openjtalk_native_server.
+ *
+ * Opens one connection per client thread and sends requests back to back
+ * through the client helper, cycling over a text list. Reports throughput
+ * and latency percentiles over all requests. Texts repeat across clients,
+ * so concurrent identical requests exercise server-side coalescing;
+ * --unique appends the request number to defeat it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "openjtalk_native.h"
+#include "openjtalk_native_thread.h"
+
+static const char* const default_texts[] = {
+    "こんにちは",
+    "今日はいい天気ですね",
+    "日本語の音声合成",
+    "明日は雨でしょうか",
+    "東京は晴れです",
+    "100円です"
+};
+
+typedef struct {
+    const char* socket_path;
+    char** texts;
+    int text_count;
+    int requests;
+    int prosody;
+    int unique;
+    int index;
+    double* latencies;       /* Seconds, one per request */
+    int completed;
+    int errors;
+    ojtn_thread_t thread;
+} Client;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void client_main(void* arg) {
+    Client* c = (Client*)arg;
+    void* client = openjtalk_native_client_connect(c->socket_path);
+    if (!client) {
+        c->errors = c->requests;
+        return;
+    }
+
+    char text[4200];
+    for (int i = 0; i < c->requests; i++) {
+        const char* base = c->texts[(c->index + i) % c->text_count];
+        if (c->unique) {
+            snprintf(text, sizeof(text), "%s%d", base, c->index * c->requests + i);
+        } else {
+            snprintf(text, sizeof(text), "%s", base);
+        }
+
+        double start = now_seconds();
+        int ok;
+        if (c->prosody) {
+            OpenJTalkNativeProsodyResult* r = openjtalk_native_client_phonemize_with_prosody(client, text);
+            ok = r != NULL;
+            openjtalk_native_free_prosody_result(r);
+        } else {
+            OpenJTalkNativePhonemeResult* r = openjtalk_native_client_phonemize(client, text);
+            ok = r != NULL;
+            openjtalk_native_free_result(r);
+        }
+        c->latencies[c->completed++] = now_seconds() - start;
+        if (!ok) {
+            c->errors++;
+            if (openjtalk_native_client_get_last_error(client) == OPENJTALK_NATIVE_ERROR_CONNECTION) break;
+        }
+    }
+    openjtalk_native_client_close(client);
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* Load one text per non-empty line */
+static int load_texts(const char* path, char*** texts) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return -1;
+    int count = 0, capacity = 0;
+    char line[4200];
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (!line[0]) continue;
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            *texts = (char**)realloc(*texts, (size_t)capacity * sizeof(char*));
+        }
+        (*texts)[count++] = strdup(line);
+    }
+    fclose(f);
+    return count;
+}
+
+static void usage(const char* argv0) {
+    fprintf(stderr,
+        "Usage: %s -s SOCKET [-c CLIENTS] [-n REQUESTS] [-i TEXTS] [--prosody] [--unique]\n"
+        "  -s SOCKET    server socket path\n"
+        "  -c CLIENTS   concurrent connections (default: 8)\n"
+        "  -n REQUESTS  requests per connection (default: 1000)\n"
+        "  -i TEXTS     file with one text per line (default: built-in sentences)\n"
+        "  --prosody    request prosody results\n"
+        "  --unique     make every text unique (no coalescing)\n",
+        argv0);
+}
+
+int main(int argc, char** argv) {
+    const char* socket_path = NULL;
+    const char* texts_path = NULL;
+    int clients = 8, requests = 1000, prosody = 0, unique = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--prosody") == 0) prosody = 1;
+        else if (strcmp(argv[i], "--unique") == 0) unique = 1;
+        else if (i + 1 < argc && strcmp(argv[i], "-s") == 0) socket_path = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "-c") == 0) clients = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-n") == 0) requests = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "-i") == 0) texts_path = argv[++i];
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!socket_path || clients <= 0 || requests <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    char** texts = NULL;
+    int text_count;
+    if (texts_path) {
+        text_count = load_texts(texts_path, &texts);
+        if (text_count <= 0) {
+            fprintf(stderr, "no texts in %s\n", texts_path);
+            return 1;
+        }
+    } else {
+        text_count = (int)(sizeof(default_texts) / sizeof(default_texts[0]));
+        texts = (char**)malloc((size_t)text_count * sizeof(char*));
+        for (int i = 0; i < text_count; i++) texts[i] = strdup(default_texts[i]);
+    }
+
+    Client* c = (Client*)calloc((size_t)clients, sizeof(Client));
+    double* latencies = (double*)malloc((size_t)clients * (size_t)requests * sizeof(double));
+    if (!c || !latencies) return 1;
+
+    double start = now_seconds();
+    int started = 0;
+    for (int i = 0; i < clients; i++) {
+        c[i].socket_path = socket_path;
+        c[i].texts = texts;
+        c[i].text_count = text_count;
+        c[i].requests = requests;
+        c[i].prosody = prosody;
+        c[i].unique = unique;
+        c[i].index = i;
+        c[i].latencies = latencies + (size_t)i * requests;
+        if (ojtn_thread_create(&c[i].thread, client_main, &c[i]) != 0) break;
+        started++;
+    }
+    for (int i = 0; i < started; i++) {
+        ojtn_thread_join(c[i].thread);
+    }
+    double elapsed = now_seconds() - start;
+
+    /* Gather every completed latency into one sorted array */
+    size_t total = 0;
+    int errors = 0;
+    for (int i = 0; i < started; i++) {
+        memmove(latencies + total, c[i].latencies, (size_t)c[i].completed * sizeof(double));
+        total += (size_t)c[i].completed;
+        errors += c[i].errors;
+    }
+    if (total == 0) {
+        fprintf(stderr, "no requests completed (is the server running on %s?)\n", socket_path);
+        return 1;
+    }
+    qsort(latencies, total, sizeof(double), compare_double);
+
+    printf("clients=%d requests=%llu errors=%d seconds=%.3f requests/sec=%.0f\n",
+        started, (unsigned long long)total, errors, elapsed, (double)total / elapsed);
+    printf("latency_ms p50=%.3f p90=%.3f p99=%.3f max=%.3f\n",
+        latencies[total / 2] * 1e3, latencies[total * 9 / 10] * 1e3,
+        latencies[total * 99 / 100] * 1e3, latencies[total - 1] * 1e3);
+
+    for (int i = 0; i < text_count; i++) free(texts[i]);
+    free(texts);
+    free(latencies);
+    free(c);
+    return errors ? 1 : 0;
+}